@@ -1,8 +1,36 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 
+#include "GLTFJSONWriter.h"
+
 namespace Base64 {
-	char* encode(unsigned char* data, size_t length);
+	/**
+	 * @return The number of characters in the encoding of `length` bytes, including padding.
+	 */
+	size_t encodedLength(size_t length);
+
+	/**
+	 * Encodes bytes with AVX2 or SSSE3 when the processor supports them, and a scalar loop otherwise.
+	 *
+	 * @param data The bytes to encode.
+	 * @param length The number of bytes to encode.
+	 * @param base64 Receives encodedLength(length) characters, no terminator is written.
+	 */
+	void encode(const unsigned char* data, size_t length, char* base64);
+	std::string encode(const unsigned char* data, size_t length);
+
+	/**
+	 * Writes a base64 data uri as a JSON string value. The data is encoded and written in fixed-size
+	 * blocks, so the uri is never held in memory.
+	 *
+	 * @param jsonWriter The writer, positioned where the value goes.
+	 * @param mimeType The media type of the data.
+	 * @param data The bytes to encode.
+	 * @param length The number of bytes to encode.
+	 */
+	void writeDataUri(GLTF::JSONWriter* jsonWriter, const std::string& mimeType, const unsigned char* data, size_t length);
+
 	std::string decode(std::string uri);
-}
\ No newline at end of file
+}
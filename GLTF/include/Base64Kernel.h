@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstddef>
+
+// Vector encoders, each in a translation unit compiled for its instruction set. They encode whole
+// groups of 3 bytes and return how many bytes were consumed, the caller encodes the rest.
+namespace Base64 {
+	namespace Kernel {
+		size_t encodeSSSE3(const unsigned char* data, size_t length, char* base64);
+		size_t encodeAVX2(const unsigned char* data, size_t length, char* base64);
+	}
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+namespace CPUFeatures {
+	/**
+	 * @return true if the processor supports SSSE3, always false on other architectures than x86.
+	 */
+	bool hasSSSE3();
+
+	/**
+	 * @return true if the processor and the operating system support AVX2, always false on other
+	 * architectures than x86.
+	 */
+	bool hasAVX2();
+}
@@ -21,12 +21,16 @@ namespace GLTF {
 		};
 
 		GLTF::BufferView* bufferView = NULL;
-		int byteOffset = 0;
+		size_t byteOffset = 0;
 		GLTF::Constants::WebGL componentType;
 		int count = 0;
-		float* max = NULL;
-		float* min = NULL;
+		// Bounds are kept in double, which holds every UNSIGNED_INT value exactly
+		double* max = NULL;
+		double* min = NULL;
+		bool normalized = false;
 		Type type = Type::UNKNOWN;
+		// Set when min and max are left to writeJSON, see GLTF::Options::deferMinMax
+		bool minMaxDeferred = false;
 
 		Accessor(GLTF::Accessor::Type type, GLTF::Constants::WebGL componentType);
 
@@ -34,14 +38,16 @@ namespace GLTF {
 			GLTF::Constants::WebGL componentType,
 			unsigned char* data,
 			int count,
-			GLTF::Constants::WebGL target
+			GLTF::Constants::WebGL target,
+			bool deferMinMax = false
 		);
 
 		Accessor(GLTF::Accessor::Type type,
 			GLTF::Constants::WebGL componentType,
 			unsigned char* data,
 			int count,
-			GLTF::BufferView* bufferView
+			GLTF::BufferView* bufferView,
+			bool deferMinMax = false
 		);
 
 		Accessor(GLTF::Accessor::Type type,
@@ -51,10 +57,22 @@ namespace GLTF {
 			GLTF::BufferView* bufferView
 		);
 
+		virtual ~Accessor();
+
 		static int getComponentByteLength(GLTF::Constants::WebGL componentType);
 		static int getNumberOfComponents(GLTF::Accessor::Type type);
 
 		bool computeMinMax();
+		/**
+		 * Computes min and max from elements of this accessor's type stored at `data`, for accessors
+		 * whose data is not in a bufferView, e.g. because it is only kept in a Draco mesh.
+		 *
+		 * @param data The first element.
+		 * @param byteStride The distance in bytes between consecutive elements.
+		 * @return false if the component type or the type of the accessor is not supported.
+		 */
+		bool computeMinMax(unsigned char* data, int byteStride);
+		void updateMinMax(bool deferMinMax);
 		int getByteStride();
 		bool getComponentAtIndex(int index, float *component);
 		bool writeComponentAtIndex(int index, float* component);
@@ -64,6 +82,6 @@ namespace GLTF {
 		const char* getTypeName();
 
 		virtual std::string typeName();
-		virtual void writeJSON(void* writer, GLTF::Options* options);
+		virtual void writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options);
 	};
 };
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+
+#include "GLTFAccessor.h"
+
+namespace GLTF {
+	/**
+	 * A typed view of the elements of an accessor, with the component type and number of components
+	 * fixed at compile time. Elements are addressed with strided pointers into the buffer, so loops
+	 * over a view need no per-component conversion and can be vectorized by the compiler.
+	 */
+	template <typename T, int N>
+	class AccessorView {
+	public:
+		static const int numberOfComponents = N;
+		unsigned char* data;
+		size_t byteStride;
+		int count;
+
+		AccessorView(GLTF::Accessor* accessor) :
+			data(accessor->bufferView->buffer->data + accessor->bufferView->byteOffset + accessor->byteOffset),
+			byteStride(accessor->getByteStride()),
+			count(accessor->count) {}
+
+		AccessorView(unsigned char* data, size_t byteStride, int count) :
+			data(data),
+			byteStride(byteStride),
+			count(count) {}
+
+		T* operator[](int index) const {
+			return (T*)(data + index * byteStride);
+		}
+	};
+
+	template <typename T, typename Visitor>
+	bool visitAccessorComponents(GLTF::Accessor* accessor, unsigned char* data, size_t byteStride, Visitor& visitor) {
+		switch (accessor->getNumberOfComponents()) {
+		case 1:
+			visitor(GLTF::AccessorView<T, 1>(data, byteStride, accessor->count));
+			return true;
+		case 2:
+			visitor(GLTF::AccessorView<T, 2>(data, byteStride, accessor->count));
+			return true;
+		case 3:
+			visitor(GLTF::AccessorView<T, 3>(data, byteStride, accessor->count));
+			return true;
+		case 4:
+			visitor(GLTF::AccessorView<T, 4>(data, byteStride, accessor->count));
+			return true;
+		case 9:
+			visitor(GLTF::AccessorView<T, 9>(data, byteStride, accessor->count));
+			return true;
+		case 16:
+			visitor(GLTF::AccessorView<T, 16>(data, byteStride, accessor->count));
+			return true;
+		}
+		return false;
+	}
+
+	/**
+	 * Like visitAccessor, but views elements of the accessor's type stored at `data` instead of in its bufferView.
+	 */
+	template <typename Visitor>
+	bool visitAccessor(GLTF::Accessor* accessor, unsigned char* data, size_t byteStride, Visitor& visitor) {
+		switch (accessor->componentType) {
+		case GLTF::Constants::WebGL::BYTE:
+			return visitAccessorComponents<signed char>(accessor, data, byteStride, visitor);
+		case GLTF::Constants::WebGL::UNSIGNED_BYTE:
+			return visitAccessorComponents<unsigned char>(accessor, data, byteStride, visitor);
+		case GLTF::Constants::WebGL::SHORT:
+			return visitAccessorComponents<short>(accessor, data, byteStride, visitor);
+		case GLTF::Constants::WebGL::UNSIGNED_SHORT:
+			return visitAccessorComponents<unsigned short>(accessor, data, byteStride, visitor);
+		case GLTF::Constants::WebGL::FLOAT:
+			return visitAccessorComponents<float>(accessor, data, byteStride, visitor);
+		case GLTF::Constants::WebGL::UNSIGNED_INT:
+			return visitAccessorComponents<unsigned int>(accessor, data, byteStride, visitor);
+		default:
+			return false;
+		}
+	}
+
+	/**
+	 * Dispatches on the component type and number of components of an accessor once, and calls
+	 * `visitor` with the matching AccessorView.
+	 *
+	 * @param accessor The accessor to view, it must have a bufferView.
+	 * @param visitor A functor with a `template <typename T, int N> void operator()(const GLTF::AccessorView<T, N>& view)`.
+	 * @return false if the component type or the type of the accessor is not supported.
+	 */
+	template <typename Visitor>
+	bool visitAccessor(GLTF::Accessor* accessor, Visitor& visitor) {
+		unsigned char* data = accessor->bufferView->buffer->data + accessor->bufferView->byteOffset + accessor->byteOffset;
+		return visitAccessor(accessor, data, accessor->getByteStride(), visitor);
+	}
+}
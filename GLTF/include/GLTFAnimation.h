@@ -28,7 +28,7 @@ namespace GLTF {
 		Path path;
 
 		virtual std::string typeName();
-		virtual void writeJSON(void* writer, GLTF::Options* options);
+		virtual void writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options);
 	};
 
     class Channel : public GLTF::Object {
@@ -38,18 +38,18 @@ namespace GLTF {
 			GLTF::Node* node;
 			Path path;
 
-			virtual void writeJSON(void* writer, GLTF::Options* options);
+			virtual void writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options);
 		};
 
 		GLTF::Animation::Sampler* sampler;
 		Target* target;
 
-		virtual void writeJSON(void* writer, GLTF::Options* options);
+		virtual void writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options);
     };
 
     std::vector<Channel*> channels;
 
 	virtual std::string typeName();
-	virtual void writeJSON(void* writer, GLTF::Options* options);
+	virtual void writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options);
   };
 }
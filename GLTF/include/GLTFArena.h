@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <type_traits>
+
+namespace GLTF {
+	/**
+	 * A region the objects of a glTF graph are allocated from and released with in bulk. Objects are
+	 * placed one after another in large blocks, so a conversion makes a few heap allocations instead
+	 * of one per object. Deleting an object runs its destructor, its memory is only returned when the
+	 * arena is released.
+	 *
+	 * Objects are allocated from the arena that is current on the calling thread, or from the heap
+	 * when there is none. Several threads may allocate from the same arena, tasks of a thread pool
+	 * run with the arena that was current when they were submitted.
+	 */
+	class Arena {
+	public:
+		class Statistics {
+		public:
+			// Objects allocated from the arena
+			size_t allocations = 0;
+			// Objects deleted before the arena was released
+			size_t deletions = 0;
+			// Bytes requested by the allocated objects
+			size_t byteLength = 0;
+			// Heap blocks the objects were placed in, and their total size
+			size_t blocks = 0;
+			size_t blockByteLength = 0;
+		};
+
+		/**
+		 * Makes an arena current on the calling thread while it is in scope, restoring the arena that
+		 * was current before. Unlike makeCurrent, the same arena can be in scope on several threads.
+		 */
+		class Scope {
+		public:
+			Scope(Arena* arena);
+			Scope(const Scope&) = delete;
+			Scope& operator=(const Scope&) = delete;
+			~Scope();
+
+		private:
+			Arena* _previous;
+		};
+
+		Arena();
+		Arena(const Arena&) = delete;
+		Arena& operator=(const Arena&) = delete;
+		~Arena();
+
+		/**
+		 * @return The arena objects are allocated from on the calling thread, NULL for the heap.
+		 */
+		static Arena* current();
+
+		/**
+		 * Allocates objects from this arena on the calling thread until it is released. The arena that
+		 * was current before becomes current again then.
+		 */
+		void makeCurrent();
+
+		/**
+		 * Allocates memory for an object from the current arena, or from the heap if there is none.
+		 */
+		static void* allocate(size_t size);
+
+		/**
+		 * Allocates memory for values from the current arena, released with it. Without a current
+		 * arena the memory comes from the heap and is never freed.
+		 */
+		static void* allocateBytes(size_t length);
+
+		/**
+		 * Allocates an array of plain values several objects may point at, such as the colors of a
+		 * material, which no single object owns.
+		 */
+		template <typename T>
+		static T* allocateArray(size_t count) {
+			static_assert(std::is_trivial<T>::value, "Arena arrays are never destroyed");
+			return (T*)allocateBytes(count * sizeof(T));
+		}
+
+		/**
+		 * Returns the memory of an object allocated with allocate. Memory from an arena is kept until
+		 * the arena is released.
+		 */
+		static void deallocate(void* pointer);
+
+		/**
+		 * Destroys the objects that are still alive and frees every block. Objects are destroyed in
+		 * no particular order, so their destructors must not delete other arena objects, which may
+		 * already have been destroyed. No other thread may allocate from the arena meanwhile.
+		 */
+		void release();
+
+		const Statistics& getStatistics() const;
+
+		/**
+		 * @return The objects allocated from the heap because no arena was current, since the process
+		 * started. Blocks are not counted.
+		 */
+		static Statistics getHeapStatistics();
+
+	private:
+		class Header;
+
+		// Length of the header placed before every object, keeping the object aligned
+		static const size_t HEADER_LENGTH;
+
+		Arena* _previous = NULL;
+		bool _isCurrent = false;
+		Header* _live = NULL;
+		unsigned char* _blocks = NULL;
+		unsigned char* _next = NULL;
+		unsigned char* _end = NULL;
+		Statistics _statistics;
+		std::mutex _mutex;
+
+		void* allocateFromBlock(size_t length);
+		void unlink(Header* header);
+	};
+
+	/**
+	 * Base class of the types allocated from the current arena. It must come first in the bases of a
+	 * type, so the arena can destroy the objects that are still alive when it is released.
+	 */
+	class Allocated {
+	public:
+		virtual ~Allocated() {}
+
+		static void* operator new(size_t size);
+		static void operator delete(void* pointer);
+	};
+}
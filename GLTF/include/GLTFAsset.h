@@ -1,10 +1,13 @@
 #pragma once
 
+#include <map>
 #include <set>
 #include <string>
 #include <vector>
 
 #include "GLTFAnimation.h"
+#include "GLTFArena.h"
+#include "GLTFBufferLayout.h"
 #include "GLTFDracoExtension.h"
 #include "GLTFObject.h"
 #include "GLTFScene.h"
@@ -14,16 +17,51 @@
 namespace GLTF {
 	class Asset : public GLTF::Object {
 	private:
+		/**
+		 * The objects reachable from the default scene, gathered in one traversal and kept until the
+		 * asset is invalidated. Each list is in the order its getAll* function returns it.
+		 */
+		class Registry {
+		public:
+			// The asset epoch the lists were gathered at, 0 before the first traversal
+			unsigned int epoch = 0;
+			std::vector<GLTF::Node*> nodes;
+			std::vector<GLTF::Mesh*> meshes;
+			std::vector<GLTF::Primitive*> primitives;
+			std::vector<GLTF::Skin*> skins;
+			std::vector<GLTF::Material*> materials;
+			std::vector<GLTF::Technique*> techniques;
+			std::vector<GLTF::Program*> programs;
+			std::vector<GLTF::Shader*> shaders;
+			std::vector<GLTF::Texture*> textures;
+			std::vector<GLTF::Image*> images;
+			std::vector<GLTF::Accessor*> accessors;
+		};
+
 		std::vector<GLTF::MaterialCommon::Light*> _ambientLights;
+		std::map<std::string, GLTF::Image*> _imageCache;
+		std::map<GLTF::Image*, GLTF::Texture*> _pbrTextureCache;
+		Registry _registry;
+		unsigned int _epoch = 1;
+
+		const Registry& getRegistry();
 	public:
 		class Metadata : public GLTF::Object {
 		public:
 			std::string copyright;
 			std::string generator = "COLLADA2GLTF";
 			std::string version = "2.0";
-			virtual void writeJSON(void* writer, GLTF::Options* options);
+			virtual void writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options);
 		};
 
+		/**
+		 * The arena every object of the asset is allocated from. The asset passes and the converter
+		 * make it current with an Arena::Scope while they build the graph, code adding objects to the
+		 * asset directly opens a scope for it as well. Objects are destroyed with the asset, along with
+		 * the data they own: buffer data, image data and accessor bounds. Objects only point at each
+		 * other, so no object deletes another.
+		 */
+		GLTF::Arena arena;
 		GLTF::Sampler* globalSampler = NULL;
 
 		Metadata* metadata = NULL;
@@ -35,7 +73,20 @@ namespace GLTF {
 		int scene = -1;
 
 		Asset();
+
+		/**
+		 * Assets are allocated from the heap rather than the current arena, which may belong to
+		 * another asset that is deleted first.
+		 */
+		static void* operator new(size_t size);
+		static void operator delete(void* pointer);
+
 		GLTF::Scene* getDefaultScene();
+
+		/**
+		 * Reads an image file once, later calls with the same path return the same image.
+		 */
+		GLTF::Image* loadImage(path imagePath);
 		std::vector<GLTF::Accessor*> getAllAccessors();
 		std::vector<GLTF::Node*> getAllNodes();
 		std::vector<GLTF::Mesh*> getAllMeshes();
@@ -48,10 +99,23 @@ namespace GLTF {
 		std::vector<GLTF::Texture*> getAllTextures();
 		std::vector<GLTF::Image*> getAllImages();
 		std::vector<GLTF::Accessor*> getAllPrimitiveAccessors(GLTF::Primitive* primitive) const;
+
+		/**
+		 * Marks the lists returned by the getAll* functions as stale, they are gathered again on the next
+		 * call. Asset passes that change the scene graph call this themselves, call it after adding or
+		 * removing nodes, meshes, primitives, materials, textures, accessors or animations directly once
+		 * any getAll* function has been called.
+		 */
+		void invalidate();
 		void mergeAnimations();
 		void removeUnusedSemantics();
 		void removeUnusedNodes(GLTF::Options* options);
-		GLTF::Buffer* packAccessors();
+		void optimizeVertexCache();
+		void optimizeOverdraw(float threshold);
+		void optimizeVertexFetch();
+		void quantizeMeshes(GLTF::Options* options);
+		GLTF::BufferLayout* planBufferLayout(GLTF::Options* options);
+		GLTF::Buffer* packAccessors(GLTF::Options* options);
 
 		// Functions for Draco compression extension.
 		std::vector<GLTF::BufferView*> getAllCompressedBufferView();
@@ -61,6 +125,6 @@ namespace GLTF {
 
 		void requireExtension(std::string extension);
 		void useExtension(std::string extension);
-		virtual void writeJSON(void* writer, GLTF::Options* options);
+		virtual void writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options);
 	};
 }
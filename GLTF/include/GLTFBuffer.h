@@ -6,12 +6,16 @@ namespace GLTF {
 	class Buffer : public GLTF::Object {
 	public:
 		unsigned char* data = NULL;
-		int byteLength;
+		size_t byteLength;
 		std::string uri;
 
-		Buffer(unsigned char* data, int dataLength);
+		/**
+		 * @param data The malloc'd contents of the buffer, owned and freed by the buffer.
+		 */
+		Buffer(unsigned char* data, size_t dataLength);
+		virtual ~Buffer();
 		
 		virtual std::string typeName();
-		virtual void writeJSON(void* writer, GLTF::Options* options);
+		virtual void writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options);
 	};
 };
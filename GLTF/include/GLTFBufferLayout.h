@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdio>
+#include <set>
+#include <vector>
+
+#include "GLTFAccessor.h"
+#include "GLTFBuffer.h"
+#include "GLTFBufferView.h"
+
+namespace GLTF {
+	/**
+	 * The planned placement of every bufferView in a single output buffer. Offsets, alignment and
+	 * padding are decided before any data is copied, so each payload is written exactly once, either
+	 * into the buffer data or directly into an output file.
+	 */
+	class BufferLayout {
+	public:
+		/**
+		 * A payload written into an entry, either the elements of an accessor or raw bytes.
+		 */
+		class Source {
+		public:
+			// Accessor whose elements are copied, NULL for raw bytes
+			GLTF::Accessor* accessor = NULL;
+			unsigned char* data = NULL;
+			// Byte stride of the accessor elements at data, or the length of the raw bytes
+			size_t byteStride = 0;
+			size_t byteLength = 0;
+			// Offset of the payload from the start of the bufferView
+			size_t byteOffset = 0;
+		};
+
+		class Entry {
+		public:
+			GLTF::BufferView* bufferView = NULL;
+			// Byte stride accessor elements are written with
+			size_t byteStride = 0;
+			std::vector<Source> sources;
+		};
+
+		GLTF::Buffer* buffer = NULL;
+		std::vector<Entry> entries;
+		// Buffers holding source data that is no longer needed once the layout is written
+		std::set<GLTF::Buffer*> sourceBuffers;
+
+		/**
+		 * Writes the payloads of an entry.
+		 *
+		 * @param entry The entry to write.
+		 * @param destination The start of the entry's bufferView, with room for its byteLength.
+		 */
+		static void writeEntry(const Entry& entry, unsigned char* destination);
+
+		/**
+		 * Writes the part of an entry's payloads in the range [begin, end) of its bufferView, bytes
+		 * of the range no payload covers are left untouched.
+		 *
+		 * @param entry The entry to write.
+		 * @param window Where the range is written, with room for `end - begin` bytes.
+		 */
+		static void writeEntry(const Entry& entry, unsigned char* window, size_t begin, size_t end);
+
+		/**
+		 * Writes every entry at its offset, padding is left untouched.
+		 *
+		 * @param destination The start of the buffer, with room for its byteLength.
+		 */
+		void write(unsigned char* destination);
+
+		/**
+		 * Streams every entry to a file in buffer order, writing the zero padding between them.
+		 * Payloads already laid out with the entry's byte stride are written straight from their
+		 * source, other entries are filled and written a fixed-size block at a time, so neither the
+		 * buffer nor a whole bufferView is ever held in memory.
+		 *
+		 * @param file The file to write to, positioned where the buffer starts.
+		 * @return false if a write failed.
+		 */
+		bool write(FILE* file);
+
+		/**
+		 * Frees the data of the source buffers, call once the layout has been written.
+		 */
+		void releaseSources();
+	};
+}
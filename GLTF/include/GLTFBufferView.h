@@ -8,19 +8,19 @@ namespace GLTF {
 	class BufferView : public GLTF::Object {
 	public:
 		GLTF::Buffer* buffer = NULL;
-		int byteOffset = 0;
+		size_t byteOffset = 0;
 		int byteStride = 0;
-		int byteLength = 0;
+		size_t byteLength = 0;
 		GLTF::Constants::WebGL target = (GLTF::Constants::WebGL)-1;
 
-		BufferView(int byteOffset, int byteLength, GLTF::Buffer* buffer);
-		BufferView(unsigned char* data, int dataLength);
+		BufferView(size_t byteOffset, size_t byteLength, GLTF::Buffer* buffer);
+		BufferView(unsigned char* data, size_t dataLength);
 		BufferView(unsigned char* data,
-			int dataLength,
+			size_t dataLength,
 			GLTF::Constants::WebGL target
 		);
 
 		virtual std::string typeName();
-		virtual void writeJSON(void* writer, GLTF::Options* options);
+		virtual void writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options);
 	};
 };
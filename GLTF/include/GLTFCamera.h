@@ -15,7 +15,7 @@ namespace GLTF {
 	  float znear;
 
 	  virtual std::string typeName();
-	  virtual void writeJSON(void* writer, GLTF::Options* options);
+	  virtual void writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options);
   };
 
   class CameraOrthographic : public GLTF::Camera {
@@ -26,7 +26,7 @@ namespace GLTF {
 	  CameraOrthographic() {
 		  type = Type::ORTHOGRAPHIC;
 	  }
-	  virtual void writeJSON(void* writer, GLTF::Options* options);
+	  virtual void writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options);
   };
 
   class CameraPerspective : public GLTF::Camera {
@@ -37,6 +37,6 @@ namespace GLTF {
 	  CameraPerspective() {
 		  type = Type::PERSPECTIVE;
 	  }
-	  virtual void writeJSON(void* writer, GLTF::Options* options);
+	  virtual void writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options);
   };
 }
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+
+#include "draco/compression/encode.h"
+#include "GLTFDracoExtension.h"
+
+namespace GLTF {
+	/**
+	 * Encoded Draco meshes addressed by a hash of the mesh content and the encoder settings. Meshes
+	 * with the same key encode to the same bytes, so they are encoded once and share a bufferView.
+	 * With a directory set, encodings are also stored on disk as `<key>.drc` files and reused by
+	 * later conversions.
+	 */
+	class DracoCache {
+	public:
+		/**
+		 * @param directory Where encodings are stored, empty to only share encodings in memory.
+		 */
+		DracoCache(std::string directory);
+
+		/**
+		 * @return A hex digest of the faces and attribute values of the mesh and the settings it is encoded with, including whether it is encoded as a point cloud.
+		 */
+		static std::string key(const draco::Mesh* mesh, const GLTF::DracoExtension::Settings& settings);
+
+		/**
+		 * Loads an encoding stored by an earlier conversion.
+		 *
+		 * @param data Receives the malloc'd encoding.
+		 * @param length Receives the length of the encoding.
+		 * @return false if no directory is set, the key has not been stored or the stored file does not
+		 * match the length and hash written with it.
+		 */
+		bool load(const std::string& key, unsigned char** data, size_t* length);
+
+		/**
+		 * Stores an encoding for later conversions, does nothing without a directory.
+		 */
+		void store(const std::string& key, const unsigned char* data, size_t length);
+
+	private:
+		std::string _directory;
+	};
+}
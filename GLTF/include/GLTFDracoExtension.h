@@ -13,11 +13,39 @@
 namespace GLTF {
 	class DracoExtension : public GLTF::Object {
 	public:
+		/**
+		 * The quantization bits and speeds a mesh is encoded with.
+		 */
+		class Settings {
+		public:
+			enum class Geometry {
+				// Faces and points, encoded with connectivity
+				MESH,
+				// Points without faces, which the encoder may reorder
+				POINT_CLOUD,
+				// Points without faces, encoded in order, e.g. the endpoints of line segments
+				ORDERED_POINT_CLOUD
+			};
+
+			Geometry geometry = Geometry::MESH;
+			int positionQuantizationBits = 14;
+			int normalQuantizationBits = 10;
+			int texcoordQuantizationBits = 10;
+			int colorQuantizationBits = 8;
+			// Used for joint weights and other generic attributes
+			int genericQuantizationBits = 8;
+			// From 0, the smallest output, to 10, the fastest, -1 keeps the Draco default
+			int encodeSpeed = -1;
+			int decodeSpeed = -1;
+		};
+
 		DracoExtension() : dracoMesh(new draco::Mesh()) {} 
 		GLTF::BufferView* bufferView = NULL;
+		// Chosen for this mesh by Asset::compressPrimitives
+		Settings settings;
 		std::unordered_map<std::string, int> attributeToId;
 		
 		std::unique_ptr<draco::Mesh> dracoMesh;
-		virtual void writeJSON(void* writer, GLTF::Options* options);
+		virtual void writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options);
 	};
 }
@@ -13,18 +13,19 @@ namespace GLTF {
 		GLTF::BufferView* bufferView = NULL;
 
 		Image(std::string uri);
+		/**
+		 * @param data The malloc'd image file contents, owned and freed by the image.
+		 */
 		Image(std::string uri, unsigned char* data, size_t byteLength, std::string fileExtension);
 		virtual ~Image();
 
+		/**
+		 * Reads an image file. Every call reads the file again, GLTF::Asset::loadImage shares the
+		 * images of an asset.
+		 */
 		static GLTF::Image* load(path path);
 		std::pair<int, int> getDimensions();
 		virtual std::string typeName();
-		virtual void writeJSON(void* writer, GLTF::Options* options);
-
-	private:
-		const std::string cacheKey;
-
-		Image(std::string uri, std::string cacheKey);
-		Image(std::string uri, std::string cacheKey, unsigned char* data, size_t byteLength, std::string fileExtension);
+		virtual void writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace GLTF {
+	/**
+	 * The output every writeJSON serializes into. Methods mirror the rapidjson SAX writer so objects
+	 * can be written to any stream, pretty printed or not. Keys and strings are passed as pointers
+	 * with a length, so nothing is allocated on this side of the interface.
+	 */
+	class JSONWriter {
+	public:
+		virtual ~JSONWriter() {}
+		virtual void StartObject() = 0;
+		virtual void EndObject() = 0;
+		virtual void StartArray() = 0;
+		virtual void EndArray() = 0;
+		virtual void Key(const char* key, size_t length) = 0;
+		virtual void String(const char* value, size_t length) = 0;
+		virtual void Int(int value) = 0;
+		virtual void Uint64(uint64_t value) = 0;
+		virtual void Double(double value) = 0;
+		virtual void Bool(bool value) = 0;
+		virtual void Null() = 0;
+
+		/**
+		 * Writes a string value in parts, e.g. while it is being encoded. Parts are written as they
+		 * are, so they must not contain characters that need escaping.
+		 */
+		virtual void StartString() = 0;
+		virtual void StringPart(const char* value, size_t length) = 0;
+		virtual void EndString() = 0;
+
+		void Key(const char* key) {
+			Key(key, std::strlen(key));
+		}
+
+		void String(const char* value) {
+			String(value, std::strlen(value));
+		}
+	};
+}
@@ -17,7 +17,7 @@ namespace GLTF {
 			UNKNOWN
 		};
 
-		class Values {
+		class Values : public GLTF::Allocated {
 		public:
 			float* ambient = NULL;
 			GLTF::Texture* ambientTexture = NULL;
@@ -31,7 +31,7 @@ namespace GLTF {
 			float* transparency = NULL;
 			GLTF::Texture* bumpTexture = NULL;
 
-			void writeJSON(void* writer, GLTF::Options* options);
+			void writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options);
 		};
 
 		GLTF::Technique* technique = NULL;
@@ -42,7 +42,7 @@ namespace GLTF {
 		Material();
 		bool hasTexture();
 		virtual std::string typeName();
-		virtual void writeJSON(void* writer, GLTF::Options* options);
+		virtual void writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options);
 	};
 
 	class MaterialPBR : public GLTF::Material {
@@ -53,7 +53,7 @@ namespace GLTF {
 			GLTF::Texture* texture = NULL;
 			int texCoord = -1;
 
-			void writeJSON(void* writer, GLTF::Options* options);
+			void writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options);
 		};
 
 		class MetallicRoughness : public GLTF::Object {
@@ -64,7 +64,7 @@ namespace GLTF {
 			float roughnessFactor = -1.0;
 			Texture* metallicRoughnessTexture = NULL;
 
-			void writeJSON(void* writer, GLTF::Options* options);
+			void writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options);
 		};
 
 		class SpecularGlossiness : public GLTF::Object {
@@ -75,7 +75,7 @@ namespace GLTF {
 			Texture* specularGlossinessTexture = NULL;
 			float* glossinessFactor = NULL;
 
-			void writeJSON(void* writer, GLTF::Options* options);
+			void writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options);
 		};
 
 		MetallicRoughness* metallicRoughness = NULL;
@@ -94,7 +94,7 @@ namespace GLTF {
 		bool doubleSided = false;
 
 		MaterialPBR();
-		void writeJSON(void* writer, GLTF::Options* options);
+		void writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options);
 	};
 
 	class MaterialCommon : public GLTF::Material {
@@ -125,7 +125,7 @@ namespace GLTF {
 			void* node = NULL;
 
 			virtual std::string typeName();
-			virtual void writeJSON(void* writer, GLTF::Options* options);
+			virtual void writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options);
 		};
 
 		int jointCount = 0;
@@ -139,6 +139,6 @@ namespace GLTF {
 		GLTF::Material* getMaterial(std::vector<GLTF::MaterialCommon::Light*> lights, bool hasColorAttribute, GLTF::Options* options);
 		std::string getTechniqueKey(GLTF::Options* options);
 		GLTF::MaterialPBR* getMaterialPBR(GLTF::Options* options);
-		virtual void writeJSON(void* writer, GLTF::Options* options);
+		virtual void writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options);
 	};
 }
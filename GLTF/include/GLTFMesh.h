@@ -13,6 +13,6 @@ namespace GLTF {
 
 		virtual std::string typeName();
 		virtual GLTF::Object* clone(GLTF::Object* clone);
-		virtual void writeJSON(void* writer, GLTF::Options* options);
+		virtual void writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options);
 	};
 }
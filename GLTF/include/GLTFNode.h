@@ -12,7 +12,7 @@
 namespace GLTF {
 	class Node : public GLTF::Object {
 	public:
-		class Transform {
+		class Transform : public GLTF::Allocated {
 		public:
 			enum Type {
 				TRS,
@@ -65,6 +65,6 @@ namespace GLTF {
 
 		virtual std::string typeName();
 		virtual GLTF::Object* clone(GLTF::Object* clone);
-		virtual void writeJSON(void* writer, GLTF::Options* options);
+		virtual void writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options);
 	};
 }
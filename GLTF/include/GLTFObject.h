@@ -1,5 +1,7 @@
 #pragma once
 
+#include "GLTFArena.h"
+#include "GLTFJSONWriter.h"
 #include "GLTFOptions.h"
 
 #include <map>
@@ -8,7 +10,7 @@
 
 namespace GLTF {
 	class Extension;
-	class Object {
+	class Object : public GLTF::Allocated {
 	public:
 		int id = -1;
 		std::string stringId;
@@ -19,6 +21,6 @@ namespace GLTF {
 		std::string getStringId();
 		virtual std::string typeName();
 		virtual GLTF::Object* clone(GLTF::Object* clone);
-		virtual void writeJSON(void* writer, GLTF::Options* options);
+		virtual void writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options);
 	};
 }
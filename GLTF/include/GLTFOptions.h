@@ -14,6 +14,8 @@ namespace GLTF {
 		bool embeddedTextures = true;
 		bool embeddedShaders = true;
 		bool binary = false;
+		// Write the JSON without indentation, skipping the pretty printing pass.
+		bool compactJson = false;
 		bool lockOcclusionMetallicRoughness = false;
 		bool materialsCommon = false;
 		bool doubleSided = false;
@@ -21,6 +23,18 @@ namespace GLTF {
 		bool specularGlossiness = false;
 		std::string version = "2.0";
 		std::vector<std::string> metallicRoughnessTexturePaths;
+		// Number of threads used to convert and Draco compress mesh primitives, 1 does the work on the calling thread.
+		int threads = 1;
+		bool optimizeVertexCache = false;
+		bool optimizeVertexFetch = false;
+		bool optimizeOverdraw = false;
+		float overdrawThreshold = 1.05f;
+		// Interleave the vertex attributes of each primitive into a shared bufferView.
+		bool interleave = false;
+		// Store mesh attributes as integers with KHR_mesh_quantization, using the quantization bits below.
+		bool meshQuantization = false;
+		// Compute accessor min and max when writing the JSON instead of on every accessor creation.
+		bool deferMinMax = false;
 		// For Draco compression extension.
 		bool dracoCompression = false;
 		int positionQuantizationBits = 14;
@@ -28,5 +42,14 @@ namespace GLTF {
 		int texcoordQuantizationBits = 10;
 		int colorQuantizationBits = 8;
 		int jointQuantizationBits = 8;
+		// Largest position error allowed when choosing quantization bits per primitive, 0 uses the bits above.
+		float dracoMaxError = 0;
+		// Largest error allowed as a fraction of each attribute's range, 0 uses the bits above.
+		float dracoMaxRelativeError = 0;
+		// Draco speed settings from 0, the smallest output, to 10, the fastest, -1 keeps the Draco default.
+		int dracoEncodeSpeed = -1;
+		int dracoDecodeSpeed = -1;
+		// Directory where Draco encodings are stored and reused across conversions, empty to disable.
+		std::string dracoCacheDir;
 	};
 }
@@ -22,12 +22,12 @@ namespace GLTF {
 			TRIANGLE_FAN = 6,
 		};
 
-		class Target {
+		class Target : public GLTF::Allocated {
 		public:
 			std::map<std::string, GLTF::Accessor*> attributes;
 
 			Target* clone(GLTF::Object* clone);
-			void writeJSON(void* writer, GLTF::Options* options);
+			void writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options);
 		};
 
 		std::map<std::string, GLTF::Accessor*> attributes;
@@ -37,6 +37,6 @@ namespace GLTF {
 		std::vector<Target*> targets;
 
 		virtual GLTF::Object* clone(GLTF::Object* clone);
-		virtual void writeJSON(void* writer, GLTF::Options* options);
+		virtual void writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options);
 	};
 }
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "GLTFJSONWriter.h"
+
+#include "rapidjson/rapidjson.h"
+
+namespace GLTF {
+	/**
+	 * Adapts a rapidjson Writer or PrettyWriter to a JSONWriter. String parts go straight to the
+	 * output stream of the writer, after it has written the opening quote.
+	 */
+	template <typename Writer, typename Stream>
+	class RapidJSONWriter : public JSONWriter {
+	public:
+		using JSONWriter::Key;
+		using JSONWriter::String;
+
+		Writer& writer;
+		Stream& stream;
+
+		RapidJSONWriter(Writer& writer, Stream& stream) : writer(writer), stream(stream) {}
+
+		void StartObject() { writer.StartObject(); }
+		void EndObject() { writer.EndObject(); }
+		void StartArray() { writer.StartArray(); }
+		void EndArray() { writer.EndArray(); }
+		void Key(const char* key, size_t length) { writer.Key(key, (unsigned)length); }
+		void String(const char* value, size_t length) { writer.String(value, (unsigned)length); }
+		void Int(int value) { writer.Int(value); }
+		void Uint64(uint64_t value) { writer.Uint64(value); }
+		void Double(double value) { writer.Double(value); }
+		void Bool(bool value) { writer.Bool(value); }
+		void Null() { writer.Null(); }
+		void StartString() { writer.RawValue("\"", 1, rapidjson::kStringType); }
+		void EndString() { stream.Put('"'); }
+
+		void StringPart(const char* value, size_t length) {
+			for (size_t i = 0; i < length; i++) {
+				stream.Put(value[i]);
+			}
+		}
+	};
+}
@@ -12,6 +12,6 @@ namespace GLTF {
 	  GLTF::Constants::WebGL wrapT = GLTF::Constants::WebGL::REPEAT;
 
 	  virtual std::string typeName();
-	  virtual void writeJSON(void* writer, GLTF::Options* options);
+	  virtual void writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options);
   };
 }
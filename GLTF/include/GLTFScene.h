@@ -11,6 +11,6 @@ namespace GLTF {
 		std::vector<GLTF::Node*> nodes;
 
 		virtual std::string typeName();
-		virtual void writeJSON(void* writer, GLTF::Options* options);
+		virtual void writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options);
 	};
 }
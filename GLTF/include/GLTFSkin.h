@@ -15,6 +15,6 @@ namespace GLTF {
 		std::vector<Node*> joints;
 
 		virtual std::string typeName();
-		virtual void writeJSON(void* writer, GLTF::Options* options);
+		virtual void writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options);
 	};
 }
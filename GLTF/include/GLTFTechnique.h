@@ -8,7 +8,7 @@
 namespace GLTF {
 	class Technique : public GLTF::Object {
 	public:
-		class Parameter {
+		class Parameter : public GLTF::Allocated {
 		public:
 			std::string semantic;
 			GLTF::Constants::WebGL type;
@@ -34,6 +34,6 @@ namespace GLTF {
 		GLTF::Program* program = NULL;
 
 		virtual std::string typeName();
-		virtual void writeJSON(void* writer, GLTF::Options* options);
+		virtual void writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options);
 	};
 }
@@ -12,6 +12,6 @@ namespace GLTF {
 		GLTF::Image* source = NULL;
 		
 		virtual std::string typeName();
-		virtual void writeJSON(void* writer, GLTF::Options* options);
+		virtual void writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options);
 	};
 }
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace GLTF {
+	/**
+	 * A fixed-size pool of worker threads. Each worker owns a task queue, takes work from the front
+	 * of its own queue and steals from the back of the other queues once it runs out.
+	 */
+	class ThreadPool {
+	public:
+		ThreadPool(int threadCount);
+		~ThreadPool();
+
+		int getThreadCount();
+
+		/** Queues a task to be run on one of the workers, with the arena of the calling thread current. */
+		void submit(std::function<void()> task);
+
+		/** Blocks until every submitted task has completed; the calling thread helps run queued tasks. */
+		void wait();
+
+		/** Runs `task(i)` for each `i` in `[0, count)` and returns once all of them have completed. */
+		void parallelFor(size_t count, std::function<void(size_t)> task);
+
+	private:
+		class Queue {
+		public:
+			std::mutex mutex;
+			std::deque<std::function<void()>> tasks;
+		};
+
+		std::vector<std::thread> _threads;
+		std::vector<Queue*> _queues;
+		std::mutex _mutex;
+		std::condition_variable _condition;
+		std::atomic<size_t> _queued;
+		std::atomic<size_t> _pending;
+		size_t _nextQueue = 0;
+		bool _stopping = false;
+
+		bool takeTask(size_t queueIndex, std::function<void()>& task);
+		void finishTask();
+		void run(size_t queueIndex);
+	};
+}
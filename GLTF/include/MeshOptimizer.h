@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace MeshOptimizer {
+	/**
+	 * Computes the average cache miss ratio of a triangle list, the number of vertices transformed per
+	 * triangle with a FIFO post-transform vertex cache of `cacheSize` entries.
+	 */
+	float computeACMR(const std::vector<unsigned int>& indices, size_t vertexCount, unsigned int cacheSize);
+
+	/**
+	 * Reorders the triangles of a triangle list for post-transform vertex cache locality using Tipsify
+	 * (Sander, Nehab and Barczak, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw").
+	 * The vertices of each triangle keep their order, so winding is preserved.
+	 */
+	void optimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount, unsigned int cacheSize);
+
+	/**
+	 * Renumbers vertices in the order they are first used by `indices`, rewriting `indices` in place.
+	 * Vertices that are never referenced keep their relative order after the referenced ones.
+	 *
+	 * @return The new index of each vertex, to be applied to the vertex attributes
+	 */
+	std::vector<unsigned int> optimizeVertexFetch(std::vector<unsigned int>& indices, size_t vertexCount);
+
+	/**
+	 * Estimates the overdraw of a triangle list by rasterizing it in order from the six axis directions
+	 * with back-face culling and a depth test.
+	 *
+	 * @param positions Tightly packed `x, y, z` vertex positions
+	 * @return The number of shaded fragments divided by the number of covered pixels, 1 meaning no overdraw
+	 */
+	float computeOverdraw(const std::vector<unsigned int>& indices, const float* positions, size_t vertexCount);
+
+	/**
+	 * Reorders clusters of triangles so that those likely to occlude the rest of the mesh are drawn first
+	 * (Sander, Nehab and Barczak). The input should already be optimized for the vertex cache; it is split
+	 * into clusters at points where the ACMR of a cluster stays within `threshold` times the ACMR of the
+	 * original order, so a threshold of 1.05 allows the vertex cache efficiency to degrade by about 5%.
+	 *
+	 * @param positions Tightly packed `x, y, z` vertex positions
+	 */
+	void optimizeOverdraw(std::vector<unsigned int>& indices, const float* positions, size_t vertexCount, unsigned int cacheSize, float threshold);
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+
+namespace MinMax {
+	/**
+	 * Computes the per-component minimum and maximum of tightly packed elements. Uses AVX2 when the
+	 * processor supports it, SSE2 otherwise on x86, and a scalar loop on other architectures.
+	 *
+	 * @param data The components of the elements.
+	 * @param count The number of elements, at least one.
+	 * @param numberOfComponents The number of components in each element, at most 16.
+	 * @param min Receives the minimum of each component.
+	 * @param max Receives the maximum of each component.
+	 */
+	void compute(const float* data, size_t count, int numberOfComponents, float* min, float* max);
+	void compute(const signed char* data, size_t count, int numberOfComponents, signed char* min, signed char* max);
+	void compute(const unsigned char* data, size_t count, int numberOfComponents, unsigned char* min, unsigned char* max);
+	void compute(const short* data, size_t count, int numberOfComponents, short* min, short* max);
+	void compute(const unsigned short* data, size_t count, int numberOfComponents, unsigned short* min, unsigned short* max);
+	void compute(const unsigned int* data, size_t count, int numberOfComponents, unsigned int* min, unsigned int* max);
+
+	/**
+	 * @return true if the AVX2 kernels are compiled in and supported by the processor.
+	 */
+	bool hasAVX2();
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+
+// Shared by the SSE2 and AVX2 translation units of MinMax, each instantiating
+// `reduce` with its own vector operations.
+namespace MinMax {
+	namespace Kernel {
+		static inline int greatestCommonDivisor(int a, int b) {
+			while (b != 0) {
+				int remainder = a % b;
+				a = b;
+				b = remainder;
+			}
+			return a;
+		}
+
+		template <typename Ops, int Accumulators>
+		static size_t reduceChunks(const typename Ops::Scalar* data, size_t count, int numberOfComponents, typename Ops::Scalar* min, typename Ops::Scalar* max) {
+			typedef typename Ops::Scalar Scalar;
+			typedef typename Ops::Vector Vector;
+			const size_t chunkLength = (size_t)Accumulators * Ops::lanes;
+			size_t chunks = count * numberOfComponents / chunkLength;
+			if (chunks == 0) {
+				return 0;
+			}
+
+			Vector minimum[Accumulators];
+			Vector maximum[Accumulators];
+			for (int a = 0; a < Accumulators; a++) {
+				minimum[a] = Ops::load(data + a * Ops::lanes);
+				maximum[a] = minimum[a];
+			}
+			for (size_t chunk = 1; chunk < chunks; chunk++) {
+				const Scalar* values = data + chunk * chunkLength;
+				for (int a = 0; a < Accumulators; a++) {
+					Vector value = Ops::load(values + a * Ops::lanes);
+					minimum[a] = Ops::min(minimum[a], value);
+					maximum[a] = Ops::max(maximum[a], value);
+				}
+			}
+
+			// Lane l of accumulator a always holds component (a * lanes + l) % numberOfComponents
+			Scalar laneMinimum[Ops::lanes];
+			Scalar laneMaximum[Ops::lanes];
+			for (int a = 0; a < Accumulators; a++) {
+				Ops::store(laneMinimum, minimum[a]);
+				Ops::store(laneMaximum, maximum[a]);
+				for (int l = 0; l < Ops::lanes; l++) {
+					int index = a * Ops::lanes + l;
+					int component = index % numberOfComponents;
+					if (index < numberOfComponents) {
+						min[component] = laneMinimum[l];
+						max[component] = laneMaximum[l];
+					}
+					else {
+						min[component] = laneMinimum[l] < min[component] ? laneMinimum[l] : min[component];
+						max[component] = laneMaximum[l] > max[component] ? laneMaximum[l] : max[component];
+					}
+				}
+			}
+			return chunks * chunkLength / numberOfComponents;
+		}
+
+		/**
+		 * Reduces whole chunks of tightly packed elements with vector operations. A chunk spans the least
+		 * common multiple of the vector width and the element size, so every lane of an accumulator
+		 * sees a single component.
+		 *
+		 * @return The number of elements reduced into min and max, 0 if none were.
+		 */
+		template <typename Ops>
+		static size_t reduce(const typename Ops::Scalar* data, size_t count, int numberOfComponents, typename Ops::Scalar* min, typename Ops::Scalar* max) {
+			switch (numberOfComponents / greatestCommonDivisor(numberOfComponents, Ops::lanes)) {
+			case 1:
+				return reduceChunks<Ops, 1>(data, count, numberOfComponents, min, max);
+			case 2:
+				return reduceChunks<Ops, 2>(data, count, numberOfComponents, min, max);
+			case 3:
+				return reduceChunks<Ops, 3>(data, count, numberOfComponents, min, max);
+			case 4:
+				return reduceChunks<Ops, 4>(data, count, numberOfComponents, min, max);
+			case 9:
+				return reduceChunks<Ops, 9>(data, count, numberOfComponents, min, max);
+			}
+			return 0;
+		}
+
+		size_t reduceAVX2(const float* data, size_t count, int numberOfComponents, float* min, float* max);
+		size_t reduceAVX2(const signed char* data, size_t count, int numberOfComponents, signed char* min, signed char* max);
+		size_t reduceAVX2(const unsigned char* data, size_t count, int numberOfComponents, unsigned char* min, unsigned char* max);
+		size_t reduceAVX2(const short* data, size_t count, int numberOfComponents, short* min, short* max);
+		size_t reduceAVX2(const unsigned short* data, size_t count, int numberOfComponents, unsigned short* min, unsigned short* max);
+		size_t reduceAVX2(const unsigned int* data, size_t count, int numberOfComponents, unsigned int* min, unsigned int* max);
+	}
+}
@@ -1,50 +1,79 @@
 #include "Base64.h"
+#include "Base64Kernel.h"
+#include "CPUFeatures.h"
 
-#include <cmath>
+#include <algorithm>
 
 static inline bool is_base64(unsigned char c) {
 	return (isalnum(c) || (c == '+') || (c == '/'));
 }
 
 static const std::string base64CharSet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-char* Base64::encode(unsigned char* data, size_t length) {
-	size_t base64Length = (size_t)(ceil(length / 3.0) * 4) + 1;
-	char* base64 = new char[base64Length];
-	int index;
-	int j = 0;
-	for (size_t i = 0; i < length; i += 3) {
-		index = (data[i] & 0xFC) >> 2;
-		base64[j] = base64CharSet[index];
-		j++;
-		index = (data[i] & 0x03) << 4;
+static const char base64Table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+void encodeScalar(const unsigned char* data, size_t length, char* base64) {
+	size_t i = 0;
+	for (; i + 3 <= length; i += 3) {
+		unsigned int group = (data[i] << 16) | (data[i + 1] << 8) | data[i + 2];
+		base64[0] = base64Table[(group >> 18) & 0x3F];
+		base64[1] = base64Table[(group >> 12) & 0x3F];
+		base64[2] = base64Table[(group >> 6) & 0x3F];
+		base64[3] = base64Table[group & 0x3F];
+		base64 += 4;
+	}
+	if (i < length) {
+		unsigned int group = data[i] << 16;
 		if (i + 1 < length) {
-			index |= (data[i + 1] & 0xF0) >> 4;
-			base64[j] = base64CharSet[index];
-			j++;
-			index = (data[i + 1] & 0x0F) << 2;
-			if (i + 2 < length) {
-				index |= (data[i + 2] & 0xC0) >> 6;
-				base64[j] = base64CharSet[index];
-				j++;
-				index = data[i + 2] & 0x3F;
-				base64[j] = base64CharSet[index];
-				j++;
-			}
-			else {
-				base64[j] = base64CharSet[index];
-				base64[j + 1] = '=';
-			}
-		}
-		else {
-			base64[j] = base64CharSet[index];
-			base64[j + 1] = '=';
-			base64[j + 2] = '=';
+			group |= data[i + 1] << 8;
 		}
+		base64[0] = base64Table[(group >> 18) & 0x3F];
+		base64[1] = base64Table[(group >> 12) & 0x3F];
+		base64[2] = i + 1 < length ? base64Table[(group >> 6) & 0x3F] : '=';
+		base64[3] = '=';
+	}
+}
+
+size_t Base64::encodedLength(size_t length) {
+	return (length + 2) / 3 * 4;
+}
+
+void Base64::encode(const unsigned char* data, size_t length, char* base64) {
+	size_t encoded = 0;
+#ifdef BASE64_SIMD
+	if (CPUFeatures::hasAVX2()) {
+		encoded = Base64::Kernel::encodeAVX2(data, length, base64);
+	}
+	else if (CPUFeatures::hasSSSE3()) {
+		encoded = Base64::Kernel::encodeSSSE3(data, length, base64);
+	}
+#endif
+	encodeScalar(data + encoded, length - encoded, base64 + encoded / 3 * 4);
+}
+
+std::string Base64::encode(const unsigned char* data, size_t length) {
+	std::string base64(encodedLength(length), '\0');
+	if (length > 0) {
+		encode(data, length, &base64[0]);
 	}
-	base64[base64Length - 1] = '\0';
 	return base64;
 }
 
+void Base64::writeDataUri(GLTF::JSONWriter* jsonWriter, const std::string& mimeType, const unsigned char* data, size_t length) {
+	// A multiple of 3 bytes, so only the last block is padded
+	const size_t blockLength = 12288;
+	char base64[blockLength / 3 * 4];
+	jsonWriter->StartString();
+	jsonWriter->StringPart("data:", 5);
+	jsonWriter->StringPart(mimeType.c_str(), mimeType.length());
+	jsonWriter->StringPart(";base64,", 8);
+	for (size_t offset = 0; offset < length; offset += blockLength) {
+		size_t dataLength = std::min(blockLength, length - offset);
+		encode(data + offset, dataLength, base64);
+		jsonWriter->StringPart(base64, encodedLength(dataLength));
+	}
+	jsonWriter->EndString();
+}
+
 std::string Base64::decode(std::string string) {
 	size_t length = string.size();
 	size_t i = 0;
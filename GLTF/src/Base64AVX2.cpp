@@ -0,0 +1,43 @@
+#include "Base64Kernel.h"
+
+// Compiled with AVX2 enabled when BASE64_SIMD is defined, CPUFeatures::hasAVX2 guards every call.
+// Nothing here may be shared with other translation units, or the linker could pick AVX2 code for them.
+#if defined(BASE64_SIMD) && (defined(__AVX2__) || defined(_MSC_VER))
+#include <immintrin.h>
+
+namespace {
+	// Spreads 12 bytes in each 128-bit lane into 16 lanes holding one 6-bit index each
+	__m256i splitIndices(__m256i bytes) {
+		bytes = _mm256_shuffle_epi8(bytes, _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+			10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+		__m256i high = _mm256_mulhi_epu16(_mm256_and_si256(bytes, _mm256_set1_epi32(0x0FC0FC00)), _mm256_set1_epi32(0x04000040));
+		__m256i low = _mm256_mullo_epi16(_mm256_and_si256(bytes, _mm256_set1_epi32(0x003F03F0)), _mm256_set1_epi32(0x01000010));
+		return _mm256_or_si256(high, low);
+	}
+
+	// Maps each index to its character by adding the offset of the range it falls in
+	__m256i lookup(__m256i indices) {
+		__m256i range = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+		__m256i upperCase = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+		range = _mm256_or_si256(range, _mm256_and_si256(upperCase, _mm256_set1_epi8(13)));
+		__m256i offsets = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+			'0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+			'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+			'0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+		return _mm256_add_epi8(_mm256_shuffle_epi8(offsets, range), indices);
+	}
+}
+
+size_t Base64::Kernel::encodeAVX2(const unsigned char* data, size_t length, char* base64) {
+	size_t i = 0;
+	// Each lane loads 16 bytes and encodes the first 12, the upper lane starts 12 bytes in
+	for (; i + 28 <= length; i += 24) {
+		__m128i lower = _mm_loadu_si128((const __m128i*)(data + i));
+		__m128i upper = _mm_loadu_si128((const __m128i*)(data + i + 12));
+		__m256i bytes = _mm256_inserti128_si256(_mm256_castsi128_si256(lower), upper, 1);
+		_mm256_storeu_si256((__m256i*)base64, lookup(splitIndices(bytes)));
+		base64 += 32;
+	}
+	return i;
+}
+#endif
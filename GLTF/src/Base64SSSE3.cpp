@@ -0,0 +1,37 @@
+#include "Base64Kernel.h"
+
+// Compiled with SSSE3 enabled when BASE64_SIMD is defined, CPUFeatures::hasSSSE3 guards every call.
+#if defined(BASE64_SIMD) && (defined(__SSSE3__) || defined(_MSC_VER))
+#include <tmmintrin.h>
+
+namespace {
+	// Spreads 12 bytes into 16 lanes holding one 6-bit index each
+	__m128i splitIndices(__m128i bytes) {
+		bytes = _mm_shuffle_epi8(bytes, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+		__m128i high = _mm_mulhi_epu16(_mm_and_si128(bytes, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+		__m128i low = _mm_mullo_epi16(_mm_and_si128(bytes, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+		return _mm_or_si128(high, low);
+	}
+
+	// Maps each index to its character by adding the offset of the range it falls in
+	__m128i lookup(__m128i indices) {
+		__m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+		__m128i upperCase = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+		range = _mm_or_si128(range, _mm_and_si128(upperCase, _mm_set1_epi8(13)));
+		__m128i offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+			'0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+		return _mm_add_epi8(_mm_shuffle_epi8(offsets, range), indices);
+	}
+}
+
+size_t Base64::Kernel::encodeSSSE3(const unsigned char* data, size_t length, char* base64) {
+	size_t i = 0;
+	// Each load reads 16 bytes and encodes the first 12
+	for (; i + 16 <= length; i += 12) {
+		__m128i bytes = _mm_loadu_si128((const __m128i*)(data + i));
+		_mm_storeu_si128((__m128i*)base64, lookup(splitIndices(bytes)));
+		base64 += 16;
+	}
+	return i;
+}
+#endif
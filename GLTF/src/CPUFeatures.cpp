@@ -0,0 +1,40 @@
+#include "CPUFeatures.h"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+bool CPUFeatures::hasSSSE3() {
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+	static bool supported = __builtin_cpu_supports("ssse3");
+	return supported;
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	static bool supported = []() {
+		int info[4];
+		__cpuid(info, 1);
+		return (info[2] & (1 << 9)) != 0;
+	}();
+	return supported;
+#else
+	return false;
+#endif
+}
+
+bool CPUFeatures::hasAVX2() {
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+	static bool supported = __builtin_cpu_supports("avx2");
+	return supported;
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	static bool supported = []() {
+		int info[4];
+		__cpuid(info, 1);
+		// The operating system must save the YMM registers
+		bool osxsave = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6) == 6;
+		__cpuidex(info, 7, 0);
+		return osxsave && (info[1] & (1 << 5)) != 0;
+	}();
+	return supported;
+#else
+	return false;
+#endif
+}
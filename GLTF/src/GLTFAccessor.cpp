@@ -5,9 +5,8 @@
 #include <stdlib.h>
 
 #include "GLTFAccessor.h"
-
-#include "rapidjson/stringbuffer.h"
-#include "rapidjson/writer.h"
+#include "GLTFAccessorView.h"
+#include "MinMax.h"
 
 GLTF::Accessor::Accessor(GLTF::Accessor::Type type,
 	GLTF::Constants::WebGL componentType
@@ -17,30 +16,32 @@ GLTF::Accessor::Accessor(GLTF::Accessor::Type type,
 	GLTF::Constants::WebGL componentType,
 	unsigned char* data,
 	int count,
-	GLTF::Constants::WebGL target
+	GLTF::Constants::WebGL target,
+	bool deferMinMax
 ) : Accessor(type, componentType) {
-	int byteLength = count * this->getNumberOfComponents() * this->getComponentByteLength();
+	size_t byteLength = (size_t)count * this->getNumberOfComponents() * this->getComponentByteLength();
 	unsigned char* allocatedData = (unsigned char*)malloc(byteLength);
 	std::memcpy(allocatedData, data, byteLength);
 	this->bufferView = new GLTF::BufferView(allocatedData, byteLength, target);
 	this->count = count;
-	this->computeMinMax();
+	this->updateMinMax(deferMinMax);
 }
 
 GLTF::Accessor::Accessor(GLTF::Accessor::Type type,
 	GLTF::Constants::WebGL componentType,
 	unsigned char* data,
 	int count,
-	GLTF::BufferView* bufferView
+	GLTF::BufferView* bufferView,
+	bool deferMinMax
 ) : Accessor(type, componentType) {
 	GLTF::Buffer* buffer = bufferView->buffer;
 	this->bufferView = bufferView;
 	this->byteOffset = bufferView->byteLength;
 	this->count = count;
 	int componentByteLength = this->getComponentByteLength();
-	int byteLength = count * this->getNumberOfComponents() * componentByteLength;
+	size_t byteLength = (size_t)count * this->getNumberOfComponents() * componentByteLength;
 
-	int padding = byteOffset % componentByteLength;
+	size_t padding = byteOffset % componentByteLength;
 	if (padding != 0) {
 		padding = componentByteLength - padding;
 	}
@@ -50,7 +51,7 @@ GLTF::Accessor::Accessor(GLTF::Accessor::Type type,
 	std::memcpy(buffer->data + buffer->byteLength + padding, data, byteLength);
 	buffer->byteLength += byteLength + padding;
 	bufferView->byteLength += byteLength + padding;
-	this->computeMinMax();
+	this->updateMinMax(deferMinMax);
 }
 
 GLTF::Accessor::Accessor(GLTF::Accessor::Type type,
@@ -64,29 +65,75 @@ GLTF::Accessor::Accessor(GLTF::Accessor::Type type,
 	this->bufferView = bufferView;
 }
 
+GLTF::Accessor::~Accessor() {
+	delete[] max;
+	delete[] min;
+}
+
+struct MinMaxVisitor {
+	double* min;
+	double* max;
+
+	template <typename T, int N>
+	void operator()(const GLTF::AccessorView<T, N>& view) {
+		T elementMin[N];
+		T elementMax[N];
+		if (view.byteStride == sizeof(T) * N) {
+			MinMax::compute((const T*)view.data, view.count, N, elementMin, elementMax);
+		}
+		else {
+			T* element = view[0];
+			for (int j = 0; j < N; j++) {
+				elementMin[j] = element[j];
+				elementMax[j] = element[j];
+			}
+			for (int i = 1; i < view.count; i++) {
+				element = view[i];
+				for (int j = 0; j < N; j++) {
+					elementMin[j] = std::min(element[j], elementMin[j]);
+					elementMax[j] = std::max(element[j], elementMax[j]);
+				}
+			}
+		}
+		for (int j = 0; j < N; j++) {
+			min[j] = (double)elementMin[j];
+			max[j] = (double)elementMax[j];
+		}
+	}
+};
+
+void GLTF::Accessor::updateMinMax(bool deferMinMax) {
+	if (deferMinMax) {
+		this->minMaxDeferred = true;
+	}
+	else {
+		this->computeMinMax();
+	}
+}
+
 bool GLTF::Accessor::computeMinMax() {
+	if (this->count > 0) {
+		unsigned char* data = this->bufferView->buffer->data + this->bufferView->byteOffset + this->byteOffset;
+		return this->computeMinMax(data, this->getByteStride());
+	}
+	this->minMaxDeferred = false;
+	return true;
+}
+
+bool GLTF::Accessor::computeMinMax(unsigned char* data, int byteStride) {
 	int numberOfComponents = this->getNumberOfComponents();
-	int count = this->count;
-	if (count > 0) {
+	this->minMaxDeferred = false;
+	if (this->count > 0) {
 		if (max == NULL) {
-			max = new float[numberOfComponents];
+			max = new double[numberOfComponents];
 		}
 		if (min == NULL) {
-			min = new float[numberOfComponents];
-		}
-		float* component = new float[numberOfComponents];
-		this->getComponentAtIndex(0, component);
-		for (int i = 0; i < numberOfComponents; i++) {
-			min[i] = component[i];
-			max[i] = component[i];
-		}
-		for (int i = 1; i < this->count; i++) {
-			this->getComponentAtIndex(i, component);
-			for (int j = 0; j < numberOfComponents; j++) {
-				min[j] = std::min(component[j], min[j]);
-				max[j] = std::max(component[j], max[j]);
-			}
+			min = new double[numberOfComponents];
 		}
+		MinMaxVisitor visitor;
+		visitor.min = min;
+		visitor.max = max;
+		return GLTF::visitAccessor(this, data, byteStride, visitor);
 	}
 	return true;
 }
@@ -99,9 +146,9 @@ int GLTF::Accessor::getByteStride() {
 }
 
 bool GLTF::Accessor::getComponentAtIndex(int index, float* component) {
-	int byteOffset = this->byteOffset + this->bufferView->byteOffset;
+	size_t byteOffset = this->byteOffset + this->bufferView->byteOffset;
 	int numberOfComponents = this->getNumberOfComponents();
-	byteOffset += this->getByteStride() * index;
+	byteOffset += (size_t)this->getByteStride() * index;
 	unsigned char* buf = this->bufferView->buffer->data + byteOffset;
 
 	for (int i = 0; i < numberOfComponents; i++) {
@@ -132,9 +179,9 @@ bool GLTF::Accessor::getComponentAtIndex(int index, float* component) {
 }
 
 bool GLTF::Accessor::writeComponentAtIndex(int index, float* component) {
-	int byteOffset = this->byteOffset + this->bufferView->byteOffset;
+	size_t byteOffset = this->byteOffset + this->bufferView->byteOffset;
 	int numberOfComponents = this->getNumberOfComponents();
-	byteOffset += this->getByteStride() * index;
+	byteOffset += (size_t)this->getByteStride() * index;
 	unsigned char* buf = this->bufferView->buffer->data + byteOffset;
 
 	for (int i = 0; i < numberOfComponents; i++) {
@@ -226,31 +273,45 @@ const char* GLTF::Accessor::getTypeName() {
 	return "";
 }
 
+struct EqualsVisitor {
+	GLTF::Accessor* accessor;
+	bool equal;
+
+	template <typename T, int N>
+	void operator()(const GLTF::AccessorView<T, N>& view) {
+		GLTF::AccessorView<T, N> other(accessor);
+		for (int i = 0; i < view.count; i++) {
+			T* elementOne = view[i];
+			T* elementTwo = other[i];
+			for (int j = 0; j < N; j++) {
+				if (elementOne[j] != elementTwo[j]) {
+					equal = false;
+					return;
+				}
+			}
+		}
+		equal = true;
+	}
+};
+
 bool GLTF::Accessor::equals(GLTF::Accessor* accessor) {
 	if (type != accessor->type || componentType != accessor->componentType || count != accessor->count) {
 		return false;
 	}
-	int numberOfComponents = getNumberOfComponents();
-	float* componentOne = new float[numberOfComponents];
-	float* componentTwo = new float[numberOfComponents];
-	for (int i = 0; i < count; i++) {
-		this->getComponentAtIndex(i, componentOne);
-		accessor->getComponentAtIndex(i, componentTwo);
-		for (int j = 0; j < numberOfComponents; j++) {
-			if (componentOne[j] != componentTwo[j]) {
-				return false;
-			}
-		}
+	if (count == 0) {
+		return true;
 	}
-	return true;
+	EqualsVisitor visitor;
+	visitor.accessor = accessor;
+	visitor.equal = false;
+	return GLTF::visitAccessor(this, visitor) && visitor.equal;
 }
 
 std::string GLTF::Accessor::typeName() {
 	return "accessor";
 }
 
-void GLTF::Accessor::writeJSON(void* writer, GLTF::Options* options) {
-	rapidjson::Writer<rapidjson::StringBuffer>* jsonWriter = (rapidjson::Writer<rapidjson::StringBuffer>*)writer;
+void GLTF::Accessor::writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options) {
 	if (this->bufferView) {
 		jsonWriter->Key("bufferView");
 		if (options->version == "1.0") {
@@ -260,7 +321,7 @@ void GLTF::Accessor::writeJSON(void* writer, GLTF::Options* options) {
 			jsonWriter->Int(this->bufferView->id);
 		}
 		jsonWriter->Key("byteOffset");
-		jsonWriter->Int(this->byteOffset);
+		jsonWriter->Uint64(this->byteOffset);
 	}
 	if (options->version == "1.0") {
 		int byteStride = bufferView->byteStride;
@@ -269,10 +330,17 @@ void GLTF::Accessor::writeJSON(void* writer, GLTF::Options* options) {
 			jsonWriter->Int(bufferView->byteStride);
 		}
 	}
+	if (this->minMaxDeferred && this->bufferView != NULL) {
+		this->computeMinMax();
+	}
 	jsonWriter->Key("componentType");
 	jsonWriter->Int((int)this->componentType);
 	jsonWriter->Key("count");
 	jsonWriter->Int(this->count);
+	if (this->normalized && options->version != "1.0") {
+		jsonWriter->Key("normalized");
+		jsonWriter->Bool(true);
+	}
 	if (this->max) {
 		jsonWriter->Key("max");
 		jsonWriter->StartArray();
@@ -280,6 +348,9 @@ void GLTF::Accessor::writeJSON(void* writer, GLTF::Options* options) {
 			if (componentType == GLTF::Constants::WebGL::FLOAT) {
 				jsonWriter->Double(this->max[i]);
 			}
+			else if (componentType == GLTF::Constants::WebGL::UNSIGNED_INT) {
+				jsonWriter->Uint64((uint64_t)this->max[i]);
+			}
 			else {
 				jsonWriter->Int((int)this->max[i]);
 			}
@@ -293,6 +364,9 @@ void GLTF::Accessor::writeJSON(void* writer, GLTF::Options* options) {
 			if (componentType == GLTF::Constants::WebGL::FLOAT) {
 				jsonWriter->Double(this->min[i]);
 			}
+			else if (componentType == GLTF::Constants::WebGL::UNSIGNED_INT) {
+				jsonWriter->Uint64((uint64_t)this->min[i]);
+			}
 			else {
 				jsonWriter->Int((int)this->min[i]);
 			}
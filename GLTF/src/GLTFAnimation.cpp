@@ -1,8 +1,5 @@
 #include "GLTFAnimation.h"
 
-#include "rapidjson/stringbuffer.h"
-#include "rapidjson/writer.h"
-
 std::string pathString(GLTF::Animation::Path path) {
 	switch (path) {
 	case GLTF::Animation::Path::TRANSLATION:
@@ -21,9 +18,7 @@ std::string GLTF::Animation::typeName() {
 	return "animation";
 }
 
-void GLTF::Animation::writeJSON(void* writer, GLTF::Options* options) {
-	rapidjson::Writer<rapidjson::StringBuffer>* jsonWriter = (rapidjson::Writer<rapidjson::StringBuffer>*)writer;
-
+void GLTF::Animation::writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options) {
 	jsonWriter->Key("channels");
 	jsonWriter->StartArray();
 
@@ -36,7 +31,7 @@ void GLTF::Animation::writeJSON(void* writer, GLTF::Options* options) {
 				samplers.push_back(channel->sampler);
 			}
 			jsonWriter->StartObject();
-			channel->writeJSON(writer, options);
+			channel->writeJSON(jsonWriter, options);
 			jsonWriter->EndObject();
 		}
 	}
@@ -102,7 +97,7 @@ void GLTF::Animation::writeJSON(void* writer, GLTF::Options* options) {
 			jsonWriter->Key(sampler->getStringId().c_str());
 		}
 		jsonWriter->StartObject();
-		sampler->writeJSON(writer, options);
+		sampler->writeJSON(jsonWriter, options);
 		jsonWriter->EndObject();
 	}
 	if (options->version == "1.0") {
@@ -112,16 +107,14 @@ void GLTF::Animation::writeJSON(void* writer, GLTF::Options* options) {
 		jsonWriter->EndArray();
 	}
 	samplers.clear();
-	GLTF::Object::writeJSON(writer, options);
+	GLTF::Object::writeJSON(jsonWriter, options);
 }
 
 std::string GLTF::Animation::Sampler::typeName() {
 	return "sampler";
 }
 
-void GLTF::Animation::Sampler::writeJSON(void* writer, GLTF::Options* options) {
-	rapidjson::Writer<rapidjson::StringBuffer>* jsonWriter = (rapidjson::Writer<rapidjson::StringBuffer>*)writer;
-
+void GLTF::Animation::Sampler::writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options) {
 	jsonWriter->Key("input");
 	if (options->version == "1.0") {
 		jsonWriter->String(inputString.c_str());
@@ -138,12 +131,10 @@ void GLTF::Animation::Sampler::writeJSON(void* writer, GLTF::Options* options) {
 	else {
 		jsonWriter->Int(output->id);
 	}
-	GLTF::Object::writeJSON(writer, options);
+	GLTF::Object::writeJSON(jsonWriter, options);
 }
 
-void GLTF::Animation::Channel::writeJSON(void* writer, GLTF::Options* options) {
-	rapidjson::Writer<rapidjson::StringBuffer>* jsonWriter = (rapidjson::Writer<rapidjson::StringBuffer>*)writer;
-
+void GLTF::Animation::Channel::writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options) {
 	jsonWriter->Key("sampler");
 	if (options->version == "1.0") {
 		jsonWriter->String(sampler->getStringId().c_str());
@@ -153,14 +144,13 @@ void GLTF::Animation::Channel::writeJSON(void* writer, GLTF::Options* options) {
 	}
 	jsonWriter->Key("target");
 	jsonWriter->StartObject();
-	target->writeJSON(writer, options);
+	target->writeJSON(jsonWriter, options);
 	jsonWriter->EndObject();
 
-	GLTF::Object::writeJSON(writer, options);
+	GLTF::Object::writeJSON(jsonWriter, options);
 }
 
-void GLTF::Animation::Channel::Target::writeJSON(void* writer, GLTF::Options* options) {
-	rapidjson::Writer<rapidjson::StringBuffer>* jsonWriter = (rapidjson::Writer<rapidjson::StringBuffer>*)writer;
+void GLTF::Animation::Channel::Target::writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options) {
 	
 	if (options->version == "1.0") {
 		jsonWriter->Key("id");
@@ -173,5 +163,5 @@ void GLTF::Animation::Channel::Target::writeJSON(void* writer, GLTF::Options* op
 	jsonWriter->Key("path");
 	jsonWriter->String(pathString(path).c_str());
 
-	GLTF::Object::writeJSON(writer, options);
+	GLTF::Object::writeJSON(jsonWriter, options);
 }
\ No newline at end of file
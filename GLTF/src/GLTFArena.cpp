@@ -0,0 +1,218 @@
+#include "GLTFArena.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+	const size_t ALIGNMENT = alignof(std::max_align_t);
+	const size_t BLOCK_LENGTH = 64 * 1024;
+
+	size_t alignLength(size_t length) {
+		return (length + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+	}
+
+	// Blocks start with a pointer to the block allocated before them
+	const size_t BLOCK_HEADER_LENGTH = alignLength(sizeof(unsigned char*));
+
+	thread_local GLTF::Arena* currentArena = NULL;
+
+	std::atomic<size_t> heapAllocations(0);
+	std::atomic<size_t> heapDeletions(0);
+	std::atomic<size_t> heapByteLength(0);
+}
+
+/**
+ * Placed before every allocated object. Objects from an arena are kept in a list of the objects
+ * that are still alive, objects from the heap have no arena.
+ */
+class GLTF::Arena::Header {
+public:
+	GLTF::Arena* arena;
+	Header* previous;
+	Header* next;
+};
+
+const size_t GLTF::Arena::HEADER_LENGTH = alignLength(sizeof(GLTF::Arena::Header));
+
+GLTF::Arena::Scope::Scope(GLTF::Arena* arena) : _previous(currentArena) {
+	currentArena = arena;
+}
+
+GLTF::Arena::Scope::~Scope() {
+	currentArena = _previous;
+}
+
+GLTF::Arena::Arena() {}
+
+GLTF::Arena::~Arena() {
+	release();
+}
+
+GLTF::Arena* GLTF::Arena::current() {
+	return currentArena;
+}
+
+void GLTF::Arena::makeCurrent() {
+	if (_isCurrent) {
+		return;
+	}
+	_previous = currentArena;
+	_isCurrent = true;
+	currentArena = this;
+}
+
+void* GLTF::Arena::allocate(size_t size) {
+	GLTF::Arena* arena = currentArena;
+	GLTF::Arena::Header* header;
+	if (arena == NULL) {
+		header = (GLTF::Arena::Header*)malloc(HEADER_LENGTH + size);
+		if (header == NULL) {
+			throw std::bad_alloc();
+		}
+		header->arena = NULL;
+		header->previous = NULL;
+		header->next = NULL;
+		heapAllocations++;
+		heapByteLength += size;
+	}
+	else {
+		std::lock_guard<std::mutex> lock(arena->_mutex);
+		header = (GLTF::Arena::Header*)arena->allocateFromBlock(HEADER_LENGTH + size);
+		header->arena = arena;
+		header->previous = NULL;
+		header->next = arena->_live;
+		if (arena->_live != NULL) {
+			arena->_live->previous = header;
+		}
+		arena->_live = header;
+		arena->_statistics.allocations++;
+		arena->_statistics.byteLength += size;
+	}
+	return (unsigned char*)header + HEADER_LENGTH;
+}
+
+void* GLTF::Arena::allocateBytes(size_t length) {
+	GLTF::Arena* arena = currentArena;
+	if (arena == NULL) {
+		void* memory = malloc(length);
+		if (memory == NULL) {
+			throw std::bad_alloc();
+		}
+		heapByteLength += length;
+		return memory;
+	}
+	std::lock_guard<std::mutex> lock(arena->_mutex);
+	arena->_statistics.byteLength += length;
+	return arena->allocateFromBlock(length);
+}
+
+void GLTF::Arena::deallocate(void* pointer) {
+	if (pointer == NULL) {
+		return;
+	}
+	GLTF::Arena::Header* header = (GLTF::Arena::Header*)((unsigned char*)pointer - HEADER_LENGTH);
+	GLTF::Arena* arena = header->arena;
+	if (arena == NULL) {
+		free(header);
+		heapDeletions++;
+		return;
+	}
+	std::lock_guard<std::mutex> lock(arena->_mutex);
+	arena->unlink(header);
+	arena->_statistics.deletions++;
+}
+
+void* GLTF::Arena::allocateFromBlock(size_t length) {
+	length = alignLength(length);
+	if (length > (size_t)(_end - _next)) {
+		// Large objects get a block of their own, so the current block is not abandoned for them
+		size_t blockLength = BLOCK_HEADER_LENGTH + length;
+		bool isLarge = blockLength > BLOCK_LENGTH / 4;
+		if (!isLarge) {
+			blockLength = BLOCK_LENGTH;
+		}
+		unsigned char* block = (unsigned char*)malloc(blockLength);
+		if (block == NULL) {
+			throw std::bad_alloc();
+		}
+		*(unsigned char**)block = _blocks;
+		_blocks = block;
+		_statistics.blocks++;
+		_statistics.blockByteLength += blockLength;
+		if (isLarge) {
+			return block + BLOCK_HEADER_LENGTH;
+		}
+		_next = block + BLOCK_HEADER_LENGTH;
+		_end = block + blockLength;
+	}
+	void* memory = _next;
+	_next += length;
+	return memory;
+}
+
+void GLTF::Arena::unlink(GLTF::Arena::Header* header) {
+	if (header->previous != NULL) {
+		header->previous->next = header->next;
+	}
+	else {
+		_live = header->next;
+	}
+	if (header->next != NULL) {
+		header->next->previous = header->previous;
+	}
+	header->previous = NULL;
+	header->next = NULL;
+}
+
+void GLTF::Arena::release() {
+	while (_live != NULL) {
+		GLTF::Arena::Header* header = _live;
+		unlink(header);
+		GLTF::Allocated* object = (GLTF::Allocated*)((unsigned char*)header + HEADER_LENGTH);
+		object->~Allocated();
+	}
+	while (_blocks != NULL) {
+		unsigned char* block = _blocks;
+		_blocks = *(unsigned char**)block;
+		free(block);
+	}
+	_next = NULL;
+	_end = NULL;
+
+	if (_isCurrent) {
+		if (currentArena == this) {
+			currentArena = _previous;
+		}
+		else {
+			for (GLTF::Arena* arena = currentArena; arena != NULL; arena = arena->_previous) {
+				if (arena->_previous == this) {
+					arena->_previous = _previous;
+					break;
+				}
+			}
+		}
+		_previous = NULL;
+		_isCurrent = false;
+	}
+}
+
+const GLTF::Arena::Statistics& GLTF::Arena::getStatistics() const {
+	return _statistics;
+}
+
+GLTF::Arena::Statistics GLTF::Arena::getHeapStatistics() {
+	GLTF::Arena::Statistics statistics;
+	statistics.allocations = heapAllocations;
+	statistics.deletions = heapDeletions;
+	statistics.byteLength = heapByteLength;
+	return statistics;
+}
+
+void* GLTF::Allocated::operator new(size_t size) {
+	return GLTF::Arena::allocate(size);
+}
+
+void GLTF::Allocated::operator delete(void* pointer) {
+	GLTF::Arena::deallocate(pointer);
+}
@@ -1,22 +1,47 @@
 #include "GLTFAsset.h"
 
 #include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
 #include <functional>
+#include <iostream>
 #include <map>
 #include <set>
+#include <unordered_map>
+#include <unordered_set>
 
-#include "rapidjson/stringbuffer.h"
-#include "rapidjson/writer.h"
-
-std::map<GLTF::Image*, GLTF::Texture*> _pbrTextureCache;
+#include "GLTFAccessorView.h"
+#include "GLTFBufferLayout.h"
+#include "GLTFDracoCache.h"
+#include "GLTFThreadPool.h"
+#include "MeshOptimizer.h"
 
 GLTF::Asset::Asset() {
+	GLTF::Arena::Scope scope(&arena);
 	metadata = new GLTF::Asset::Metadata();
 	globalSampler = new GLTF::Sampler();
 }
 
-void GLTF::Asset::Metadata::writeJSON(void* writer, GLTF::Options* options) {
-	rapidjson::Writer<rapidjson::StringBuffer>* jsonWriter = (rapidjson::Writer<rapidjson::StringBuffer>*)writer;
+void* GLTF::Asset::operator new(size_t size) {
+	return ::operator new(size);
+}
+
+void GLTF::Asset::operator delete(void* pointer) {
+	::operator delete(pointer);
+}
+
+GLTF::Image* GLTF::Asset::loadImage(path imagePath) {
+	GLTF::Arena::Scope scope(&arena);
+	GLTF::Image*& image = _imageCache[imagePath.string()];
+	if (image == NULL) {
+		image = GLTF::Image::load(imagePath);
+	}
+	return image;
+}
+
+void GLTF::Asset::Metadata::writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options) {
 	if (options->version != "") {
 		version = options->version;
 	}
@@ -43,10 +68,11 @@ void GLTF::Asset::Metadata::writeJSON(void* writer, GLTF::Options* options) {
 		jsonWriter->Key("version");
 		jsonWriter->String(version.c_str());
 	}
-	GLTF::Object::writeJSON(writer, options);
+	GLTF::Object::writeJSON(jsonWriter, options);
 }
 
 GLTF::Scene* GLTF::Asset::getDefaultScene() {
+	GLTF::Arena::Scope scope(&arena);
 	GLTF::Scene* scene;
 	if (this->scene < 0) {
 		scene = new GLTF::Scene();
@@ -59,65 +85,65 @@ GLTF::Scene* GLTF::Asset::getDefaultScene() {
 	return scene;
 }
 
-std::vector<GLTF::Accessor*> GLTF::Asset::getAllAccessors() {
-	std::set<GLTF::Accessor*> uniqueAccessors;
-	std::vector<GLTF::Accessor*> accessors;
-	for (GLTF::Skin* skin : getAllSkins()) {
-		GLTF::Accessor* inverseBindMatrices = skin->inverseBindMatrices;
-		if (inverseBindMatrices != NULL) {
-			if (uniqueAccessors.find(inverseBindMatrices) == uniqueAccessors.end()) {
-				accessors.push_back(inverseBindMatrices);
-				uniqueAccessors.insert(inverseBindMatrices);
-			}
-		}
+/**
+ * Appends `object` to `objects` unless it is NULL or has already been added.
+ */
+template <typename T>
+void addUnique(T* object, std::vector<T*>& objects, std::unordered_set<T*>& uniqueObjects) {
+	if (object != NULL && uniqueObjects.insert(object).second) {
+		objects.push_back(object);
 	}
+}
 
-	for (GLTF::Primitive* primitive : getAllPrimitives()) {
-		for (auto* accessor: getAllPrimitiveAccessors(primitive)) {
-			if (uniqueAccessors.find(accessor) == uniqueAccessors.end()) {
-				accessors.push_back(accessor);
-				uniqueAccessors.insert(accessor);
-			}
-		}
-		GLTF::Accessor* indicesAccessor = primitive->indices;
-		if (indicesAccessor != NULL) {
-			if (uniqueAccessors.find(indicesAccessor) == uniqueAccessors.end()) {
-				accessors.push_back(indicesAccessor);
-				uniqueAccessors.insert(indicesAccessor);
-			}
-		}
+void addMaterialTextures(GLTF::Material* material, std::vector<GLTF::Texture*>& textures, std::unordered_set<GLTF::Texture*>& uniqueTextures) {
+	if (material->type == GLTF::Material::MATERIAL || material->type == GLTF::Material::MATERIAL_COMMON) {
+		GLTF::Material::Values* values = material->values;
+		addUnique(values->ambientTexture, textures, uniqueTextures);
+		addUnique(values->diffuseTexture, textures, uniqueTextures);
+		addUnique(values->emissionTexture, textures, uniqueTextures);
+		addUnique(values->specularTexture, textures, uniqueTextures);
+		addUnique(values->bumpTexture, textures, uniqueTextures);
 	}
-
-	for (GLTF::Animation* animation : animations) {
-		for (GLTF::Animation::Channel* channel : animation->channels) {
-			GLTF::Animation::Sampler* sampler = channel->sampler;
-			if (uniqueAccessors.find(sampler->input) == uniqueAccessors.end()) {
-				accessors.push_back(sampler->input);
-				uniqueAccessors.insert(sampler->input);
-			}
-			if (uniqueAccessors.find(sampler->output) == uniqueAccessors.end()) {
-				accessors.push_back(sampler->output);
-				uniqueAccessors.insert(sampler->input);
+	else if (material->type == GLTF::Material::PBR_METALLIC_ROUGHNESS) {
+		GLTF::MaterialPBR* materialPBR = (GLTF::MaterialPBR*)material;
+		GLTF::MaterialPBR::Texture* pbrTextures[] = {
+			materialPBR->metallicRoughness->baseColorTexture,
+			materialPBR->metallicRoughness->metallicRoughnessTexture,
+			materialPBR->emissiveTexture,
+			materialPBR->normalTexture,
+			materialPBR->occlusionTexture,
+			materialPBR->specularGlossiness->diffuseTexture,
+			materialPBR->specularGlossiness->specularGlossinessTexture
+		};
+		for (GLTF::MaterialPBR::Texture* pbrTexture : pbrTextures) {
+			if (pbrTexture != NULL) {
+				addUnique(pbrTexture->texture, textures, uniqueTextures);
 			}
 		}
 	}
-	return accessors;
 }
 
-std::vector<GLTF::Node*> GLTF::Asset::getAllNodes() {
-	std::vector<GLTF::Node*> nodeStack;
-	std::vector<GLTF::Node*> nodes;
-	std::set<GLTF::Node*> uniqueNodes;
-	for (GLTF::Node* node : getDefaultScene()->nodes) {
-		nodeStack.push_back(node);
+/**
+ * Gathers every object reachable from the default scene in one traversal of the scene graph, or
+ * returns the lists gathered earlier if the asset has not been invalidated since.
+ */
+const GLTF::Asset::Registry& GLTF::Asset::getRegistry() {
+	if (_registry.epoch == _epoch) {
+		return _registry;
 	}
+	Registry registry;
+	registry.epoch = _epoch;
+
+	std::unordered_set<GLTF::Node*> uniqueNodes;
+	std::vector<GLTF::Node*> nodeStack = getDefaultScene()->nodes;
 	while (nodeStack.size() > 0) {
 		GLTF::Node* node = nodeStack.back();
-		if (uniqueNodes.find(node) == uniqueNodes.end()) {
-			nodes.push_back(node);
-			uniqueNodes.insert(node);
-		}
 		nodeStack.pop_back();
+		// Shared subtrees are only walked once
+		if (!uniqueNodes.insert(node).second) {
+			continue;
+		}
+		registry.nodes.push_back(node);
 		for (GLTF::Node* child : node->children) {
 			nodeStack.push_back(child);
 		}
@@ -132,217 +158,109 @@ std::vector<GLTF::Node*> GLTF::Asset::getAllNodes() {
 			}
 		}
 	}
-	return nodes;
-}
 
-std::vector<GLTF::Mesh*> GLTF::Asset::getAllMeshes() {
-	std::vector<GLTF::Mesh*> meshes;
-	std::set<GLTF::Mesh*> uniqueMeshes;
-	for (GLTF::Node* node : getAllNodes()) {
-		if (node->mesh != NULL) {
-			if (uniqueMeshes.find(node->mesh) == uniqueMeshes.end()) {
-				meshes.push_back(node->mesh);
-				uniqueMeshes.insert(node->mesh);
-			}
+	std::unordered_set<GLTF::Mesh*> uniqueMeshes;
+	std::unordered_set<GLTF::Skin*> uniqueSkins;
+	for (GLTF::Node* node : registry.nodes) {
+		addUnique(node->mesh, registry.meshes, uniqueMeshes);
+		addUnique(node->skin, registry.skins, uniqueSkins);
+	}
+	std::unordered_set<GLTF::Primitive*> uniquePrimitives;
+	for (GLTF::Mesh* mesh : registry.meshes) {
+		for (GLTF::Primitive* primitive : mesh->primitives) {
+			addUnique(primitive, registry.primitives, uniquePrimitives);
 		}
 	}
-	return meshes;
-}
+	std::unordered_set<GLTF::Material*> uniqueMaterials;
+	for (GLTF::Primitive* primitive : registry.primitives) {
+		addUnique(primitive->material, registry.materials, uniqueMaterials);
+	}
+	std::unordered_set<GLTF::Technique*> uniqueTechniques;
+	std::unordered_set<GLTF::Texture*> uniqueTextures;
+	for (GLTF::Material* material : registry.materials) {
+		addUnique(material->technique, registry.techniques, uniqueTechniques);
+		addMaterialTextures(material, registry.textures, uniqueTextures);
+	}
+	std::unordered_set<GLTF::Program*> uniquePrograms;
+	for (GLTF::Technique* technique : registry.techniques) {
+		addUnique(technique->program, registry.programs, uniquePrograms);
+	}
+	std::unordered_set<GLTF::Shader*> uniqueShaders;
+	for (GLTF::Program* program : registry.programs) {
+		addUnique(program->vertexShader, registry.shaders, uniqueShaders);
+		addUnique(program->fragmentShader, registry.shaders, uniqueShaders);
+	}
+	std::unordered_set<GLTF::Image*> uniqueImages;
+	for (GLTF::Texture* texture : registry.textures) {
+		addUnique(texture->source, registry.images, uniqueImages);
+	}
 
-std::vector<GLTF::Primitive*> GLTF::Asset::getAllPrimitives() {
-	std::vector<GLTF::Primitive*> primitives;
-	std::set<GLTF::Primitive*> uniquePrimitives;
-	for (GLTF::Mesh* mesh : getAllMeshes()) {
-		for (GLTF::Primitive* primitive : mesh->primitives) {
-			if (uniquePrimitives.find(primitive) == uniquePrimitives.end()) {
-				primitives.push_back(primitive);
-				uniquePrimitives.insert(primitive);
-			}
+	std::unordered_set<GLTF::Accessor*> uniqueAccessors;
+	for (GLTF::Skin* skin : registry.skins) {
+		addUnique(skin->inverseBindMatrices, registry.accessors, uniqueAccessors);
+	}
+	for (GLTF::Primitive* primitive : registry.primitives) {
+		for (GLTF::Accessor* accessor : getAllPrimitiveAccessors(primitive)) {
+			addUnique(accessor, registry.accessors, uniqueAccessors);
 		}
+		addUnique(primitive->indices, registry.accessors, uniqueAccessors);
 	}
-	return primitives;
+	for (GLTF::Animation* animation : animations) {
+		for (GLTF::Animation::Channel* channel : animation->channels) {
+			addUnique(channel->sampler->input, registry.accessors, uniqueAccessors);
+			addUnique(channel->sampler->output, registry.accessors, uniqueAccessors);
+		}
+	}
+	_registry = std::move(registry);
+	return _registry;
+}
+
+void GLTF::Asset::invalidate() {
+	_epoch++;
+}
+
+std::vector<GLTF::Accessor*> GLTF::Asset::getAllAccessors() {
+	return getRegistry().accessors;
+}
+
+std::vector<GLTF::Node*> GLTF::Asset::getAllNodes() {
+	return getRegistry().nodes;
+}
+
+std::vector<GLTF::Mesh*> GLTF::Asset::getAllMeshes() {
+	return getRegistry().meshes;
+}
+
+std::vector<GLTF::Primitive*> GLTF::Asset::getAllPrimitives() {
+	return getRegistry().primitives;
 }
 
 std::vector<GLTF::Skin*> GLTF::Asset::getAllSkins() {
-	std::vector<GLTF::Skin*> skins;
-	std::set<GLTF::Skin*> uniqueSkins;
-	for (GLTF::Node* node : getAllNodes()) {
-		GLTF::Skin* skin = node->skin;
-		if (skin != NULL) {
-			if (uniqueSkins.find(skin) == uniqueSkins.end()) {
-				skins.push_back(skin);
-				uniqueSkins.insert(skin);
-			}
-		}
-	}
-	return skins;
+	return getRegistry().skins;
 }
 
 std::vector<GLTF::Material*> GLTF::Asset::getAllMaterials() {
-	std::vector<GLTF::Material*> materials;
-	std::set<GLTF::Material*> uniqueMaterials;
-	for (GLTF::Primitive* primitive : getAllPrimitives()) {
-		GLTF::Material* material = primitive->material;
-		if (material != NULL) {
-			if (uniqueMaterials.find(material) == uniqueMaterials.end()) {
-				materials.push_back(material);
-				uniqueMaterials.insert(material);
-			}
-		}
-	}
-	return materials;
+	return getRegistry().materials;
 }
 
 std::vector<GLTF::Technique*> GLTF::Asset::getAllTechniques() {
-	std::vector<GLTF::Technique*> techniques;
-	std::set<GLTF::Technique*> uniqueTechniques;
-	for (GLTF::Material* material : getAllMaterials()) {
-		GLTF::Technique* technique = material->technique;
-		if (technique != NULL) {
-			if (uniqueTechniques.find(technique) == uniqueTechniques.end()) {
-				techniques.push_back(technique);
-				uniqueTechniques.insert(technique);
-			}
-		}
-	}
-	return techniques;
+	return getRegistry().techniques;
 }
 
 std::vector<GLTF::Program*> GLTF::Asset::getAllPrograms() {
-	std::vector<GLTF::Program*> programs;
-	std::set<GLTF::Program*> uniquePrograms;
-	for (GLTF::Technique* technique : getAllTechniques()) {
-		GLTF::Program* program = technique->program;
-		if (program != NULL) {
-			if (uniquePrograms.find(program) == uniquePrograms.end()) {
-				programs.push_back(program);
-				uniquePrograms.insert(program);
-			}
-		}
-	}
-	return programs;
+	return getRegistry().programs;
 }
+
 std::vector<GLTF::Shader*> GLTF::Asset::getAllShaders() {
-	std::vector<GLTF::Shader*> shaders;
-	std::set<GLTF::Shader*> uniqueShaders;
-	for (GLTF::Program* program : getAllPrograms()) {
-		GLTF::Shader* vertexShader = program->vertexShader;
-		if (vertexShader != NULL) {
-			if (uniqueShaders.find(vertexShader) == uniqueShaders.end()) {
-				shaders.push_back(vertexShader);
-				uniqueShaders.insert(vertexShader);
-			}
-		}
-		GLTF::Shader* fragmentShader = program->fragmentShader;
-		if (fragmentShader != NULL) {
-			if (uniqueShaders.find(fragmentShader) == uniqueShaders.end()) {
-				shaders.push_back(fragmentShader);
-				uniqueShaders.insert(fragmentShader);
-			}
-		}
-	}
-	return shaders;
+	return getRegistry().shaders;
 }
 
 std::vector<GLTF::Texture*> GLTF::Asset::getAllTextures() {
-	std::vector<GLTF::Texture*> textures;
-	std::set<GLTF::Texture*> uniqueTextures;
-	for (GLTF::Material* material : getAllMaterials()) {
-		if (material->type == GLTF::Material::MATERIAL || material->type == GLTF::Material::MATERIAL_COMMON) {
-			GLTF::Material::Values* values = material->values;
-			if (values->ambientTexture != NULL) {
-				if (uniqueTextures.find(values->ambientTexture) == uniqueTextures.end()) {
-					textures.push_back(values->ambientTexture);
-					uniqueTextures.insert(values->ambientTexture);
-				}
-			}
-			if (values->diffuseTexture != NULL) {
-				if (uniqueTextures.find(values->diffuseTexture) == uniqueTextures.end()) {
-					textures.push_back(values->diffuseTexture);
-					uniqueTextures.insert(values->diffuseTexture);
-				}
-			}
-			if (values->emissionTexture != NULL) {
-				if (uniqueTextures.find(values->emissionTexture) == uniqueTextures.end()) {
-					textures.push_back(values->emissionTexture);
-					uniqueTextures.insert(values->emissionTexture);
-				}
-			}
-			if (values->specularTexture != NULL) {
-				if (uniqueTextures.find(values->specularTexture) == uniqueTextures.end()) {
-					textures.push_back(values->specularTexture);
-					uniqueTextures.insert(values->specularTexture);
-				}
-			}
-			if (values->bumpTexture != NULL) {
-				if (uniqueTextures.find(values->bumpTexture) == uniqueTextures.end()) {
-					textures.push_back(values->bumpTexture);
-					uniqueTextures.insert(values->bumpTexture);
-				}
-			}
-		}
-		else if (material->type == GLTF::Material::PBR_METALLIC_ROUGHNESS) {
-			GLTF::MaterialPBR* materialPBR = (GLTF::MaterialPBR*)material;
-			if (materialPBR->metallicRoughness->baseColorTexture != NULL) {
-				if (uniqueTextures.find(materialPBR->metallicRoughness->baseColorTexture->texture) == uniqueTextures.end()) {
-					textures.push_back(materialPBR->metallicRoughness->baseColorTexture->texture);
-					uniqueTextures.insert(materialPBR->metallicRoughness->baseColorTexture->texture);
-				}
-			}
-			if (materialPBR->metallicRoughness->metallicRoughnessTexture != NULL) {
-				if (uniqueTextures.find(materialPBR->metallicRoughness->metallicRoughnessTexture->texture) == uniqueTextures.end()) {
-					textures.push_back(materialPBR->metallicRoughness->metallicRoughnessTexture->texture);
-					uniqueTextures.insert(materialPBR->metallicRoughness->metallicRoughnessTexture->texture);
-				}
-			}
-			if (materialPBR->emissiveTexture != NULL) {
-				if (uniqueTextures.find(materialPBR->emissiveTexture->texture) == uniqueTextures.end()) {
-					textures.push_back(materialPBR->emissiveTexture->texture);
-					uniqueTextures.insert(materialPBR->emissiveTexture->texture);
-				}
-			}
-			if (materialPBR->normalTexture != NULL) {
-				if (uniqueTextures.find(materialPBR->normalTexture->texture) == uniqueTextures.end()) {
-					textures.push_back(materialPBR->normalTexture->texture);
-					uniqueTextures.insert(materialPBR->normalTexture->texture);
-				}
-			}
-			if (materialPBR->occlusionTexture != NULL) {
-				if (uniqueTextures.find(materialPBR->occlusionTexture->texture) == uniqueTextures.end()) {
-					textures.push_back(materialPBR->occlusionTexture->texture);
-					uniqueTextures.insert(materialPBR->occlusionTexture->texture);
-				}
-			}
-			if (materialPBR->specularGlossiness->diffuseTexture != NULL) {
-				if (uniqueTextures.find(materialPBR->specularGlossiness->diffuseTexture->texture) == uniqueTextures.end()) {
-					textures.push_back(materialPBR->specularGlossiness->diffuseTexture->texture);
-					uniqueTextures.insert(materialPBR->specularGlossiness->diffuseTexture->texture);
-				}
-			}
-			if (materialPBR->specularGlossiness->specularGlossinessTexture != NULL) {
-				if (uniqueTextures.find(materialPBR->specularGlossiness->specularGlossinessTexture->texture) == uniqueTextures.end()) {
-					textures.push_back(materialPBR->specularGlossiness->specularGlossinessTexture->texture);
-					uniqueTextures.insert(materialPBR->specularGlossiness->specularGlossinessTexture->texture);
-				}
-			}
-		}
-	}
-	return textures;
+	return getRegistry().textures;
 }
 
 std::vector<GLTF::Image*> GLTF::Asset::getAllImages() {
-	std::vector<GLTF::Image*> images;
-	std::set<GLTF::Image*> uniqueImages;
-	for (GLTF::Texture* texture : getAllTextures()) {
-		GLTF::Image* image = texture->source;
-		if (image != NULL) {
-			if (uniqueImages.find(image) == uniqueImages.end()) {
-				images.push_back(image);
-				uniqueImages.insert(image);
-			}
-		}
-	}
-	return images;
+	return getRegistry().images;
 }
 
 std::vector<GLTF::Accessor*> GLTF::Asset::getAllPrimitiveAccessors(GLTF::Primitive* primitive) const
@@ -378,6 +296,7 @@ std::vector<GLTF::BufferView*> GLTF::Asset::getAllCompressedBufferView() {
 }
 
 void GLTF::Asset::mergeAnimations() {
+	GLTF::Arena::Scope scope(&arena);
 	if (animations.size() == 0) { return; }
 
 	GLTF::Animation* mergedAnimation = new GLTF::Animation();
@@ -392,21 +311,30 @@ void GLTF::Asset::mergeAnimations() {
 
 	animations.clear();
 	animations.push_back(mergedAnimation);
+	invalidate();
 }
 
 void GLTF::Asset::removeUncompressedBufferViews() {
+	GLTF::Arena::Scope scope(&arena);
 	for (GLTF::Primitive* primitive : getAllPrimitives()) {
 		auto dracoExtensionPtr = primitive->extensions.find("KHR_draco_mesh_compression");
 		if (dracoExtensionPtr != primitive->extensions.end()) {
 			// Currently assume all attributes are compressed in Draco extension.
 			for (const auto accessor: getAllPrimitiveAccessors(primitive)) {
 				if (accessor->bufferView) {
+					// min and max are still required once the data is gone
+					if (accessor->minMaxDeferred) {
+						accessor->computeMinMax();
+					}
 					delete accessor->bufferView;
 					accessor->bufferView = NULL;
 				}
 			}
 			GLTF::Accessor* indicesAccessor = primitive->indices;
 			if (indicesAccessor != NULL && indicesAccessor->bufferView) {
+				if (indicesAccessor->minMaxDeferred) {
+					indicesAccessor->computeMinMax();
+				}
 				delete indicesAccessor->bufferView;
 				indicesAccessor->bufferView = NULL;
 			}
@@ -415,6 +343,7 @@ void GLTF::Asset::removeUncompressedBufferViews() {
 }
 
 void GLTF::Asset::removeUnusedSemantics() {
+	GLTF::Arena::Scope scope(&arena);
 	for (GLTF::Primitive* primitive : getAllPrimitives()) {
 		GLTF::Material* material = primitive->material;
 		if (material != NULL) {
@@ -441,9 +370,11 @@ void GLTF::Asset::removeUnusedSemantics() {
 			}
 		}
 	}
+	invalidate();
 }
 
 void GLTF::Asset::removeAttributeFromDracoExtension(GLTF::Primitive* primitive, const std::string &semantic) {
+	GLTF::Arena::Scope scope(&arena);
 	auto extensionPtr = primitive->extensions.find("KHR_draco_mesh_compression");
 	if (extensionPtr != primitive->extensions.end()) {
 		GLTF::DracoExtension* dracoExtension = (GLTF::DracoExtension*)extensionPtr->second;
@@ -458,10 +389,471 @@ void GLTF::Asset::removeAttributeFromDracoExtension(GLTF::Primitive* primitive,
 	}
 }
 
-bool isUnusedNode(GLTF::Node* node, std::set<GLTF::Node*> skinNodes, bool isPbr) {
+struct ReadIndicesVisitor {
+	std::vector<unsigned int>* indices;
+
+	template <typename T, int N>
+	void operator()(const GLTF::AccessorView<T, N>& view) {
+		for (int i = 0; i < view.count; i++) {
+			(*indices)[i] = (unsigned int)view[i][0];
+		}
+	}
+};
+
+struct WriteIndicesVisitor {
+	const std::vector<unsigned int>* indices;
+
+	template <typename T, int N>
+	void operator()(const GLTF::AccessorView<T, N>& view) {
+		for (int i = 0; i < view.count; i++) {
+			view[i][0] = (T)(*indices)[i];
+		}
+	}
+};
+
+std::vector<unsigned int> readIndices(GLTF::Accessor* accessor) {
+	std::vector<unsigned int> indices(accessor->count);
+	ReadIndicesVisitor visitor;
+	visitor.indices = &indices;
+	GLTF::visitAccessor(accessor, visitor);
+	return indices;
+}
+
+void writeIndices(GLTF::Accessor* accessor, const std::vector<unsigned int>& indices) {
+	WriteIndicesVisitor visitor;
+	visitor.indices = &indices;
+	GLTF::visitAccessor(accessor, visitor);
+}
+
+/**
+ * Reorders the triangles of every TRIANGLES primitive for post-transform vertex cache locality,
+ * printing the ACMR (average cache miss ratio) of each primitive before and after.
+ *
+ * Draco compressed primitives are skipped since the extension encodes its own connectivity, and
+ * indices accessors shared between primitives are reordered once.
+ */
+void GLTF::Asset::optimizeVertexCache() {
+	GLTF::Arena::Scope scope(&arena);
+	// Vertex cache size assumed by the optimization and the reported ACMR
+	const unsigned int cacheSize = 16;
+	std::set<GLTF::Accessor*> optimized;
+	for (GLTF::Mesh* mesh : getAllMeshes()) {
+		for (size_t i = 0; i < mesh->primitives.size(); i++) {
+			GLTF::Primitive* primitive = mesh->primitives[i];
+			GLTF::Accessor* indicesAccessor = primitive->indices;
+			if (primitive->mode != GLTF::Primitive::Mode::TRIANGLES || indicesAccessor == NULL || indicesAccessor->bufferView == NULL) {
+				continue;
+			}
+			if (primitive->extensions.find("KHR_draco_mesh_compression") != primitive->extensions.end()) {
+				continue;
+			}
+			if (!optimized.insert(indicesAccessor).second) {
+				continue;
+			}
+			std::vector<unsigned int> indices = readIndices(indicesAccessor);
+			if (indices.empty()) {
+				continue;
+			}
+			size_t vertexCount = *std::max_element(indices.begin(), indices.end()) + 1;
+			float before = MeshOptimizer::computeACMR(indices, vertexCount, cacheSize);
+			MeshOptimizer::optimizeVertexCache(indices, vertexCount, cacheSize);
+			float after = MeshOptimizer::computeACMR(indices, vertexCount, cacheSize);
+			writeIndices(indicesAccessor, indices);
+			std::cout << "Vertex cache: mesh '" << mesh->name << "' primitive " << i << " ACMR " << before << " -> " << after << std::endl;
+		}
+	}
+}
+
+bool isOpaque(GLTF::Material* material) {
+	if (material == NULL) {
+		return true;
+	}
+	if (material->type == GLTF::Material::PBR_METALLIC_ROUGHNESS && ((GLTF::MaterialPBR*)material)->alphaMode == "BLEND") {
+		return false;
+	}
+	if (material->type == GLTF::Material::MATERIAL_COMMON && ((GLTF::MaterialCommon*)material)->transparent) {
+		return false;
+	}
+	if (material->values != NULL && material->values->transparency != NULL && material->values->transparency[0] < 1) {
+		return false;
+	}
+	return true;
+}
+
+/**
+ * Reorders clusters of triangles in every opaque TRIANGLES primitive so that the ones likely to occlude
+ * the rest of the mesh are drawn first. Run after `optimizeVertexCache`, `threshold` bounds how much the
+ * vertex cache efficiency may degrade. Prints the estimated overdraw and ACMR of each primitive before
+ * and after.
+ *
+ * Blended primitives are skipped because their draw order is visible, as are Draco compressed primitives.
+ *
+ * @param threshold The allowed ratio between the ACMR of a cluster and the ACMR of the input order
+ */
+void GLTF::Asset::optimizeOverdraw(float threshold) {
+	GLTF::Arena::Scope scope(&arena);
+	const unsigned int cacheSize = 16;
+	std::set<GLTF::Accessor*> optimized;
+	for (GLTF::Mesh* mesh : getAllMeshes()) {
+		for (size_t i = 0; i < mesh->primitives.size(); i++) {
+			GLTF::Primitive* primitive = mesh->primitives[i];
+			GLTF::Accessor* indicesAccessor = primitive->indices;
+			if (primitive->mode != GLTF::Primitive::Mode::TRIANGLES || indicesAccessor == NULL || indicesAccessor->bufferView == NULL) {
+				continue;
+			}
+			if (primitive->extensions.find("KHR_draco_mesh_compression") != primitive->extensions.end() || !isOpaque(primitive->material)) {
+				continue;
+			}
+			std::map<std::string, GLTF::Accessor*>::iterator findPosition = primitive->attributes.find("POSITION");
+			if (findPosition == primitive->attributes.end()) {
+				continue;
+			}
+			GLTF::Accessor* positionAccessor = findPosition->second;
+			if (positionAccessor->bufferView == NULL || positionAccessor->type != GLTF::Accessor::Type::VEC3 || positionAccessor->componentType != GLTF::Constants::WebGL::FLOAT) {
+				continue;
+			}
+			if (!optimized.insert(indicesAccessor).second) {
+				continue;
+			}
+			std::vector<unsigned int> indices = readIndices(indicesAccessor);
+			size_t vertexCount = positionAccessor->count;
+			if (indices.empty() || *std::max_element(indices.begin(), indices.end()) >= vertexCount) {
+				continue;
+			}
+			std::vector<float> positions(vertexCount * 3);
+			GLTF::AccessorView<float, 3> positionView(positionAccessor);
+			for (size_t vertex = 0; vertex < vertexCount; vertex++) {
+				float* position = positionView[(int)vertex];
+				positions[vertex * 3] = position[0];
+				positions[vertex * 3 + 1] = position[1];
+				positions[vertex * 3 + 2] = position[2];
+			}
+			float overdrawBefore = MeshOptimizer::computeOverdraw(indices, &positions[0], vertexCount);
+			float acmrBefore = MeshOptimizer::computeACMR(indices, vertexCount, cacheSize);
+			MeshOptimizer::optimizeOverdraw(indices, &positions[0], vertexCount, cacheSize, threshold);
+			float overdrawAfter = MeshOptimizer::computeOverdraw(indices, &positions[0], vertexCount);
+			float acmrAfter = MeshOptimizer::computeACMR(indices, vertexCount, cacheSize);
+			writeIndices(indicesAccessor, indices);
+			std::cout << "Overdraw: mesh '" << mesh->name << "' primitive " << i << " overdraw " << overdrawBefore << " -> " << overdrawAfter << ", ACMR " << acmrBefore << " -> " << acmrAfter << std::endl;
+		}
+	}
+}
+
+struct RemapVisitor {
+	const std::vector<unsigned int>* remap;
+
+	template <typename T, int N>
+	void operator()(const GLTF::AccessorView<T, N>& view) {
+		std::vector<T> original(view.count * N);
+		for (int i = 0; i < view.count; i++) {
+			T* element = view[i];
+			for (int j = 0; j < N; j++) {
+				original[i * N + j] = element[j];
+			}
+		}
+		for (int i = 0; i < view.count; i++) {
+			T* element = view[(*remap)[i]];
+			for (int j = 0; j < N; j++) {
+				element[j] = original[i * N + j];
+			}
+		}
+	}
+};
+
+/**
+ * Moves each element of an accessor to the index given by `remap`.
+ */
+void remapAccessor(GLTF::Accessor* accessor, const std::vector<unsigned int>& remap) {
+	RemapVisitor visitor;
+	visitor.remap = &remap;
+	GLTF::visitAccessor(accessor, visitor);
+}
+
+/**
+ * Renumbers the vertices of every indexed primitive in the order of first use by its indices, so
+ * attribute fetches walk memory sequentially. Run after `optimizeVertexCache` to follow the new
+ * triangle order.
+ *
+ * Every attribute of the primitive is permuted, including joints, weights and morph target attributes.
+ * Primitives sharing their indices accessor with clones are remapped once. Primitives that share an
+ * attribute accessor with a primitive using different indices, and Draco compressed primitives, are skipped.
+ */
+void GLTF::Asset::optimizeVertexFetch() {
+	GLTF::Arena::Scope scope(&arena);
+	std::vector<GLTF::Primitive*> primitives = getAllPrimitives();
+	std::map<GLTF::Accessor*, std::vector<GLTF::Accessor*>> vertexAccessors;
+	std::map<GLTF::Accessor*, GLTF::Accessor*> attributeIndices;
+	std::set<GLTF::Accessor*> skipped;
+	for (GLTF::Primitive* primitive : primitives) {
+		GLTF::Accessor* indices = primitive->indices;
+		if (indices == NULL) {
+			continue;
+		}
+		if (primitive->extensions.find("KHR_draco_mesh_compression") != primitive->extensions.end()) {
+			skipped.insert(indices);
+			continue;
+		}
+		std::vector<GLTF::Accessor*> accessors;
+		for (const auto& attribute : primitive->attributes) {
+			accessors.push_back(attribute.second);
+		}
+		for (GLTF::Primitive::Target* target : primitive->targets) {
+			for (const auto& attribute : target->attributes) {
+				accessors.push_back(attribute.second);
+			}
+		}
+		for (GLTF::Accessor* accessor : accessors) {
+			std::map<GLTF::Accessor*, GLTF::Accessor*>::iterator owner = attributeIndices.find(accessor);
+			if (owner == attributeIndices.end()) {
+				attributeIndices[accessor] = indices;
+				vertexAccessors[indices].push_back(accessor);
+			}
+			else if (owner->second != indices) {
+				skipped.insert(indices);
+				skipped.insert(owner->second);
+			}
+		}
+	}
+
+	for (const auto& entry : vertexAccessors) {
+		GLTF::Accessor* indicesAccessor = entry.first;
+		const std::vector<GLTF::Accessor*>& accessors = entry.second;
+		if (skipped.find(indicesAccessor) != skipped.end() || indicesAccessor->bufferView == NULL || accessors.empty()) {
+			continue;
+		}
+		int vertexCount = accessors[0]->count;
+		bool valid = true;
+		for (GLTF::Accessor* accessor : accessors) {
+			if (accessor->count != vertexCount || accessor->bufferView == NULL) {
+				valid = false;
+			}
+		}
+		std::vector<unsigned int> indices = readIndices(indicesAccessor);
+		if (!valid || indices.empty() || *std::max_element(indices.begin(), indices.end()) >= (unsigned int)vertexCount) {
+			continue;
+		}
+		std::vector<unsigned int> remap = MeshOptimizer::optimizeVertexFetch(indices, vertexCount);
+		writeIndices(indicesAccessor, indices);
+		for (GLTF::Accessor* accessor : accessors) {
+			remapAccessor(accessor, remap);
+		}
+	}
+}
+
+/**
+ * Creates an attribute accessor holding quantized copies of the elements of a FLOAT accessor.
+ *
+ * @param accessor The FLOAT accessor to quantize, with N components.
+ * @param componentType The integer component type of the new accessor, matching T.
+ * @param normalized Whether the integer values are normalized.
+ * @param quantize Converts the components of one element in place to integer values.
+ * @param deferMinMax Whether min and max of the new accessor are left to writeJSON.
+ * @return The quantized accessor.
+ */
+template <typename T, int N>
+GLTF::Accessor* quantizeAccessor(GLTF::Accessor* accessor, GLTF::Constants::WebGL componentType, bool normalized, std::function<void(float*)> quantize, bool deferMinMax) {
+	std::vector<T> data(accessor->count * N);
+	GLTF::AccessorView<float, N> source(accessor);
+	float component[N];
+	for (int i = 0; i < accessor->count; i++) {
+		float* element = source[i];
+		for (int j = 0; j < N; j++) {
+			component[j] = element[j];
+		}
+		quantize(component);
+		for (int j = 0; j < N; j++) {
+			data[i * N + j] = (T)component[j];
+		}
+	}
+	GLTF::Accessor* quantized = new GLTF::Accessor(accessor->type, componentType, (unsigned char*)data.data(), accessor->count, GLTF::Constants::WebGL::ARRAY_BUFFER, deferMinMax);
+	quantized->normalized = normalized;
+	return quantized;
+}
+
+/**
+ * Quantizes a value in [-1, 1] to `bits` of precision, scaled to a normalized BYTE.
+ */
+float quantizeSnormByte(float value, int bits) {
+	float range = (float)((1 << (bits - 1)) - 1);
+	float quantized = std::round(std::max(-1.0f, std::min(1.0f, value)) * range);
+	return std::round(quantized * 127.0f / range);
+}
+
+/**
+ * Quantizes a value in [0, 1] to `bits` of precision, scaled to a normalized UNSIGNED_SHORT.
+ */
+float quantizeUnormShort(float value, int bits) {
+	float range = (float)((1 << bits) - 1);
+	float quantized = std::round(std::max(0.0f, std::min(1.0f, value)) * range);
+	return std::round(quantized * 65535.0f / range);
+}
+
+/**
+ * Stores mesh attributes as integers using KHR_mesh_quantization.
+ *
+ * POSITION becomes SHORT, centered on the bounds of the mesh and scaled uniformly so the largest axis
+ * uses `positionQuantizationBits`. The dequantization is applied by a child node holding the mesh, added
+ * under every node that references it. Skinned and morphed meshes keep their float positions.
+ * NORMAL and TANGENT become normalized BYTE with at most 8 bits of precision, and TEXCOORD sets
+ * within [0, 1] become normalized UNSIGNED_SHORT. Draco compressed primitives are skipped.
+ */
+void GLTF::Asset::quantizeMeshes(GLTF::Options* options) {
+	GLTF::Arena::Scope scope(&arena);
+	int positionBits = std::max(2, std::min(16, options->positionQuantizationBits));
+	int normalBits = std::max(2, std::min(8, options->normalQuantizationBits));
+	int texcoordBits = std::max(1, std::min(16, options->texcoordQuantizationBits));
+
+	std::map<GLTF::Mesh*, std::vector<GLTF::Node*>> meshNodes;
+	for (GLTF::Node* node : getAllNodes()) {
+		if (node->mesh != NULL) {
+			meshNodes[node->mesh].push_back(node);
+		}
+	}
+
+	std::map<GLTF::Accessor*, GLTF::Accessor*> quantizedAccessors;
+	bool quantized = false;
+	for (GLTF::Mesh* mesh : getAllMeshes()) {
+		std::vector<GLTF::Primitive*> primitives;
+		for (GLTF::Primitive* primitive : mesh->primitives) {
+			if (primitive->extensions.find("KHR_draco_mesh_compression") == primitive->extensions.end()) {
+				primitives.push_back(primitive);
+			}
+		}
+
+		for (GLTF::Primitive* primitive : primitives) {
+			for (auto& attribute : primitive->attributes) {
+				const std::string& semantic = attribute.first;
+				GLTF::Accessor* accessor = attribute.second;
+				if (accessor->componentType != GLTF::Constants::WebGL::FLOAT || accessor->bufferView == NULL) {
+					continue;
+				}
+				std::map<GLTF::Accessor*, GLTF::Accessor*>::iterator findQuantized = quantizedAccessors.find(accessor);
+				if (findQuantized != quantizedAccessors.end()) {
+					attribute.second = findQuantized->second;
+					continue;
+				}
+				GLTF::Accessor* quantizedAccessor = NULL;
+				if (semantic == "NORMAL" && accessor->type == GLTF::Accessor::Type::VEC3) {
+					quantizedAccessor = quantizeAccessor<signed char, 3>(accessor, GLTF::Constants::WebGL::BYTE, true, [&](float* component) {
+						for (int i = 0; i < 3; i++) {
+							component[i] = quantizeSnormByte(component[i], normalBits);
+						}
+					}, options->deferMinMax);
+				}
+				else if (semantic == "TANGENT" && accessor->type == GLTF::Accessor::Type::VEC4) {
+					quantizedAccessor = quantizeAccessor<signed char, 4>(accessor, GLTF::Constants::WebGL::BYTE, true, [&](float* component) {
+						for (int i = 0; i < 3; i++) {
+							component[i] = quantizeSnormByte(component[i], normalBits);
+						}
+						component[3] = component[3] < 0 ? -127.0f : 127.0f;
+					}, options->deferMinMax);
+				}
+				else if (semantic.find("TEXCOORD") == 0 && accessor->type == GLTF::Accessor::Type::VEC2) {
+					accessor->computeMinMax();
+					if (accessor->count == 0 || accessor->min[0] < 0 || accessor->min[1] < 0 || accessor->max[0] > 1 || accessor->max[1] > 1) {
+						continue;
+					}
+					quantizedAccessor = quantizeAccessor<unsigned short, 2>(accessor, GLTF::Constants::WebGL::UNSIGNED_SHORT, true, [&](float* component) {
+						component[0] = quantizeUnormShort(component[0], texcoordBits);
+						component[1] = quantizeUnormShort(component[1], texcoordBits);
+					}, options->deferMinMax);
+				}
+				if (quantizedAccessor != NULL) {
+					quantizedAccessors[accessor] = quantizedAccessor;
+					attribute.second = quantizedAccessor;
+					quantized = true;
+				}
+			}
+		}
+
+		// Positions share one dequantization transform across the mesh.
+		bool canQuantizePositions = primitives.size() == mesh->primitives.size() && meshNodes[mesh].size() > 0;
+		float min[3] = { 0, 0, 0 };
+		float max[3] = { 0, 0, 0 };
+		bool hasBounds = false;
+		for (GLTF::Primitive* primitive : primitives) {
+			auto findPosition = primitive->attributes.find("POSITION");
+			if (findPosition == primitive->attributes.end() || primitive->targets.size() > 0 || primitive->attributes.find("JOINTS_0") != primitive->attributes.end()) {
+				canQuantizePositions = false;
+				break;
+			}
+			GLTF::Accessor* position = findPosition->second;
+			if (position->componentType != GLTF::Constants::WebGL::FLOAT || position->type != GLTF::Accessor::Type::VEC3 || position->bufferView == NULL) {
+				canQuantizePositions = false;
+				break;
+			}
+			position->computeMinMax();
+			if (position->count == 0) {
+				continue;
+			}
+			for (int i = 0; i < 3; i++) {
+				float positionMin = (float)position->min[i];
+				float positionMax = (float)position->max[i];
+				min[i] = hasBounds ? std::min(min[i], positionMin) : positionMin;
+				max[i] = hasBounds ? std::max(max[i], positionMax) : positionMax;
+			}
+			hasBounds = true;
+		}
+		for (GLTF::Node* node : meshNodes[mesh]) {
+			if (node->skin != NULL) {
+				canQuantizePositions = false;
+			}
+		}
+		if (!canQuantizePositions || !hasBounds) {
+			continue;
+		}
+
+		float center[3];
+		float extent = 0;
+		for (int i = 0; i < 3; i++) {
+			center[i] = (min[i] + max[i]) / 2;
+			extent = std::max(extent, (max[i] - min[i]) / 2);
+		}
+		float range = (float)((1 << (positionBits - 1)) - 1);
+		float scale = extent > 0 ? range / extent : 1;
+		std::map<GLTF::Accessor*, GLTF::Accessor*> quantizedPositions;
+		for (GLTF::Primitive* primitive : primitives) {
+			GLTF::Accessor* position = primitive->attributes["POSITION"];
+			std::map<GLTF::Accessor*, GLTF::Accessor*>::iterator findQuantized = quantizedPositions.find(position);
+			if (findQuantized == quantizedPositions.end()) {
+				quantizedPositions[position] = quantizeAccessor<short, 3>(position, GLTF::Constants::WebGL::SHORT, false, [&](float* component) {
+					for (int i = 0; i < 3; i++) {
+						component[i] = std::max(-range, std::min(range, std::round((component[i] - center[i]) * scale)));
+					}
+				}, options->deferMinMax);
+			}
+			primitive->attributes["POSITION"] = quantizedPositions[position];
+		}
+
+		GLTF::Node::TransformTRS* dequantize = new GLTF::Node::TransformTRS();
+		for (int i = 0; i < 3; i++) {
+			dequantize->translation[i] = center[i];
+			dequantize->scale[i] = 1 / scale;
+		}
+		dequantize->rotation[0] = 0;
+		dequantize->rotation[1] = 0;
+		dequantize->rotation[2] = 0;
+		dequantize->rotation[3] = 1;
+		for (GLTF::Node* node : meshNodes[mesh]) {
+			GLTF::Node* meshNode = new GLTF::Node();
+			meshNode->transform = dequantize;
+			meshNode->mesh = mesh;
+			node->mesh = NULL;
+			node->children.push_back(meshNode);
+		}
+		quantized = true;
+	}
+
+	if (quantized) {
+		requireExtension("KHR_mesh_quantization");
+	}
+	invalidate();
+}
+
+bool isUnusedNode(GLTF::Node* node, const std::unordered_set<GLTF::Node*>& skinNodes, bool isPbr) {
 	if (node->children.size() == 0 && node->mesh == NULL && node->camera == NULL && node->skin == NULL) {
 		if (isPbr || node->light == NULL || node->light->type == GLTF::MaterialCommon::Light::AMBIENT) {
-			if (std::find(skinNodes.begin(), skinNodes.end(), node) == skinNodes.end()) {
+			if (skinNodes.find(node) == skinNodes.end()) {
 				return true;
 			}
 		}
@@ -469,9 +861,56 @@ bool isUnusedNode(GLTF::Node* node, std::set<GLTF::Node*> skinNodes, bool isPbr)
 	return false;
 }
 
+/**
+ * Removes the unused descendants of `root` in a single post-order sweep. The children of a node are
+ * swept and compacted before the node itself is checked, so parents left without children are
+ * removed in the same sweep.
+ *
+ * @param used Whether each swept node is used, shared between sweeps so shared subtrees are swept once
+ * @param removedLights Receives the lights of removed nodes
+ * @return `true` if `root` is used
+ */
+bool sweepUnusedNodes(GLTF::Node* root, const std::unordered_set<GLTF::Node*>& skinNodes, bool isPbr, std::unordered_map<GLTF::Node*, bool>& used, std::vector<GLTF::MaterialCommon::Light*>& removedLights) {
+	std::unordered_map<GLTF::Node*, bool>::iterator findRoot = used.find(root);
+	if (findRoot != used.end()) {
+		return findRoot->second;
+	}
+	// Nodes are treated as used until their sweep completes, so cycles terminate
+	used[root] = true;
+	std::vector<std::pair<GLTF::Node*, size_t>> stack;
+	stack.push_back(std::make_pair(root, 0));
+	while (stack.size() > 0) {
+		GLTF::Node* node = stack.back().first;
+		size_t childIndex = stack.back().second;
+		if (childIndex < node->children.size()) {
+			stack.back().second++;
+			GLTF::Node* child = node->children[childIndex];
+			if (used.insert(std::make_pair(child, true)).second) {
+				stack.push_back(std::make_pair(child, 0));
+			}
+			continue;
+		}
+		stack.pop_back();
+
+		size_t usedCount = 0;
+		for (GLTF::Node* child : node->children) {
+			if (used[child]) {
+				node->children[usedCount++] = child;
+			}
+		}
+		node->children.resize(usedCount);
+		bool nodeUsed = !isUnusedNode(node, skinNodes, isPbr);
+		used[node] = nodeUsed;
+		if (!nodeUsed && node->light != NULL) {
+			removedLights.push_back(node->light);
+		}
+	}
+	return used[root];
+}
+
 void GLTF::Asset::removeUnusedNodes(GLTF::Options* options) {
-	std::vector<GLTF::Node*> nodeStack;
-	std::set<GLTF::Node*> skinNodes;
+	GLTF::Arena::Scope scope(&arena);
+	std::unordered_set<GLTF::Node*> skinNodes;
 	bool isPbr = !options->glsl && !options->materialsCommon;
 	for (GLTF::Skin* skin : getAllSkins()) {
 		if (skin->skeleton != NULL) {
@@ -482,53 +921,58 @@ void GLTF::Asset::removeUnusedNodes(GLTF::Options* options) {
 		}
 	}
 
-	GLTF::Scene* defaultScene = getDefaultScene();
-	bool needsPass = true;
-	while (needsPass) {
-		needsPass = false;
-		for (size_t i = 0; i < defaultScene->nodes.size(); i++) {
-			GLTF::Node* node = defaultScene->nodes[i];
-			if (isUnusedNode(node, skinNodes, isPbr)) {
-				// Nodes associated with ambient lights may be optimized out,
-				// but we should hang on to the lights so that they are 
-				// still written into the shader or common materials object.
-				if (node->light != NULL) {
-					_ambientLights.push_back(node->light);
-				}
-				defaultScene->nodes.erase(defaultScene->nodes.begin() + i);
-				i--;
-			}
-			else {
-				nodeStack.push_back(node);
-			}
-		}
-		while (nodeStack.size() > 0) {
-			GLTF::Node* node = nodeStack.back();
-			nodeStack.pop_back();
-			for (size_t i = 0; i < node->children.size(); i++) {
-				GLTF::Node* child = node->children[i];
-				if (isUnusedNode(child, skinNodes, isPbr)) {
-					if (child->light != NULL) {
-						_ambientLights.push_back(child->light);
-					}
-					// this node is extraneous, remove it
-					node->children.erase(node->children.begin() + i);
-					i--;
-					if (node->children.size() == 0) {
-						// another pass may be required to clean up the parent
-						needsPass = true;
-					}
-				}
-				else {
-					nodeStack.push_back(child);
-				}
-			}
+	// Nodes associated with ambient lights may be optimized out,
+	// but we should hang on to the lights so that they are
+	// still written into the shader or common materials object.
+	std::unordered_map<GLTF::Node*, bool> used;
+	std::vector<GLTF::Node*>& nodes = getDefaultScene()->nodes;
+	size_t usedCount = 0;
+	for (GLTF::Node* node : nodes) {
+		if (sweepUnusedNodes(node, skinNodes, isPbr, used, _ambientLights)) {
+			nodes[usedCount++] = node;
 		}
 	}
+	nodes.resize(usedCount);
+	invalidate();
+}
+
+/**
+ * Adds the elements of an accessor to a layout entry and points the accessor at the entry's bufferView.
+ *
+ * @param layout The layout the entry belongs to.
+ * @param entry The entry receiving the elements.
+ * @param accessor The accessor to move.
+ * @param byteOffset The offset of the first element in the entry's bufferView.
+ */
+void addAccessorSource(GLTF::BufferLayout* layout, GLTF::BufferLayout::Entry& entry, GLTF::Accessor* accessor, size_t byteOffset) {
+	// Deferred bounds are computed while the source data is still reachable through the accessor
+	if (accessor->minMaxDeferred) {
+		accessor->computeMinMax();
+	}
+	GLTF::BufferLayout::Source source;
+	source.accessor = accessor;
+	source.data = accessor->bufferView->buffer->data + accessor->bufferView->byteOffset + accessor->byteOffset;
+	source.byteStride = accessor->getByteStride();
+	source.byteOffset = byteOffset;
+	entry.sources.push_back(source);
+	layout->sourceBuffers.insert(accessor->bufferView->buffer);
+	accessor->bufferView = entry.bufferView;
+	accessor->byteOffset = byteOffset;
 }
 
-GLTF::BufferView* packAccessorsForTargetByteStride(std::vector<GLTF::Accessor*> accessors, GLTF::Constants::WebGL target, size_t byteStride) {
-	std::map<GLTF::Accessor*, size_t> byteOffsets;
+GLTF::BufferLayout::Entry createLayoutEntry(GLTF::BufferLayout* layout, GLTF::Constants::WebGL target, size_t byteStride) {
+	GLTF::BufferLayout::Entry entry;
+	entry.bufferView = new GLTF::BufferView(0, 0, layout->buffer);
+	entry.bufferView->target = target;
+	if (target == GLTF::Constants::WebGL::ARRAY_BUFFER) {
+		entry.bufferView->byteStride = byteStride;
+	}
+	entry.byteStride = byteStride;
+	return entry;
+}
+
+GLTF::BufferLayout::Entry planAccessorsForTargetByteStride(GLTF::BufferLayout* layout, std::vector<GLTF::Accessor*> accessors, GLTF::Constants::WebGL target, size_t byteStride) {
+	GLTF::BufferLayout::Entry entry = createLayoutEntry(layout, target, byteStride);
 	size_t byteLength = 0;
 	for (GLTF::Accessor* accessor : accessors) {
 		int componentByteLength = accessor->getComponentByteLength();
@@ -536,157 +980,469 @@ GLTF::BufferView* packAccessorsForTargetByteStride(std::vector<GLTF::Accessor*>
 		if (padding != 0) {
 			byteLength += (componentByteLength - padding);
 		}
-		byteOffsets[accessor] = byteLength;
-		byteLength += componentByteLength * accessor->getNumberOfComponents() * accessor->count;
+		int elementLength = componentByteLength * accessor->getNumberOfComponents();
+		addAccessorSource(layout, entry, accessor, byteLength);
+		if (accessor->count > 0) {
+			byteLength += byteStride * (accessor->count - 1) + elementLength;
+		}
 	}
-	unsigned char* bufferData = new unsigned char[byteLength];
-	GLTF::BufferView* bufferView = new GLTF::BufferView(bufferData, byteLength, target);
+	entry.bufferView->byteLength = byteLength;
+	return entry;
+}
+
+/**
+ * Plans interleaved bufferViews for the vertex attributes of a primitive. Attributes are laid out in
+ * semantic order, each aligned to 4 bytes, and a new bufferView is started whenever the element would
+ * exceed the maximum byteStride.
+ *
+ * @param layout The layout receiving the entries.
+ * @param accessors The attribute accessors of the primitive, all with the same count.
+ * @param maxByteStride The largest byteStride allowed by the output version.
+ * @return The interleaved entries, empty if the attributes cannot be interleaved.
+ */
+std::vector<GLTF::BufferLayout::Entry> planInterleavedAccessors(GLTF::BufferLayout* layout, std::vector<GLTF::Accessor*> accessors, int maxByteStride) {
+	std::vector<std::vector<GLTF::Accessor*>> groups;
+	std::vector<int> byteStrides;
+	std::map<GLTF::Accessor*, int> byteOffsets;
 	for (GLTF::Accessor* accessor : accessors) {
-		size_t byteOffset = byteOffsets[accessor];
-		GLTF::Accessor* packedAccessor = new GLTF::Accessor(accessor->type, accessor->componentType, byteOffset, accessor->count, bufferView);
-		int numberOfComponents = accessor->getNumberOfComponents();
-		float* component = new float[numberOfComponents];
-		for (int i = 0; i < accessor->count; i++) {
-			accessor->getComponentAtIndex(i, component);
-			packedAccessor->writeComponentAtIndex(i, component);
-		}
-		accessor->byteOffset = packedAccessor->byteOffset;
-		accessor->bufferView = packedAccessor->bufferView;
-	}
-	return bufferView;
+		int elementLength = accessor->getNumberOfComponents() * accessor->getComponentByteLength();
+		int alignedLength = (elementLength + 3) & ~3;
+		if (alignedLength > maxByteStride) {
+			return std::vector<GLTF::BufferLayout::Entry>();
+		}
+		if (groups.empty() || byteStrides.back() + alignedLength > maxByteStride) {
+			groups.push_back(std::vector<GLTF::Accessor*>());
+			byteStrides.push_back(0);
+		}
+		byteOffsets[accessor] = byteStrides.back();
+		byteStrides.back() += alignedLength;
+		groups.back().push_back(accessor);
+	}
+
+	std::vector<GLTF::BufferLayout::Entry> entries;
+	for (size_t i = 0; i < groups.size(); i++) {
+		GLTF::BufferLayout::Entry entry = createLayoutEntry(layout, GLTF::Constants::WebGL::ARRAY_BUFFER, byteStrides[i]);
+		entry.bufferView->byteLength = byteStrides[i] * groups[i][0]->count;
+		for (GLTF::Accessor* accessor : groups[i]) {
+			addAccessorSource(layout, entry, accessor, byteOffsets[accessor]);
+		}
+		entries.push_back(entry);
+	}
+	return entries;
+}
+
+class DracoEncodeResult {
+public:
+	bool ok = false;
+	std::string error;
+	unsigned char* data = NULL;
+	size_t length = 0;
+	double encodeMilliseconds = 0;
+};
+
+void encodeDracoMesh(draco::Mesh* dracoMesh, const GLTF::DracoExtension::Settings& settings, DracoEncodeResult& result) {
+	draco::Encoder encoder;
+	encoder.SetAttributeQuantization(draco::GeometryAttribute::POSITION, settings.positionQuantizationBits);
+	encoder.SetAttributeQuantization(draco::GeometryAttribute::TEX_COORD, settings.texcoordQuantizationBits);
+	encoder.SetAttributeQuantization(draco::GeometryAttribute::NORMAL, settings.normalQuantizationBits);
+	encoder.SetAttributeQuantization(draco::GeometryAttribute::COLOR, settings.colorQuantizationBits);
+	encoder.SetAttributeQuantization(draco::GeometryAttribute::GENERIC, settings.genericQuantizationBits);
+	if (settings.encodeSpeed >= 0 || settings.decodeSpeed >= 0) {
+		encoder.SetSpeedOptions(settings.encodeSpeed, settings.decodeSpeed);
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	draco::EncoderBuffer buffer;
+	draco::Status status;
+	if (settings.geometry == GLTF::DracoExtension::Settings::Geometry::MESH) {
+		status = encoder.EncodeMeshToBuffer(*dracoMesh, &buffer);
+	}
+	else {
+		if (settings.geometry == GLTF::DracoExtension::Settings::Geometry::ORDERED_POINT_CLOUD) {
+			// The kd-tree encoding sorts points spatially
+			encoder.SetEncodingMethod(draco::POINT_CLOUD_SEQUENTIAL_ENCODING);
+		}
+		status = encoder.EncodePointCloudToBuffer(*dracoMesh, &buffer);
+	}
+	result.encodeMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	if (!status.ok()) {
+		result.error = status.error_msg_string();
+		return;
+	}
+	result.data = (unsigned char*)malloc(buffer.size());
+	std::memcpy(result.data, buffer.data(), buffer.size());
+	result.length = buffer.size();
+	result.ok = true;
+}
+
+/**
+ * Draco quantizes an attribute over the largest extent of its bounding box and rounds values to the
+ * nearest step, so the error is at most half a step.
+ *
+ * @return The fewest quantization bits keeping the error of values spanning `range` within `error`.
+ */
+int quantizationBitsForError(float range, float error) {
+	if (range <= 0) {
+		return 1;
+	}
+	int bits = (int)std::ceil(std::log2(range / (2 * error) + 1));
+	return std::max(1, std::min(bits, 30));
+}
+
+float largestExtent(GLTF::Accessor* accessor) {
+	float extent = 0;
+	if (accessor->min != NULL && accessor->max != NULL) {
+		for (int j = 0; j < accessor->getNumberOfComponents(); j++) {
+			extent = std::max(extent, (float)(accessor->max[j] - accessor->min[j]));
+		}
+	}
+	return extent;
+}
+
+/**
+ * Picks the encoder settings of a primitive. With an error budget, each attribute type gets the
+ * fewest bits that keep its error in budget, using the bounds of its accessors, otherwise the
+ * global quantization bits are used.
+ */
+GLTF::DracoExtension::Settings chooseDracoSettings(GLTF::Primitive* primitive, GLTF::Options* options) {
+	GLTF::DracoExtension::Settings settings;
+	if (primitive->mode == GLTF::Primitive::Mode::POINTS) {
+		settings.geometry = GLTF::DracoExtension::Settings::Geometry::POINT_CLOUD;
+	}
+	else if (primitive->mode == GLTF::Primitive::Mode::LINES || primitive->mode == GLTF::Primitive::Mode::LINE_LOOP || primitive->mode == GLTF::Primitive::Mode::LINE_STRIP) {
+		// Lines are drawn from consecutive points, see COLLADA2GLTF::Writer::writeMeshPrimitive
+		settings.geometry = GLTF::DracoExtension::Settings::Geometry::ORDERED_POINT_CLOUD;
+	}
+	settings.positionQuantizationBits = options->positionQuantizationBits;
+	settings.normalQuantizationBits = options->normalQuantizationBits;
+	settings.texcoordQuantizationBits = options->texcoordQuantizationBits;
+	settings.colorQuantizationBits = options->colorQuantizationBits;
+	settings.genericQuantizationBits = options->jointQuantizationBits;
+	settings.encodeSpeed = options->dracoEncodeSpeed;
+	settings.decodeSpeed = options->dracoDecodeSpeed;
+	if (options->dracoMaxError <= 0 && options->dracoMaxRelativeError <= 0) {
+		return settings;
+	}
+
+	std::set<int*> chosen;
+	for (const auto& attribute : primitive->attributes) {
+		const std::string& semantic = attribute.first;
+		GLTF::Accessor* accessor = attribute.second;
+		if (semantic.find("JOINTS") == 0) {
+			// Joint indices are integers, Draco stores them losslessly
+			continue;
+		}
+		int* bits = &settings.genericQuantizationBits;
+		if (semantic == "POSITION") {
+			bits = &settings.positionQuantizationBits;
+		}
+		else if (semantic == "NORMAL") {
+			bits = &settings.normalQuantizationBits;
+		}
+		else if (semantic.find("TEXCOORD") == 0) {
+			bits = &settings.texcoordQuantizationBits;
+		}
+		else if (semantic.find("COLOR") == 0) {
+			bits = &settings.colorQuantizationBits;
+		}
+
+		// Unit vectors span [-1, 1] whatever their bounds
+		float range = semantic == "NORMAL" || semantic == "TANGENT" ? 2.0f : largestExtent(accessor);
+		float error;
+		if (semantic == "POSITION" && options->dracoMaxError > 0) {
+			error = options->dracoMaxError;
+		}
+		else if (options->dracoMaxRelativeError > 0) {
+			error = options->dracoMaxRelativeError * range;
+		}
+		else {
+			continue;
+		}
+		int attributeBits = quantizationBitsForError(range, error);
+		if (chosen.insert(bits).second) {
+			*bits = attributeBits;
+		}
+		else {
+			*bits = std::max(*bits, attributeBits);
+		}
+	}
+	return settings;
+}
+
+size_t primitiveByteLength(GLTF::Primitive* primitive) {
+	size_t byteLength = 0;
+	for (const auto& attribute : primitive->attributes) {
+		byteLength += attribute.second->count * attribute.second->getNumberOfComponents() * attribute.second->getComponentByteLength();
+	}
+	if (primitive->indices != NULL) {
+		byteLength += primitive->indices->count * primitive->indices->getComponentByteLength();
+	}
+	return byteLength;
+}
+
+/**
+ * Sizes and encode time of the Draco compressed primitives of one mode.
+ */
+class DracoModeStatistics {
+public:
+	int primitives = 0;
+	size_t uncompressedByteLength = 0;
+	// Shared encodings are only counted once, as they are only written once
+	size_t compressedByteLength = 0;
+	double encodeMilliseconds = 0;
+};
+
+const char* primitiveModeName(GLTF::Primitive::Mode mode) {
+	switch (mode) {
+	case GLTF::Primitive::Mode::POINTS:
+		return "points";
+	case GLTF::Primitive::Mode::LINES:
+		return "lines";
+	case GLTF::Primitive::Mode::LINE_LOOP:
+		return "line loops";
+	case GLTF::Primitive::Mode::LINE_STRIP:
+		return "line strips";
+	case GLTF::Primitive::Mode::TRIANGLES:
+		return "triangles";
+	case GLTF::Primitive::Mode::TRIANGLE_STRIP:
+		return "triangle strips";
+	case GLTF::Primitive::Mode::TRIANGLE_FAN:
+		return "triangle fans";
+	default:
+		return "unknown";
+	}
+}
+
+void forEachIndex(GLTF::ThreadPool* threadPool, size_t count, std::function<void(size_t)> task) {
+	if (threadPool != NULL) {
+		threadPool->parallelFor(count, task);
+	}
+	else {
+		for (size_t i = 0; i < count; i++) {
+			task(i);
+		}
+	}
 }
 
 bool GLTF::Asset::compressPrimitives(GLTF::Options* options) {
-	int totalPrimitives = 0;
-	for (GLTF::Primitive* primitive : getAllPrimitives()) {
-		totalPrimitives++;
+	GLTF::Arena::Scope scope(&arena);
+	// Primitives can share an extension, each mesh is only compressed once
+	std::vector<GLTF::DracoExtension*> dracoExtensions;
+	std::vector<GLTF::Primitive*> dracoPrimitives;
+	// Position of each primitive in getAllPrimitives, to identify it in the report
+	std::vector<size_t> dracoPrimitiveIndices;
+	std::set<GLTF::DracoExtension*> seen;
+	std::vector<GLTF::Primitive*> primitives = getAllPrimitives();
+	for (size_t i = 0; i < primitives.size(); i++) {
+		GLTF::Primitive* primitive = primitives[i];
 		auto dracoExtensionPtr = primitive->extensions.find("KHR_draco_mesh_compression");
 		if (dracoExtensionPtr == primitive->extensions.end()) {
 			// No extension exists.
 			continue;
 		}
 		GLTF::DracoExtension* dracoExtension = (GLTF::DracoExtension*)dracoExtensionPtr->second;
-		draco::Mesh *dracoMesh = dracoExtension->dracoMesh.get();
-		if (!dracoMesh) {
+		if (dracoExtension->dracoMesh.get() != NULL && seen.insert(dracoExtension).second) {
+			dracoExtension->settings = chooseDracoSettings(primitive, options);
+			dracoExtensions.push_back(dracoExtension);
+			dracoPrimitives.push_back(primitive);
+			dracoPrimitiveIndices.push_back(i);
+		}
+	}
+
+	GLTF::ThreadPool* threadPool = NULL;
+	if (options->threads > 1 && dracoExtensions.size() > 1) {
+		threadPool = new GLTF::ThreadPool((int)std::min((size_t)options->threads, dracoExtensions.size()));
+	}
+
+	// Meshes with the same content and settings encode to the same bytes, only the first of them is
+	// encoded or loaded from the cache directory.
+	std::vector<std::string> keys(dracoExtensions.size());
+	forEachIndex(threadPool, dracoExtensions.size(), [&](size_t i) {
+		keys[i] = GLTF::DracoCache::key(dracoExtensions[i]->dracoMesh.get(), dracoExtensions[i]->settings);
+	});
+	GLTF::DracoCache cache(options->dracoCacheDir);
+	std::map<std::string, size_t> firstIndices;
+	std::vector<DracoEncodeResult> results(dracoExtensions.size());
+	std::vector<size_t> encodes;
+	for (size_t i = 0; i < dracoExtensions.size(); i++) {
+		if (!firstIndices.insert(std::make_pair(keys[i], i)).second) {
 			continue;
 		}
+		DracoEncodeResult& result = results[i];
+		result.ok = cache.load(keys[i], &result.data, &result.length);
+		if (!result.ok) {
+			encodes.push_back(i);
+		}
+	}
+
+	// Each encode owns its encoder and output buffer, results are gathered in primitive order below
+	// so the output does not depend on the number of threads.
+	forEachIndex(threadPool, encodes.size(), [&](size_t i) {
+		encodeDracoMesh(dracoExtensions[encodes[i]]->dracoMesh.get(), dracoExtensions[encodes[i]]->settings, results[encodes[i]]);
+	});
+	delete threadPool;
+	for (size_t i : encodes) {
+		if (results[i].ok) {
+			cache.store(keys[i], results[i].data, results[i].length);
+		}
+	}
 
-		// Compress the mesh
-		// Setup encoder options.
-		draco::Encoder encoder;
-		const int posQuantizationBits = options->positionQuantizationBits;
-		const int texcoordsQuantizationBits = options->texcoordQuantizationBits;
-		const int normalsQuantizationBits = options->normalQuantizationBits;
-		const int colorQuantizationBits = options->colorQuantizationBits;
-		// Used for compressing joint indices and joint weights.
-		const int genericQuantizationBits = options->jointQuantizationBits;
-
-		encoder.SetAttributeQuantization(draco::GeometryAttribute::POSITION, posQuantizationBits);
-		encoder.SetAttributeQuantization(draco::GeometryAttribute::TEX_COORD, texcoordsQuantizationBits);
-		encoder.SetAttributeQuantization(draco::GeometryAttribute::NORMAL, normalsQuantizationBits);
-		encoder.SetAttributeQuantization(draco::GeometryAttribute::COLOR, colorQuantizationBits);
-		encoder.SetAttributeQuantization(draco::GeometryAttribute::GENERIC, genericQuantizationBits);
-
-		draco::EncoderBuffer buffer;
-		const draco::Status status = encoder.EncodeMeshToBuffer(*dracoMesh, &buffer);
-		if (!status.ok()) {
-			std::cerr << "Error: Encode mesh.\n";
-			return false;
-		}
-
-		// Add compressed data to bufferview
-		unsigned char* allocatedData = (unsigned char*)malloc(buffer.size());
-		std::memcpy(allocatedData, buffer.data(), buffer.size());
-		GLTF::BufferView* bufferView = new GLTF::BufferView(allocatedData, buffer.size());
+	bool success = true;
+	std::map<size_t, GLTF::BufferView*> bufferViews;
+	std::map<GLTF::Primitive::Mode, DracoModeStatistics> statistics;
+	for (size_t i = 0; i < dracoExtensions.size(); i++) {
+		size_t firstIndex = firstIndices[keys[i]];
+		DracoEncodeResult& result = results[firstIndex];
+		if (!result.ok) {
+			if (success) {
+				std::cerr << "Error: Encode mesh. " << result.error << "\n";
+			}
+			success = false;
+			continue;
+		}
+		DracoModeStatistics& modeStatistics = statistics[dracoPrimitives[i]->mode];
+		modeStatistics.primitives++;
+		modeStatistics.uncompressedByteLength += primitiveByteLength(dracoPrimitives[i]);
+		// Add compressed data to bufferview, shared by every mesh with the same key
+		GLTF::BufferView*& bufferView = bufferViews[firstIndex];
+		if (bufferView == NULL) {
+			bufferView = new GLTF::BufferView(result.data, result.length);
+			modeStatistics.compressedByteLength += result.length;
+			modeStatistics.encodeMilliseconds += result.encodeMilliseconds;
+		}
+		GLTF::DracoExtension* dracoExtension = dracoExtensions[i];
 		dracoExtension->bufferView = bufferView;
 		// Remove the mesh so duplicated primitives don't need to compress again.
 		dracoExtension->dracoMesh.reset();
+
+		if (options->dracoMaxError > 0 || options->dracoMaxRelativeError > 0) {
+			const GLTF::DracoExtension::Settings& settings = dracoExtension->settings;
+			std::cout << "Draco primitive " << dracoPrimitiveIndices[i] << ": qp " << settings.positionQuantizationBits << ", qn " << settings.normalQuantizationBits <<
+				", qt " << settings.texcoordQuantizationBits << ", qc " << settings.colorQuantizationBits << ", qj " << settings.genericQuantizationBits <<
+				", " << primitiveByteLength(dracoPrimitives[i]) << " -> " << result.length << " bytes" << (firstIndex != i ? " (shared)" : "") << std::endl;
+		}
 	}
-	return true;
+	for (const auto& entry : statistics) {
+		const DracoModeStatistics& modeStatistics = entry.second;
+		std::cout << "Draco " << primitiveModeName(entry.first) << ": " << modeStatistics.primitives << " primitives, " <<
+			modeStatistics.uncompressedByteLength << " -> " << modeStatistics.compressedByteLength << " bytes (" <<
+			(modeStatistics.compressedByteLength > 0 ? (double)modeStatistics.uncompressedByteLength / modeStatistics.compressedByteLength : 0) << "x), " <<
+			modeStatistics.encodeMilliseconds << " ms encoding" << std::endl;
+	}
+	return success;
 }
 
-GLTF::Buffer* GLTF::Asset::packAccessors() {
-	std::map<GLTF::Constants::WebGL, std::map<int, std::vector<GLTF::Accessor*>>> accessorGroups;
-	accessorGroups[GLTF::Constants::WebGL::ARRAY_BUFFER] = std::map<int, std::vector<GLTF::Accessor*>>();
-	accessorGroups[GLTF::Constants::WebGL::ELEMENT_ARRAY_BUFFER] = std::map<int, std::vector<GLTF::Accessor*>>();
-	accessorGroups[(GLTF::Constants::WebGL)-1] = std::map<int, std::vector<GLTF::Accessor*>>();
+GLTF::BufferLayout* GLTF::Asset::planBufferLayout(GLTF::Options* options) {
+	GLTF::Arena::Scope scope(&arena);
+	GLTF::BufferLayout* layout = new GLTF::BufferLayout();
+	layout->buffer = new GLTF::Buffer(NULL, 0);
+
+	// Interleave the vertex attributes of each primitive into their own bufferViews.
+	// Draco primitives are skipped, their attributes no longer have bufferViews.
+	std::vector<GLTF::BufferLayout::Entry> entries;
+	std::set<GLTF::Accessor*> interleavedAccessors;
+	if (options->interleave) {
+		int maxByteStride = options->version == "1.0" ? 255 : 252;
+		for (GLTF::Primitive* primitive : getAllPrimitives()) {
+			if (primitive->extensions.find("KHR_draco_mesh_compression") != primitive->extensions.end()) {
+				continue;
+			}
+			std::vector<GLTF::Accessor*> attributes;
+			bool canInterleave = true;
+			for (auto attribute : primitive->attributes) {
+				GLTF::Accessor* accessor = attribute.second;
+				if (accessor->bufferView == NULL || accessor->bufferView->target != GLTF::Constants::WebGL::ARRAY_BUFFER ||
+						interleavedAccessors.find(accessor) != interleavedAccessors.end() ||
+						(attributes.size() > 0 && accessor->count != attributes[0]->count)) {
+					canInterleave = false;
+					break;
+				}
+				attributes.push_back(accessor);
+			}
+			if (!canInterleave || attributes.size() == 0) {
+				continue;
+			}
+			std::vector<GLTF::BufferLayout::Entry> interleavedEntries = planInterleavedAccessors(layout, attributes, maxByteStride);
+			entries.insert(entries.end(), interleavedEntries.begin(), interleavedEntries.end());
+			if (interleavedEntries.size() > 0) {
+				interleavedAccessors.insert(attributes.begin(), attributes.end());
+			}
+		}
+	}
 
-	size_t byteLength = 0;
+	std::map<GLTF::Constants::WebGL, std::map<int, std::vector<GLTF::Accessor*>>> accessorGroups;
 	for (GLTF::Accessor* accessor : getAllAccessors()) {
 		// In glTF 2.0, bufferView is not required in accessor.
-		if (accessor->bufferView == NULL) {
+		if (accessor->bufferView == NULL || interleavedAccessors.find(accessor) != interleavedAccessors.end()) {
 			continue;
 		}
 		GLTF::Constants::WebGL target = accessor->bufferView->target;
-		auto targetGroup = accessorGroups[target];
-		int byteStride = accessor->getByteStride();
-		auto findByteStrideGroup = targetGroup.find(byteStride);
-		std::vector<GLTF::Accessor*> byteStrideGroup;
-		if (findByteStrideGroup == targetGroup.end()) {
-			byteStrideGroup = std::vector<GLTF::Accessor*>();
+		int byteStride = accessor->getNumberOfComponents() * accessor->getComponentByteLength();
+		if (target == GLTF::Constants::WebGL::ARRAY_BUFFER) {
+			// Attributes are repacked tightly, byteStride must still be a multiple of 4.
+			byteStride = (byteStride + 3) & ~3;
 		}
-		else {
-			byteStrideGroup = findByteStrideGroup->second;
+		accessorGroups[target][byteStride].push_back(accessor);
+	}
+	for (auto targetGroup : accessorGroups) {
+		for (auto byteStrideGroup : targetGroup.second) {
+			entries.push_back(planAccessorsForTargetByteStride(layout, byteStrideGroup.second, targetGroup.first, byteStrideGroup.first));
 		}
-		byteStrideGroup.push_back(accessor);
-		targetGroup[byteStride] = byteStrideGroup;
-		accessorGroups[target] = targetGroup;
-		byteLength += accessor->bufferView->byteLength;
 	}
 
+	// Pack these into a buffer sorted from largest byteStride to smallest
+	std::stable_sort(entries.begin(), entries.end(), [](const GLTF::BufferLayout::Entry& a, const GLTF::BufferLayout::Entry& b) {
+		return a.byteStride > b.byteStride;
+	});
+
 	// Go through primitives and look for primitives that use Draco extension.
 	// If extension is not enabled, the vector will be empty.
-	std::vector<GLTF::BufferView*> compressedBufferViews = getAllCompressedBufferView();
-	// Reserve data for compressed data.
-	for (GLTF::BufferView* compressedBufferView : compressedBufferViews) {
-		byteLength += compressedBufferView->byteLength;
+	for (GLTF::BufferView* compressedBufferView : getAllCompressedBufferView()) {
+		GLTF::BufferLayout::Entry entry;
+		entry.bufferView = compressedBufferView;
+		GLTF::BufferLayout::Source source;
+		source.data = compressedBufferView->buffer->data + compressedBufferView->byteOffset;
+		source.byteLength = compressedBufferView->byteLength;
+		entry.sources.push_back(source);
+		layout->sourceBuffers.insert(compressedBufferView->buffer);
+		compressedBufferView->buffer = layout->buffer;
+		entries.push_back(entry);
 	}
 
-	std::vector<int> byteStrides;
-	std::map<int, std::vector<GLTF::BufferView*>> bufferViews;
-	for (auto targetGroup : accessorGroups) {
-		for (auto byteStrideGroup : targetGroup.second) {
-			GLTF::Constants::WebGL target = targetGroup.first;
-			int byteStride = byteStrideGroup.first;
-			GLTF::BufferView* bufferView = packAccessorsForTargetByteStride(byteStrideGroup.second, target, byteStride);
-			if (target == GLTF::Constants::WebGL::ARRAY_BUFFER) {
-				bufferView->byteStride = byteStride;
-			}
-			auto findBufferViews = bufferViews.find(byteStride);
-			std::vector<GLTF::BufferView*> bufferViewGroup;
-			if (findBufferViews == bufferViews.end()) {
-				byteStrides.push_back(byteStride);
-				bufferViewGroup = std::vector<GLTF::BufferView*>();
-			}
-			else {
-				bufferViewGroup = findBufferViews->second;
-			}
-			bufferViewGroup.push_back(bufferView);
-			bufferViews[byteStride] = bufferViewGroup;
+	// Images are stored in the buffer for binary glTF
+	if (options->binary && options->embeddedTextures) {
+		for (GLTF::Image* image : getAllImages()) {
+			GLTF::BufferLayout::Entry entry;
+			entry.bufferView = new GLTF::BufferView(0, image->byteLength, layout->buffer);
+			image->bufferView = entry.bufferView;
+			GLTF::BufferLayout::Source source;
+			source.data = image->data;
+			source.byteLength = image->byteLength;
+			entry.sources.push_back(source);
+			entries.push_back(entry);
 		}
 	}
-	std::sort(byteStrides.begin(), byteStrides.end(), std::greater<int>());
 
-	// Pack these into a buffer sorted from largest byteStride to smallest
-	unsigned char* bufferData = new unsigned char[byteLength];
-	GLTF::Buffer* buffer = new GLTF::Buffer(bufferData, byteLength);
+	// Each bufferView starts on a 4-byte boundary so every accessor stays aligned.
 	size_t byteOffset = 0;
-	for (int byteStride : byteStrides) {
-		for (GLTF::BufferView* bufferView : bufferViews[byteStride]) {
-			std::memcpy(bufferData + byteOffset, bufferView->buffer->data, bufferView->byteLength);
-			bufferView->byteOffset = byteOffset;
-			bufferView->buffer = buffer;
-			byteOffset += bufferView->byteLength;
-		}
+	for (GLTF::BufferLayout::Entry& entry : entries) {
+		byteOffset = (byteOffset + 3) & ~3;
+		entry.bufferView->byteOffset = byteOffset;
+		byteOffset += entry.bufferView->byteLength;
 	}
+	layout->buffer->byteLength = byteOffset;
+	layout->entries = entries;
+	return layout;
+}
 
-	// Append compressed data to buffer.
-	for (GLTF::BufferView* compressedBufferView : compressedBufferViews) {
-		std::memcpy(bufferData + byteOffset, compressedBufferView->buffer->data, compressedBufferView->byteLength);
-		compressedBufferView->byteOffset = byteOffset;
-		compressedBufferView->buffer = buffer;
-		byteOffset += compressedBufferView->byteLength;
-	}
+GLTF::Buffer* GLTF::Asset::packAccessors(GLTF::Options* options) {
+	GLTF::Arena::Scope scope(&arena);
+	GLTF::BufferLayout* layout = planBufferLayout(options);
+	GLTF::Buffer* buffer = layout->buffer;
+	buffer->data = (unsigned char*)calloc(std::max(buffer->byteLength, (size_t)1), 1);
+	layout->write(buffer->data);
+	layout->releaseSources();
+	delete layout;
 	return buffer;
 }
 
@@ -699,9 +1455,8 @@ void GLTF::Asset::useExtension(std::string extension) {
 	extensionsUsed.insert(extension);
 }
 
-void GLTF::Asset::writeJSON(void* writer, GLTF::Options* options) {
-	rapidjson::Writer<rapidjson::StringBuffer>* jsonWriter = (rapidjson::Writer<rapidjson::StringBuffer>*)writer;
-
+void GLTF::Asset::writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options) {
+	GLTF::Arena::Scope scope(&arena);
 	if (options->binary && options->version == "1.0") {
 		useExtension("KHR_binary_glTF");
 	}
@@ -710,7 +1465,7 @@ void GLTF::Asset::writeJSON(void* writer, GLTF::Options* options) {
 	if (this->metadata) {
 		jsonWriter->Key("asset");
 		jsonWriter->StartObject();
-		this->metadata->writeJSON(writer, options);
+		this->metadata->writeJSON(jsonWriter, options);
 		jsonWriter->EndObject();
 	}
 
@@ -754,7 +1509,7 @@ void GLTF::Asset::writeJSON(void* writer, GLTF::Options* options) {
 				jsonWriter->Key(scene->getStringId().c_str());
 			}
 			jsonWriter->StartObject();
-			scene->writeJSON(writer, options);
+			scene->writeJSON(jsonWriter, options);
 			jsonWriter->EndObject();
 		}
 		if (options->version == "1.0") {
@@ -818,7 +1573,7 @@ void GLTF::Asset::writeJSON(void* writer, GLTF::Options* options) {
 				jsonWriter->Key(node->getStringId().c_str());
 			}
 			jsonWriter->StartObject();
-			node->writeJSON(writer, options);
+			node->writeJSON(jsonWriter, options);
 			jsonWriter->EndObject();
 		}
 		if (options->version == "1.0") {
@@ -844,7 +1599,7 @@ void GLTF::Asset::writeJSON(void* writer, GLTF::Options* options) {
 				jsonWriter->Key(camera->getStringId().c_str());
 			}
 			jsonWriter->StartObject();
-			camera->writeJSON(writer, options);
+			camera->writeJSON(jsonWriter, options);
 			jsonWriter->EndObject();
 		}
 		if (options->version == "1.0") {
@@ -909,7 +1664,7 @@ void GLTF::Asset::writeJSON(void* writer, GLTF::Options* options) {
 										metallicRoughnessTexturePath = options->metallicRoughnessTexturePaths[0];
 									}
 									GLTF::MaterialPBR::Texture* metallicRoughnessTexture = new GLTF::MaterialPBR::Texture();
-									GLTF::Image* image = GLTF::Image::load(metallicRoughnessTexturePath);
+									GLTF::Image* image = loadImage(metallicRoughnessTexturePath);
 									std::map<GLTF::Image*, GLTF::Texture*>::iterator textureCacheIt = _pbrTextureCache.find(image);
 									GLTF::Texture* texture;
 									if (textureCacheIt == _pbrTextureCache.end()) {
@@ -961,7 +1716,7 @@ void GLTF::Asset::writeJSON(void* writer, GLTF::Options* options) {
 				jsonWriter->Key(mesh->getStringId().c_str());
 			}
 			jsonWriter->StartObject();
-			mesh->writeJSON(writer, options);
+			mesh->writeJSON(jsonWriter, options);
 			jsonWriter->EndObject();
 		}
 		if (options->version == "1.0") {
@@ -1004,7 +1759,7 @@ void GLTF::Asset::writeJSON(void* writer, GLTF::Options* options) {
 					jsonWriter->Key(animation->getStringId().c_str());
 				}
 				jsonWriter->StartObject();
-				animation->writeJSON(writer, options);
+				animation->writeJSON(jsonWriter, options);
 				jsonWriter->EndObject();
 			}
 		}
@@ -1034,7 +1789,7 @@ void GLTF::Asset::writeJSON(void* writer, GLTF::Options* options) {
 				jsonWriter->Key(skin->getStringId().c_str());
 			}
 			jsonWriter->StartObject();
-			skin->writeJSON(writer, options);
+			skin->writeJSON(jsonWriter, options);
 			jsonWriter->EndObject();
 		}
 		if (options->version == "1.0") {
@@ -1067,7 +1822,7 @@ void GLTF::Asset::writeJSON(void* writer, GLTF::Options* options) {
 				jsonWriter->Key(accessor->getStringId().c_str());
 			}
 			jsonWriter->StartObject();
-			accessor->writeJSON(writer, options);
+			accessor->writeJSON(jsonWriter, options);
 			jsonWriter->EndObject();
 		}
 		if (options->version == "1.0") {
@@ -1187,7 +1942,7 @@ void GLTF::Asset::writeJSON(void* writer, GLTF::Options* options) {
 				jsonWriter->Key(material->getStringId().c_str());
 			}
 			jsonWriter->StartObject();
-			material->writeJSON(writer, options);
+			material->writeJSON(jsonWriter, options);
 			jsonWriter->EndObject();
 		}
 		if (options->version == "1.0") {
@@ -1215,7 +1970,7 @@ void GLTF::Asset::writeJSON(void* writer, GLTF::Options* options) {
 				jsonWriter->Key(light->getStringId().c_str());
 			}
 			jsonWriter->StartObject();
-			light->writeJSON(writer, options);
+			light->writeJSON(jsonWriter, options);
 			jsonWriter->EndObject();
 		}
 		lights.clear();
@@ -1254,7 +2009,7 @@ void GLTF::Asset::writeJSON(void* writer, GLTF::Options* options) {
 				jsonWriter->Key(texture->getStringId().c_str());
 			}
 			jsonWriter->StartObject();
-			texture->writeJSON(writer, options);
+			texture->writeJSON(jsonWriter, options);
 			jsonWriter->EndObject();
 		}
 		if (options->version == "1.0") {
@@ -1285,7 +2040,7 @@ void GLTF::Asset::writeJSON(void* writer, GLTF::Options* options) {
 				jsonWriter->Key(image->getStringId().c_str());
 			}
 			jsonWriter->StartObject();
-			image->writeJSON(writer, options);
+			image->writeJSON(jsonWriter, options);
 			jsonWriter->EndObject();
 		}
 		if (options->version == "1.0") {
@@ -1311,7 +2066,7 @@ void GLTF::Asset::writeJSON(void* writer, GLTF::Options* options) {
 				jsonWriter->Key(sampler->getStringId().c_str());
 			}
 			jsonWriter->StartObject();
-			sampler->writeJSON(writer, options);
+			sampler->writeJSON(jsonWriter, options);
 			jsonWriter->EndObject();
 		}
 		if (options->version == "1.0") {
@@ -1345,7 +2100,7 @@ void GLTF::Asset::writeJSON(void* writer, GLTF::Options* options) {
 				jsonWriter->Key(technique->getStringId().c_str());
 			}
 			jsonWriter->StartObject();
-			technique->writeJSON(writer, options);
+			technique->writeJSON(jsonWriter, options);
 			jsonWriter->EndObject();
 		}
 		if (options->version == "1.0") {
@@ -1382,7 +2137,7 @@ void GLTF::Asset::writeJSON(void* writer, GLTF::Options* options) {
 				jsonWriter->Key(program->getStringId().c_str());
 			}
 			jsonWriter->StartObject();
-			program->writeJSON(writer, options);
+			program->writeJSON(jsonWriter, options);
 			jsonWriter->EndObject();
 		}
 		if (options->version == "1.0") {
@@ -1408,7 +2163,7 @@ void GLTF::Asset::writeJSON(void* writer, GLTF::Options* options) {
 				jsonWriter->Key(shader->getStringId().c_str());
 			}
 			jsonWriter->StartObject();
-			shader->writeJSON(writer, options);
+			shader->writeJSON(jsonWriter, options);
 			jsonWriter->EndObject();
 		}
 		if (options->version == "1.0") {
@@ -1442,7 +2197,7 @@ void GLTF::Asset::writeJSON(void* writer, GLTF::Options* options) {
 				jsonWriter->Key(bufferView->getStringId().c_str());
 			}
 			jsonWriter->StartObject();
-			bufferView->writeJSON(writer, options);
+			bufferView->writeJSON(jsonWriter, options);
 			jsonWriter->EndObject();
 		}
 		if (options->version == "1.0") {
@@ -1468,7 +2223,7 @@ void GLTF::Asset::writeJSON(void* writer, GLTF::Options* options) {
 				jsonWriter->Key(buffer->getStringId().c_str());
 			}
 			jsonWriter->StartObject();
-			buffer->writeJSON(writer, options);
+			buffer->writeJSON(jsonWriter, options);
 			jsonWriter->EndObject();
 		}
 		if (options->version == "1.0") {
@@ -1498,5 +2253,8 @@ void GLTF::Asset::writeJSON(void* writer, GLTF::Options* options) {
 		jsonWriter->EndArray();
 	}
 
-	GLTF::Object::writeJSON(writer, options);
+	GLTF::Object::writeJSON(jsonWriter, options);
+
+	// Common materials were replaced by the generated materials written above
+	invalidate();
 }
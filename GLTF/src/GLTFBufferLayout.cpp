@@ -0,0 +1,163 @@
+#include "GLTFBufferLayout.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include "GLTFAccessorView.h"
+
+namespace {
+	// Accessor entries are streamed through a block of this size, whatever the size of the entry
+	const size_t SCRATCH_LENGTH = 64 * 1024;
+}
+
+/**
+ * Copies the elements of a view that fall in the range [begin, end) of a bufferView into a window
+ * holding that range. Elements cut by the edges of the range are copied in part.
+ */
+struct CopyElementsVisitor {
+	unsigned char* window;
+	size_t begin;
+	size_t end;
+	// Offset of the first element from the start of the bufferView
+	size_t byteOffset;
+	size_t byteStride;
+
+	template <typename T, int N>
+	void operator()(const GLTF::AccessorView<T, N>& view) {
+		const size_t elementLength = sizeof(T) * N;
+		if (view.count <= 0 || end <= byteOffset) {
+			return;
+		}
+		size_t first = begin < byteOffset + elementLength ? 0 : (begin - byteOffset - elementLength) / byteStride + 1;
+		size_t last = std::min((size_t)view.count, (end - byteOffset + byteStride - 1) / byteStride);
+		for (size_t i = first; i < last; i++) {
+			size_t elementOffset = byteOffset + i * byteStride;
+			T* source = view[(int)i];
+			if (elementOffset >= begin && elementOffset + elementLength <= end) {
+				T* destination = (T*)(window + (elementOffset - begin));
+				for (int j = 0; j < N; j++) {
+					destination[j] = source[j];
+				}
+			}
+			else {
+				T element[N];
+				for (int j = 0; j < N; j++) {
+					element[j] = source[j];
+				}
+				size_t from = std::max(elementOffset, begin);
+				size_t to = std::min(elementOffset + elementLength, end);
+				std::memcpy(window + (from - begin), (unsigned char*)element + (from - elementOffset), to - from);
+			}
+		}
+	}
+};
+
+/**
+ * @return Whether every payload of the entry is already laid out as it is written, one after another
+ * with the entry's byte stride, so they can be written straight from their source.
+ */
+bool isEntryContiguous(const GLTF::BufferLayout::Entry& entry) {
+	size_t byteOffset = 0;
+	for (const GLTF::BufferLayout::Source& source : entry.sources) {
+		if (source.byteOffset < byteOffset) {
+			return false;
+		}
+		if (source.accessor != NULL) {
+			size_t elementLength = source.accessor->getNumberOfComponents() * source.accessor->getComponentByteLength();
+			if (source.byteStride != entry.byteStride || elementLength != entry.byteStride) {
+				return false;
+			}
+			byteOffset = source.byteOffset + entry.byteStride * source.accessor->count;
+		}
+		else {
+			byteOffset = source.byteOffset + source.byteLength;
+		}
+	}
+	return byteOffset <= (size_t)entry.bufferView->byteLength;
+}
+
+void GLTF::BufferLayout::writeEntry(const GLTF::BufferLayout::Entry& entry, unsigned char* destination) {
+	writeEntry(entry, destination, 0, entry.bufferView->byteLength);
+}
+
+void GLTF::BufferLayout::writeEntry(const GLTF::BufferLayout::Entry& entry, unsigned char* window, size_t begin, size_t end) {
+	for (const GLTF::BufferLayout::Source& source : entry.sources) {
+		if (source.accessor == NULL) {
+			size_t from = std::max(source.byteOffset, begin);
+			size_t to = std::min(source.byteOffset + source.byteLength, end);
+			if (from < to) {
+				std::memcpy(window + (from - begin), source.data + (from - source.byteOffset), to - from);
+			}
+			continue;
+		}
+		CopyElementsVisitor visitor;
+		visitor.window = window;
+		visitor.begin = begin;
+		visitor.end = end;
+		visitor.byteOffset = source.byteOffset;
+		visitor.byteStride = entry.byteStride;
+		GLTF::visitAccessor(source.accessor, source.data, source.byteStride, visitor);
+	}
+}
+
+void GLTF::BufferLayout::write(unsigned char* destination) {
+	for (const GLTF::BufferLayout::Entry& entry : entries) {
+		writeEntry(entry, destination + entry.bufferView->byteOffset);
+	}
+}
+
+bool writePadding(FILE* file, size_t length) {
+	const unsigned char padding[16] = { 0 };
+	while (length > 0) {
+		size_t writeLength = std::min(length, sizeof(padding));
+		if (fwrite(padding, sizeof(unsigned char), writeLength, file) != writeLength) {
+			return false;
+		}
+		length -= writeLength;
+	}
+	return true;
+}
+
+bool GLTF::BufferLayout::write(FILE* file) {
+	unsigned char* scratch = NULL;
+	size_t byteOffset = 0;
+	bool success = true;
+	for (const GLTF::BufferLayout::Entry& entry : entries) {
+		size_t byteLength = entry.bufferView->byteLength;
+		success = success && writePadding(file, entry.bufferView->byteOffset - byteOffset);
+		if (isEntryContiguous(entry)) {
+			size_t position = 0;
+			for (const GLTF::BufferLayout::Source& source : entry.sources) {
+				size_t sourceLength = source.accessor != NULL ? entry.byteStride * source.accessor->count : source.byteLength;
+				success = success && writePadding(file, source.byteOffset - position);
+				success = success && fwrite(source.data, sizeof(unsigned char), sourceLength, file) == sourceLength;
+				position = source.byteOffset + sourceLength;
+			}
+			success = success && writePadding(file, byteLength - position);
+		}
+		else {
+			if (scratch == NULL) {
+				scratch = (unsigned char*)malloc(SCRATCH_LENGTH);
+			}
+			for (size_t begin = 0; begin < byteLength; begin += SCRATCH_LENGTH) {
+				size_t end = std::min(begin + SCRATCH_LENGTH, byteLength);
+				// Interleaved elements leave gaps that must be written as zeros
+				std::memset(scratch, 0, end - begin);
+				writeEntry(entry, scratch, begin, end);
+				success = success && fwrite(scratch, sizeof(unsigned char), end - begin, file) == end - begin;
+			}
+		}
+		byteOffset = entry.bufferView->byteOffset + byteLength;
+	}
+	free(scratch);
+	return success;
+}
+
+void GLTF::BufferLayout::releaseSources() {
+	for (GLTF::Buffer* sourceBuffer : sourceBuffers) {
+		free(sourceBuffer->data);
+		sourceBuffer->data = NULL;
+	}
+	sourceBuffers.clear();
+}
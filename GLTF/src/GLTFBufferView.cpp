@@ -1,21 +1,18 @@
 #include "GLTFBufferView.h"
 
-#include "rapidjson/stringbuffer.h"
-#include "rapidjson/writer.h"
-
-GLTF::BufferView::BufferView(int byteOffset, int byteLength, GLTF::Buffer* buffer) {
+GLTF::BufferView::BufferView(size_t byteOffset, size_t byteLength, GLTF::Buffer* buffer) {
 	this->byteOffset = byteOffset;
 	this->byteLength = byteLength;
 	this->buffer = buffer;
 }
 
-GLTF::BufferView::BufferView(unsigned char* data, int dataLength) {
+GLTF::BufferView::BufferView(unsigned char* data, size_t dataLength) {
 	this->byteOffset = 0;
 	this->byteLength = dataLength;
 	this->buffer = new Buffer(data, dataLength);
 }
 
-GLTF::BufferView::BufferView(unsigned char* data, int dataLength, GLTF::Constants::WebGL target) : GLTF::BufferView::BufferView(data, dataLength) {
+GLTF::BufferView::BufferView(unsigned char* data, size_t dataLength, GLTF::Constants::WebGL target) : GLTF::BufferView::BufferView(data, dataLength) {
 	this->target = target;
 }
 
@@ -23,8 +20,7 @@ std::string GLTF::BufferView::typeName() {
 	return "bufferView";
 }
 
-void GLTF::BufferView::writeJSON(void* writer, GLTF::Options* options) {
-	rapidjson::Writer<rapidjson::StringBuffer>* jsonWriter = (rapidjson::Writer<rapidjson::StringBuffer>*)writer;
+void GLTF::BufferView::writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options) {
 	if (this->buffer) {
 		jsonWriter->Key("buffer");
 		if (options->version == "1.0") {
@@ -35,9 +31,9 @@ void GLTF::BufferView::writeJSON(void* writer, GLTF::Options* options) {
 		}
 	}
 	jsonWriter->Key("byteOffset");
-	jsonWriter->Int(this->byteOffset);
+	jsonWriter->Uint64(this->byteOffset);
 	jsonWriter->Key("byteLength");
-	jsonWriter->Int(this->byteLength);
+	jsonWriter->Uint64(this->byteLength);
 	if (byteStride != 0 && options->version != "1.0") {
 		jsonWriter->Key("byteStride");
 		jsonWriter->Int(this->byteStride);
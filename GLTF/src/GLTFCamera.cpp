@@ -1,15 +1,10 @@
 #include "GLTFCamera.h"
 
-#include "rapidjson/stringbuffer.h"
-#include "rapidjson/writer.h"
-
 std::string GLTF::Camera::typeName() {
 	return "camera";
 }
 
-void GLTF::Camera::writeJSON(void* writer, GLTF::Options* options) {
-	rapidjson::Writer<rapidjson::StringBuffer>* jsonWriter = (rapidjson::Writer<rapidjson::StringBuffer>*)writer;
-
+void GLTF::Camera::writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options) {
 	if (type != Type::UNKNOWN) {
 		jsonWriter->Key("type");
 		if (type == Type::PERSPECTIVE) {
@@ -19,12 +14,10 @@ void GLTF::Camera::writeJSON(void* writer, GLTF::Options* options) {
 			jsonWriter->String("orthographic");
 		}
 	}
-	GLTF::Object::writeJSON(writer, options);
+	GLTF::Object::writeJSON(jsonWriter, options);
 }
 
-void GLTF::CameraOrthographic::writeJSON(void* writer, GLTF::Options* options) {
-	rapidjson::Writer<rapidjson::StringBuffer>* jsonWriter = (rapidjson::Writer<rapidjson::StringBuffer>*)writer;
-
+void GLTF::CameraOrthographic::writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options) {
 	jsonWriter->Key("orthographic");
 	jsonWriter->StartObject();
 	jsonWriter->Key("xmag");
@@ -37,12 +30,10 @@ void GLTF::CameraOrthographic::writeJSON(void* writer, GLTF::Options* options) {
 	jsonWriter->Double(znear);
 	jsonWriter->EndObject();
 
-	GLTF::Camera::writeJSON(writer, options);
+	GLTF::Camera::writeJSON(jsonWriter, options);
 }
 
-void GLTF::CameraPerspective::writeJSON(void* writer, GLTF::Options* options) {
-	rapidjson::Writer<rapidjson::StringBuffer>* jsonWriter = (rapidjson::Writer<rapidjson::StringBuffer>*)writer;
-
+void GLTF::CameraPerspective::writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options) {
 	jsonWriter->Key("perspective");
 	jsonWriter->StartObject();
 	if (aspectRatio > 0) {
@@ -57,5 +48,5 @@ void GLTF::CameraPerspective::writeJSON(void* writer, GLTF::Options* options) {
 	jsonWriter->Double(znear);
 	jsonWriter->EndObject();
 
-	GLTF::Camera::writeJSON(writer, options);
+	GLTF::Camera::writeJSON(jsonWriter, options);
 }
\ No newline at end of file
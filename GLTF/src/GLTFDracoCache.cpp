@@ -0,0 +1,212 @@
+#include "GLTFDracoCache.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <experimental/filesystem>
+#include <thread>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+// Bump when the key material or the file layout changes, so stale encodings on disk are never matched
+const char* DRACO_CACHE_FORMAT = "draco-cache-4";
+
+// Cache files start with this magic, the length of the encoding and a hash of it
+const char DRACO_CACHE_MAGIC[8] = "C2GDRC1";
+const size_t DRACO_CACHE_HASH_LENGTH = 32;
+const size_t DRACO_CACHE_HEADER_LENGTH = sizeof(DRACO_CACHE_MAGIC) + sizeof(uint64_t) + DRACO_CACHE_HASH_LENGTH;
+
+// Makes the temporary names of files stored by the same thread unique
+std::atomic<unsigned int> temporaryCounter(0);
+
+/**
+ * A streaming 128-bit hash built from two independently seeded 64-bit multiply-rotate lanes.
+ * Not cryptographic, but wide enough that unrelated meshes stored in a cache directory do not collide.
+ */
+class ContentHash {
+public:
+	void update(const void* data, size_t length) {
+		const unsigned char* bytes = (const unsigned char*)data;
+		for (size_t i = 0; i < length; i++) {
+			_word |= (uint64_t)bytes[i] << (_wordLength * 8);
+			_wordLength++;
+			if (_wordLength == 8) {
+				mix();
+			}
+		}
+		_length += length;
+	}
+
+	template <typename T>
+	void update(T value) {
+		update(&value, sizeof(T));
+	}
+
+	std::string hex() {
+		if (_wordLength > 0) {
+			mix();
+		}
+		uint64_t lanes[2] = { finalize(_lanes[0] ^ _length), finalize(_lanes[1] ^ _length) };
+		char digest[33];
+		snprintf(digest, sizeof(digest), "%016llx%016llx", (unsigned long long)lanes[0], (unsigned long long)lanes[1]);
+		return digest;
+	}
+
+private:
+	uint64_t _lanes[2] = { 0x9E3779B97F4A7C15ULL, 0xC2B2AE3D27D4EB4FULL };
+	uint64_t _word = 0;
+	int _wordLength = 0;
+	uint64_t _length = 0;
+
+	static uint64_t rotate(uint64_t value, int bits) {
+		return (value << bits) | (value >> (64 - bits));
+	}
+
+	static uint64_t finalize(uint64_t value) {
+		value ^= value >> 33;
+		value *= 0xFF51AFD7ED558CCDULL;
+		value ^= value >> 33;
+		value *= 0xC4CEB9FE1A85EC53ULL;
+		value ^= value >> 33;
+		return value;
+	}
+
+	void mix() {
+		_lanes[0] = rotate(_lanes[0] ^ (_word * 0x87C37B91114253D5ULL), 31) * 0x4CF5AD432745937FULL;
+		_lanes[1] = rotate(_lanes[1] ^ (rotate(_word, 29) * 0x4CF5AD432745937FULL), 27) * 0x87C37B91114253D5ULL + _lanes[0];
+		_word = 0;
+		_wordLength = 0;
+	}
+};
+
+std::string hashData(const unsigned char* data, size_t length) {
+	ContentHash hash;
+	hash.update(data, length);
+	return hash.hex();
+}
+
+GLTF::DracoCache::DracoCache(std::string directory) : _directory(directory) {
+	if (_directory != "") {
+		std::error_code error;
+		std::experimental::filesystem::create_directories(_directory, error);
+		if (error) {
+			std::cout << "WARNING: Couldn't create Draco cache directory '" << _directory << "', encodings won't be stored" << std::endl;
+			_directory = "";
+		}
+	}
+}
+
+std::string GLTF::DracoCache::key(const draco::Mesh* mesh, const GLTF::DracoExtension::Settings& settings) {
+	ContentHash hash;
+	hash.update(DRACO_CACHE_FORMAT, strlen(DRACO_CACHE_FORMAT));
+	hash.update((int)settings.geometry);
+	hash.update(settings.positionQuantizationBits);
+	hash.update(settings.normalQuantizationBits);
+	hash.update(settings.texcoordQuantizationBits);
+	hash.update(settings.colorQuantizationBits);
+	hash.update(settings.genericQuantizationBits);
+	hash.update(settings.encodeSpeed);
+	hash.update(settings.decodeSpeed);
+
+	hash.update(mesh->num_faces());
+	for (draco::FaceIndex i(0); i < mesh->num_faces(); ++i) {
+		const draco::Mesh::Face& face = mesh->face(i);
+		for (int j = 0; j < 3; j++) {
+			hash.update(face[j].value());
+		}
+	}
+
+	// Values are hashed per point through the attribute mapping, so the key does not depend on
+	// how values happen to be deduplicated in the attribute buffers.
+	hash.update(mesh->num_points());
+	hash.update(mesh->num_attributes());
+	for (int i = 0; i < mesh->num_attributes(); i++) {
+		const draco::PointAttribute* attribute = mesh->attribute(i);
+		hash.update((int)attribute->attribute_type());
+		hash.update((int)attribute->data_type());
+		hash.update((int)attribute->num_components());
+		hash.update(attribute->normalized());
+		size_t valueLength = attribute->num_components() * draco::DataTypeLength(attribute->data_type());
+		for (draco::PointIndex point(0); point < mesh->num_points(); ++point) {
+			hash.update(attribute->GetAddress(attribute->mapped_index(point)), valueLength);
+		}
+	}
+	return hash.hex();
+}
+
+bool GLTF::DracoCache::load(const std::string& key, unsigned char** data, size_t* length) {
+	if (_directory == "") {
+		return false;
+	}
+	std::string path = (std::experimental::filesystem::path(_directory) / (key + ".drc")).generic_string();
+	FILE* file = fopen(path.c_str(), "rb");
+	if (file == NULL) {
+		return false;
+	}
+	fseek(file, 0, SEEK_END);
+	long fileLength = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	bool loaded = false;
+	if (fileLength > (long)DRACO_CACHE_HEADER_LENGTH) {
+		char magic[sizeof(DRACO_CACHE_MAGIC)];
+		uint64_t encodingLength;
+		char hash[DRACO_CACHE_HASH_LENGTH];
+		size_t dataLength = fileLength - DRACO_CACHE_HEADER_LENGTH;
+		// A file cut short or overwritten by another writer is a miss, the mesh is encoded again
+		if (fread(magic, sizeof(magic), 1, file) == 1 && memcmp(magic, DRACO_CACHE_MAGIC, sizeof(magic)) == 0 &&
+			fread(&encodingLength, sizeof(encodingLength), 1, file) == 1 && encodingLength == dataLength &&
+			fread(hash, sizeof(hash), 1, file) == 1) {
+			*data = (unsigned char*)malloc(dataLength);
+			loaded = fread(*data, sizeof(unsigned char), dataLength, file) == dataLength &&
+				hashData(*data, dataLength).compare(0, DRACO_CACHE_HASH_LENGTH, hash, DRACO_CACHE_HASH_LENGTH) == 0;
+			if (loaded) {
+				*length = dataLength;
+			}
+			else {
+				free(*data);
+				*data = NULL;
+			}
+		}
+	}
+	fclose(file);
+	return loaded;
+}
+
+void GLTF::DracoCache::store(const std::string& key, const unsigned char* data, size_t length) {
+	if (_directory == "") {
+		return;
+	}
+	// Written under a name no other writer uses and renamed, so a concurrent conversion never reads a
+	// partial file, and load rejects files that don't match their header anyway
+	std::experimental::filesystem::path path = std::experimental::filesystem::path(_directory) / (key + ".drc");
+	std::experimental::filesystem::path temporaryPath = path;
+	temporaryPath += "." + std::to_string(getpid()) + "-" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) +
+		"-" + std::to_string(temporaryCounter++) + ".tmp";
+	FILE* file = fopen(temporaryPath.generic_string().c_str(), "wb");
+	if (file == NULL) {
+		return;
+	}
+	uint64_t encodingLength = length;
+	std::string hash = hashData(data, length);
+	bool written = fwrite(DRACO_CACHE_MAGIC, sizeof(DRACO_CACHE_MAGIC), 1, file) == 1 &&
+		fwrite(&encodingLength, sizeof(encodingLength), 1, file) == 1 &&
+		fwrite(hash.data(), sizeof(char), DRACO_CACHE_HASH_LENGTH, file) == DRACO_CACHE_HASH_LENGTH &&
+		fwrite(data, sizeof(unsigned char), length, file) == length;
+	written = fclose(file) == 0 && written;
+	std::error_code error;
+	if (written) {
+		std::experimental::filesystem::rename(temporaryPath, path, error);
+	}
+	if (!written || error) {
+		std::experimental::filesystem::remove(temporaryPath, error);
+	}
+}
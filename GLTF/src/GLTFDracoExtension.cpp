@@ -1,12 +1,8 @@
 #include "GLTFDracoExtension.h"
 
-#include "rapidjson/stringbuffer.h"
-#include "rapidjson/writer.h"
-
 #include <iostream>
 
-void GLTF::DracoExtension::writeJSON(void* writer, GLTF::Options* options) {
-	rapidjson::Writer<rapidjson::StringBuffer>* jsonWriter = (rapidjson::Writer<rapidjson::StringBuffer>*)writer;
+void GLTF::DracoExtension::writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options) {
 	jsonWriter->Key("bufferView");
 	jsonWriter->Int(this->bufferView->id);
 	jsonWriter->Key("attributes");
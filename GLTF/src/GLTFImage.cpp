@@ -4,16 +4,9 @@
 #include "Base64.h"
 #include "GLTFImage.h"
 
-#include "rapidjson/stringbuffer.h"
-#include "rapidjson/writer.h"
+GLTF::Image::Image(std::string uri) : uri(uri) {}
 
-std::map<std::string, GLTF::Image*> _imageCache;
-
-GLTF::Image::Image(std::string uri, std::string cacheKey) : uri(uri), cacheKey(cacheKey) {}
-
-GLTF::Image::Image(std::string uri) : Image(uri, "") {}
-
-GLTF::Image::Image(std::string uri, std::string cacheKey, unsigned char* data, size_t byteLength, std::string fileExtension) : uri(uri), data(data), byteLength(byteLength), cacheKey(cacheKey) {
+GLTF::Image::Image(std::string uri, unsigned char* data, size_t byteLength, std::string fileExtension) : uri(uri), data(data), byteLength(byteLength) {
 	std::string dataSubstring((char*)data, 8);
 	if (dataSubstring.substr(1, 7) == "PNG\r\n\x1a\n") {
 		mimeType = "image/png";
@@ -26,27 +19,19 @@ GLTF::Image::Image(std::string uri, std::string cacheKey, unsigned char* data, s
 	}
 }
 
-GLTF::Image::Image(std::string uri, unsigned char* data, size_t byteLength, std::string fileExtension) : Image(uri, "", data, byteLength, fileExtension) {}
-
 GLTF::Image::~Image() {
-	if (!cacheKey.empty()) {
-		_imageCache.erase(cacheKey);
-	}
+	free(data);
 }
 
 GLTF::Image* GLTF::Image::load(path imagePath) {
 	std::string fileString = imagePath.string();
-	std::map<std::string, GLTF::Image*>::iterator imageCacheIt = _imageCache.find(fileString);
-	if (imageCacheIt != _imageCache.end()) {
-		return imageCacheIt->second;
-	}
 	std::string fileExtension = imagePath.extension().string();
 	fileExtension.erase(0, 1);
 	GLTF::Image* image = NULL;
 	FILE* file = fopen(fileString.c_str(), "rb");
 	if (file == NULL) {
 		std::cout << "WARNING: Image uri: " << fileString << " could not be resolved " << std::endl;
-		image = new GLTF::Image(imagePath.filename().string(), fileString);
+		image = new GLTF::Image(imagePath.filename().string());
 	}
 	else {
 		fseek(file, 0, SEEK_END);
@@ -56,9 +41,8 @@ GLTF::Image* GLTF::Image::load(path imagePath) {
 		unsigned char* buffer = (unsigned char*)malloc(size);
 		int bytesRead = fread(buffer, sizeof(unsigned char), size, file);
 		fclose(file);
-		image = new GLTF::Image(imagePath.filename().string(), fileString, buffer, bytesRead, fileExtension);
+		image = new GLTF::Image(imagePath.filename().string(), buffer, bytesRead, fileExtension);
 	}
-	_imageCache[fileString] = image;
 	return image;
 }
 
@@ -113,14 +97,11 @@ std::string GLTF::Image::typeName() {
 	return "image";
 }
 
-void GLTF::Image::writeJSON(void* writer, GLTF::Options* options) {
-	rapidjson::Writer<rapidjson::StringBuffer>* jsonWriter = (rapidjson::Writer<rapidjson::StringBuffer>*)writer;
-
+void GLTF::Image::writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options) {
 	if (options->embeddedTextures && data != NULL) {
 		if (!options->binary) {
 			jsonWriter->Key("uri");
-			std::string embeddedUri = "data:" + mimeType + ";base64," + Base64::encode(data, byteLength);
-			jsonWriter->String(embeddedUri.c_str());
+			Base64::writeDataUri(jsonWriter, mimeType, data, byteLength);
 		}
 		else {
 			if (options->version == "1.0") {
@@ -151,5 +132,5 @@ void GLTF::Image::writeJSON(void* writer, GLTF::Options* options) {
 		jsonWriter->Key("uri");
 		jsonWriter->String(uri.c_str());
 	}
-	GLTF::Object::writeJSON(writer, options);
+	GLTF::Object::writeJSON(jsonWriter, options);
 }
\ No newline at end of file
@@ -1,9 +1,6 @@
 #include "GLTFMaterial.h"
 #include "GLTFNode.h"
 
-#include "rapidjson/stringbuffer.h"
-#include "rapidjson/writer.h"
-
 GLTF::Material::Material() {
 	this->values = new GLTF::Material::Values();
 	this->type = GLTF::Material::MATERIAL;
@@ -17,8 +14,7 @@ std::string GLTF::Material::typeName() {
 	return "material";
 }
 
-void GLTF::Material::Values::writeJSON(void* writer, GLTF::Options* options) {
-	rapidjson::Writer<rapidjson::StringBuffer>* jsonWriter = (rapidjson::Writer<rapidjson::StringBuffer>*)writer;
+void GLTF::Material::Values::writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options) {
 	if (ambient != NULL || ambientTexture != NULL) {
 		jsonWriter->Key("ambient");
 		if (ambientTexture != NULL && options->version == "1.0") {
@@ -118,12 +114,11 @@ void GLTF::Material::Values::writeJSON(void* writer, GLTF::Options* options) {
 	}
 }
 
-void GLTF::Material::writeJSON(void* writer, GLTF::Options* options) {
-	rapidjson::Writer<rapidjson::StringBuffer>* jsonWriter = (rapidjson::Writer<rapidjson::StringBuffer>*)writer;
+void GLTF::Material::writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options) {
 	if (this->values) {
 		jsonWriter->Key("values");
 		jsonWriter->StartObject();
-		this->values->writeJSON(writer, options);
+		this->values->writeJSON(jsonWriter, options);
 		jsonWriter->EndObject();
 	}
 	if (this->technique) {
@@ -135,11 +130,10 @@ void GLTF::Material::writeJSON(void* writer, GLTF::Options* options) {
 			jsonWriter->Int(technique->id);
 		}
 	}
-	GLTF::Object::writeJSON(writer, options);
+	GLTF::Object::writeJSON(jsonWriter, options);
 }
 
-void GLTF::MaterialPBR::Texture::writeJSON(void* writer, GLTF::Options* options) {
-	rapidjson::Writer<rapidjson::StringBuffer>* jsonWriter = static_cast<rapidjson::Writer<rapidjson::StringBuffer>*>(writer);
+void GLTF::MaterialPBR::Texture::writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options) {
 	if (scale != 1) {
 		jsonWriter->Key("scale");
 		jsonWriter->Double(scale);
@@ -152,11 +146,10 @@ void GLTF::MaterialPBR::Texture::writeJSON(void* writer, GLTF::Options* options)
 		jsonWriter->Key("texCoord");
 		jsonWriter->Int(texCoord);
 	}
-	GLTF::Object::writeJSON(writer, options);
+	GLTF::Object::writeJSON(jsonWriter, options);
 }
 
-void GLTF::MaterialPBR::MetallicRoughness::writeJSON(void* writer, GLTF::Options* options) {
-	rapidjson::Writer<rapidjson::StringBuffer>* jsonWriter = (rapidjson::Writer<rapidjson::StringBuffer>*)writer;
+void GLTF::MaterialPBR::MetallicRoughness::writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options) {
 	if (baseColorFactor) {
 		jsonWriter->Key("baseColorFactor");
 		jsonWriter->StartArray();
@@ -168,7 +161,7 @@ void GLTF::MaterialPBR::MetallicRoughness::writeJSON(void* writer, GLTF::Options
 	if (baseColorTexture) {
 		jsonWriter->Key("baseColorTexture");
 		jsonWriter->StartObject();
-		baseColorTexture->writeJSON(writer, options);
+		baseColorTexture->writeJSON(jsonWriter, options);
 		jsonWriter->EndObject();
 	}
 	if (metallicFactor >= 0) {
@@ -182,14 +175,13 @@ void GLTF::MaterialPBR::MetallicRoughness::writeJSON(void* writer, GLTF::Options
 	if (metallicRoughnessTexture) {
 		jsonWriter->Key("metallicRoughnessTexture");
 		jsonWriter->StartObject();
-		metallicRoughnessTexture->writeJSON(writer, options);
+		metallicRoughnessTexture->writeJSON(jsonWriter, options);
 		jsonWriter->EndObject();
 	}
-	GLTF::Object::writeJSON(writer, options);
+	GLTF::Object::writeJSON(jsonWriter, options);
 }
 
-void GLTF::MaterialPBR::SpecularGlossiness::writeJSON(void* writer, GLTF::Options* options) {
-	rapidjson::Writer<rapidjson::StringBuffer>* jsonWriter = (rapidjson::Writer<rapidjson::StringBuffer>*)writer;
+void GLTF::MaterialPBR::SpecularGlossiness::writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options) {
 	if (diffuseFactor) {
 		jsonWriter->Key("diffuseFactor");
 		jsonWriter->StartArray();
@@ -201,7 +193,7 @@ void GLTF::MaterialPBR::SpecularGlossiness::writeJSON(void* writer, GLTF::Option
 	if (diffuseTexture) {
 		jsonWriter->Key("diffuseTexture");
 		jsonWriter->StartObject();
-		diffuseTexture->writeJSON(writer, options);
+		diffuseTexture->writeJSON(jsonWriter, options);
 		jsonWriter->EndObject();
 	}
 	if (specularFactor) {
@@ -219,18 +211,17 @@ void GLTF::MaterialPBR::SpecularGlossiness::writeJSON(void* writer, GLTF::Option
 	if (specularGlossinessTexture) {
 		jsonWriter->Key("specularGlossinessTexture");
 		jsonWriter->StartObject();
-		specularGlossinessTexture->writeJSON(writer, options);
+		specularGlossinessTexture->writeJSON(jsonWriter, options);
 		jsonWriter->EndObject();
 	}
-	GLTF::Object::writeJSON(writer, options);
+	GLTF::Object::writeJSON(jsonWriter, options);
 }
 
-void GLTF::MaterialPBR::writeJSON(void* writer, GLTF::Options* options) {
-	rapidjson::Writer<rapidjson::StringBuffer>* jsonWriter = (rapidjson::Writer<rapidjson::StringBuffer>*)writer;
+void GLTF::MaterialPBR::writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options) {
 	if (metallicRoughness) {
 		jsonWriter->Key("pbrMetallicRoughness");
 		jsonWriter->StartObject();
-		metallicRoughness->writeJSON(writer, options);
+		metallicRoughness->writeJSON(jsonWriter, options);
 		jsonWriter->EndObject();
 	}
 	if (emissiveFactor) {
@@ -244,19 +235,19 @@ void GLTF::MaterialPBR::writeJSON(void* writer, GLTF::Options* options) {
 	if (emissiveTexture) {
 		jsonWriter->Key("emissiveTexture");
 		jsonWriter->StartObject();
-		emissiveTexture->writeJSON(writer, options);
+		emissiveTexture->writeJSON(jsonWriter, options);
 		jsonWriter->EndObject();
 	}
 	if (normalTexture) {
 		jsonWriter->Key("normalTexture");
 		jsonWriter->StartObject();
-		normalTexture->writeJSON(writer, options);
+		normalTexture->writeJSON(jsonWriter, options);
 		jsonWriter->EndObject();
 	}
 	if (occlusionTexture) {
 		jsonWriter->Key("occlusionTexture");
 		jsonWriter->StartObject();
-		occlusionTexture->writeJSON(writer, options);
+		occlusionTexture->writeJSON(jsonWriter, options);
 		jsonWriter->EndObject();
 	}
 	if (options->specularGlossiness) {
@@ -264,7 +255,7 @@ void GLTF::MaterialPBR::writeJSON(void* writer, GLTF::Options* options) {
 		jsonWriter->StartObject();
 		jsonWriter->Key("KHR_materials_pbrSpecularGlossiness");
 		jsonWriter->StartObject();
-		specularGlossiness->writeJSON(writer, options);
+		specularGlossiness->writeJSON(jsonWriter, options);
 		jsonWriter->EndObject();
 		jsonWriter->EndObject();
 	}
@@ -284,15 +275,14 @@ void GLTF::MaterialPBR::writeJSON(void* writer, GLTF::Options* options) {
 		jsonWriter->Bool(true);
 	}
 
-	GLTF::Object::writeJSON(writer, options);
+	GLTF::Object::writeJSON(jsonWriter, options);
 }
 
 std::string GLTF::MaterialCommon::Light::typeName() {
 	return "light";
 }
 
-void GLTF::MaterialCommon::Light::writeJSON(void* writer, GLTF::Options* options) {
-	rapidjson::Writer<rapidjson::StringBuffer>* jsonWriter = (rapidjson::Writer<rapidjson::StringBuffer>*)writer;
+void GLTF::MaterialCommon::Light::writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options) {
 	if (type != MaterialCommon::Light::UNKOWN) {
 		switch (type) {
 		case MaterialCommon::Light::DIRECTIONAL:
@@ -328,7 +318,7 @@ void GLTF::MaterialCommon::Light::writeJSON(void* writer, GLTF::Options* options
 		jsonWriter->EndArray();
 		jsonWriter->EndObject();
 	}
-	GLTF::Object::writeJSON(writer, options);
+	GLTF::Object::writeJSON(jsonWriter, options);
 }
 
 GLTF::MaterialCommon::MaterialCommon() {
@@ -475,7 +465,7 @@ GLTF::Material* GLTF::MaterialCommon::getMaterial(std::vector<GLTF::MaterialComm
 				vertexShaderSource += "uniform mat4 u_" + transformName + ";\n";
 				if (light->type == GLTF::MaterialCommon::Light::Type::POINT) {
 					std::string attenuationName = name + "Attenuation";
-					float* attenuation = new float[3];
+					float* attenuation = GLTF::Arena::allocateArray<float>(3);
 					attenuation[0] = light->constantAttenuation;
 					attenuation[1] = light->linearAttenuation;
 					attenuation[2] = light->quadraticAttenuation;
@@ -881,7 +871,10 @@ GLTF::MaterialPBR* GLTF::MaterialCommon::getMaterialPBR(GLTF::Options* options)
 		GLTF::MaterialPBR::Texture* texture = new GLTF::MaterialPBR::Texture();
 		texture->texture = values->emissionTexture;
 		material->emissiveTexture = texture;
-		material->emissiveFactor = new float[3]{ 1.0, 1.0, 1.0 };
+		material->emissiveFactor = GLTF::Arena::allocateArray<float>(3);
+		material->emissiveFactor[0] = 1.0;
+		material->emissiveFactor[1] = 1.0;
+		material->emissiveFactor[2] = 1.0;
 	}
 
 	if (values->ambientTexture) {
@@ -904,7 +897,8 @@ GLTF::MaterialPBR* GLTF::MaterialCommon::getMaterialPBR(GLTF::Options* options)
 				material->specularGlossiness->glossinessFactor = values->shininess;
 			}
 			else {
-				material->specularGlossiness->glossinessFactor = new float[1] {1.0};
+				material->specularGlossiness->glossinessFactor = GLTF::Arena::allocateArray<float>(1);
+				material->specularGlossiness->glossinessFactor[0] = 1.0;
 			}
 		}
 	}
@@ -922,8 +916,7 @@ GLTF::MaterialPBR* GLTF::MaterialCommon::getMaterialPBR(GLTF::Options* options)
 	return material;
 }
 
-void GLTF::MaterialCommon::writeJSON(void* writer, GLTF::Options* options) {
-	rapidjson::Writer<rapidjson::StringBuffer>* jsonWriter = (rapidjson::Writer<rapidjson::StringBuffer>*)writer;
+void GLTF::MaterialCommon::writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options) {
 	jsonWriter->Key("extensions");
 	jsonWriter->StartObject();
 	jsonWriter->Key("KHR_materials_common");
@@ -940,8 +933,8 @@ void GLTF::MaterialCommon::writeJSON(void* writer, GLTF::Options* options) {
 	jsonWriter->String(this->getTechniqueName());
 	jsonWriter->Key("transparent");
 	jsonWriter->Bool(this->transparent);
-	GLTF::Material::writeJSON(writer, options);
+	GLTF::Material::writeJSON(jsonWriter, options);
 	jsonWriter->EndObject();
 	jsonWriter->EndObject();
-	GLTF::Object::writeJSON(writer, options);
+	GLTF::Object::writeJSON(jsonWriter, options);
 }
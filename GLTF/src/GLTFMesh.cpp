@@ -1,8 +1,5 @@
 #include "GLTFMesh.h"
 
-#include "rapidjson/stringbuffer.h"
-#include "rapidjson/writer.h"
-
 std::string GLTF::Mesh::typeName() {
 	return "mesh";
 }
@@ -23,8 +20,7 @@ GLTF::Object* GLTF::Mesh::clone(GLTF::Object* clone) {
 	return mesh;
 }
 
-void GLTF::Mesh::writeJSON(void* writer, GLTF::Options* options) {
-	auto* jsonWriter = static_cast<rapidjson::Writer<rapidjson::StringBuffer>*>(writer);
+void GLTF::Mesh::writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options) {
 	jsonWriter->Key("primitives");
 	jsonWriter->StartArray();
 	for (GLTF::Primitive* primitive : this->primitives) {
@@ -41,5 +37,5 @@ void GLTF::Mesh::writeJSON(void* writer, GLTF::Options* options) {
 		}
 		jsonWriter->EndArray();
 	}
-	GLTF::Object::writeJSON(writer, options);
+	GLTF::Object::writeJSON(jsonWriter, options);
 }
\ No newline at end of file
@@ -2,9 +2,6 @@
 
 #include <cmath>
 
-#include "rapidjson/stringbuffer.h"
-#include "rapidjson/writer.h"
-
 GLTF::Node::TransformMatrix::TransformMatrix() {
 	this->type = GLTF::Node::Transform::MATRIX;
 	this->matrix[0] = 1;
@@ -245,8 +242,7 @@ GLTF::Object* GLTF::Node::clone(GLTF::Object* clone) {
 	return node;
 }
 
-void GLTF::Node::writeJSON(void* writer, GLTF::Options* options) {
-	rapidjson::Writer<rapidjson::StringBuffer>* jsonWriter = (rapidjson::Writer<rapidjson::StringBuffer>*)writer;
+void GLTF::Node::writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options) {
 	
 	if (mesh != NULL) {
 		if (options->version == "1.0") {
@@ -357,5 +353,5 @@ void GLTF::Node::writeJSON(void* writer, GLTF::Options* options) {
 			jsonWriter->Int(camera->id);
 		}
 	}
-	GLTF::Object::writeJSON(writer, options);
+	GLTF::Object::writeJSON(jsonWriter, options);
 }
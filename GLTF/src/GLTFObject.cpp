@@ -1,9 +1,6 @@
 #include "GLTFObject.h"
 #include "GLTFExtension.h"
 
-#include "rapidjson/stringbuffer.h"
-#include "rapidjson/writer.h"
-
 std::string GLTF::Object::getStringId() {
 	if (stringId == "") {
 		return typeName() + "_" + std::to_string(id);
@@ -27,8 +24,7 @@ GLTF::Object* GLTF::Object::clone(GLTF::Object* clone) {
 	return clone;
 }
 
-void GLTF::Object::writeJSON(void* writer, GLTF::Options* options) {
-  rapidjson::Writer<rapidjson::StringBuffer>* jsonWriter = (rapidjson::Writer<rapidjson::StringBuffer>*)writer;
+void GLTF::Object::writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options) {
   if (this->name.length() > 0) {
     jsonWriter->Key("name");
     jsonWriter->String(this->name.c_str());
@@ -39,7 +35,7 @@ void GLTF::Object::writeJSON(void* writer, GLTF::Options* options) {
     for (const auto extension : this->extensions) {
       jsonWriter->Key(extension.first.c_str());
       jsonWriter->StartObject();
-      extension.second->writeJSON(writer, options);
+      extension.second->writeJSON(jsonWriter, options);
       jsonWriter->EndObject();
     }
     jsonWriter->EndObject();
@@ -50,7 +46,7 @@ void GLTF::Object::writeJSON(void* writer, GLTF::Options* options) {
     for (const auto extra : this->extras) {
       jsonWriter->Key(extra.first.c_str());
       jsonWriter->StartObject();
-      extra.second->writeJSON(writer, options);
+      extra.second->writeJSON(jsonWriter, options);
       jsonWriter->EndObject();
     }
     jsonWriter->EndObject();
@@ -1,8 +1,5 @@
 #include "GLTFPrimitive.h"
 
-#include "rapidjson/stringbuffer.h"
-#include "rapidjson/writer.h"
-
 GLTF::Object* GLTF::Primitive::clone(GLTF::Object* clone) {
 	GLTF::Primitive* primitive = dynamic_cast<GLTF::Primitive*>(clone);
 	if (primitive != NULL) {
@@ -22,8 +19,7 @@ GLTF::Object* GLTF::Primitive::clone(GLTF::Object* clone) {
 	return primitive;
 }
 
-void GLTF::Primitive::writeJSON(void* writer, Options* options) {
-	auto* jsonWriter = static_cast<rapidjson::Writer<rapidjson::StringBuffer>*>(writer);
+void GLTF::Primitive::writeJSON(GLTF::JSONWriter* jsonWriter, Options* options) {
 	jsonWriter->Key("attributes");
 	jsonWriter->StartObject();
 	for (const auto& attribute : this->attributes) {
@@ -60,11 +56,11 @@ void GLTF::Primitive::writeJSON(void* writer, Options* options) {
 		jsonWriter->Key("targets");
 		jsonWriter->StartArray();
 		for (auto* target : this->targets) {
-			target->writeJSON(writer, options);
+			target->writeJSON(jsonWriter, options);
 		}
 		jsonWriter->EndArray();
 	}
-	Object::writeJSON(writer, options);
+	Object::writeJSON(jsonWriter, options);
 }
 
 GLTF::Primitive::Target* GLTF::Primitive::Target::clone(Object* clone) {
@@ -78,8 +74,7 @@ GLTF::Primitive::Target* GLTF::Primitive::Target::clone(Object* clone) {
 	return target;
 }
 
-void GLTF::Primitive::Target::writeJSON(void* writer, Options* options) {
-	auto* jsonWriter = static_cast<rapidjson::Writer<rapidjson::StringBuffer>*>(writer);
+void GLTF::Primitive::Target::writeJSON(GLTF::JSONWriter* jsonWriter, Options* options) {
 	jsonWriter->StartObject();
 	for (const auto& attribute : this->attributes) {
 		jsonWriter->Key(attribute.first.c_str());
@@ -1,15 +1,10 @@
 #include "GLTFProgram.h"
 
-#include "rapidjson/stringbuffer.h"
-#include "rapidjson/writer.h"
-
 std::string GLTF::Program::typeName() {
 	return "program";
 }
 
-void GLTF::Program::writeJSON(void* writer, GLTF::Options* options) {
-	rapidjson::Writer<rapidjson::StringBuffer>* jsonWriter = (rapidjson::Writer<rapidjson::StringBuffer>*)writer;
-
+void GLTF::Program::writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options) {
 	jsonWriter->Key("attributes");
 	jsonWriter->StartArray();
 	for (std::string attribute : attributes) {
@@ -35,5 +30,5 @@ void GLTF::Program::writeJSON(void* writer, GLTF::Options* options) {
 			jsonWriter->Int(vertexShader->id);
 		}
 	}
-	GLTF::Object::writeJSON(writer, options);
+	GLTF::Object::writeJSON(jsonWriter, options);
 }
\ No newline at end of file
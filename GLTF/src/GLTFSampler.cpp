@@ -1,14 +1,10 @@
 #include "GLTFSampler.h"
 
-#include "rapidjson/stringbuffer.h"
-#include "rapidjson/writer.h"
-
 std::string GLTF::Sampler::typeName() {
 	return "sampler";
 }
 
-void GLTF::Sampler::writeJSON(void* writer, GLTF::Options* options) {
-	rapidjson::Writer<rapidjson::StringBuffer>* jsonWriter = (rapidjson::Writer<rapidjson::StringBuffer>*)writer;
+void GLTF::Sampler::writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options) {
 	jsonWriter->Key("magFilter");
 	jsonWriter->Int((int)magFilter);
 	jsonWriter->Key("minFilter");
@@ -17,5 +13,5 @@ void GLTF::Sampler::writeJSON(void* writer, GLTF::Options* options) {
 	jsonWriter->Int((int)wrapS);
 	jsonWriter->Key("wrapT");
 	jsonWriter->Int((int)wrapT);
-	GLTF::Object::writeJSON(writer, options);
+	GLTF::Object::writeJSON(jsonWriter, options);
 }
\ No newline at end of file
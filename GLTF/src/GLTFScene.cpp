@@ -1,14 +1,10 @@
 #include "GLTFScene.h"
 
-#include "rapidjson/stringbuffer.h"
-#include "rapidjson/writer.h"
-
 std::string GLTF::Scene::typeName() {
 	return "scene";
 }
 
-void GLTF::Scene::writeJSON(void* writer, GLTF::Options* options) {
-	rapidjson::Writer<rapidjson::StringBuffer>* jsonWriter = (rapidjson::Writer<rapidjson::StringBuffer>*)writer;
+void GLTF::Scene::writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options) {
 	jsonWriter->Key("nodes");
 	jsonWriter->StartArray();
 	for (GLTF::Node* node : this->nodes) {
@@ -20,5 +16,5 @@ void GLTF::Scene::writeJSON(void* writer, GLTF::Options* options) {
 		}
 	}
 	jsonWriter->EndArray();
-	GLTF::Object::writeJSON(writer, options);
+	GLTF::Object::writeJSON(jsonWriter, options);
 }
@@ -1,16 +1,11 @@
 #include "GLTFSkin.h"
 #include "GLTFNode.h"
 
-#include "rapidjson/stringbuffer.h"
-#include "rapidjson/writer.h"
-
 std::string GLTF::Skin::typeName() {
 	return "skin";
 }
 
-void GLTF::Skin::writeJSON(void* writer, GLTF::Options* options) {
-	rapidjson::Writer<rapidjson::StringBuffer>* jsonWriter = (rapidjson::Writer<rapidjson::StringBuffer>*)writer;
-
+void GLTF::Skin::writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options) {
 	if (inverseBindMatrices != NULL) {
 		jsonWriter->Key("inverseBindMatrices");
 		if (options->version == "1.0") {
@@ -42,5 +37,5 @@ void GLTF::Skin::writeJSON(void* writer, GLTF::Options* options) {
 		}
 	}
 	jsonWriter->EndArray();
-	GLTF::Object::writeJSON(writer, options);
+	GLTF::Object::writeJSON(jsonWriter, options);
 }
\ No newline at end of file
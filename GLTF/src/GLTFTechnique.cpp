@@ -1,15 +1,10 @@
 #include "GLTFTechnique.h"
 
-#include "rapidjson/stringbuffer.h"
-#include "rapidjson/writer.h"
-
 std::string GLTF::Technique::typeName() {
 	return "technique";
 }
 
-void GLTF::Technique::writeJSON(void* writer, GLTF::Options* options) {
-	rapidjson::Writer<rapidjson::StringBuffer>* jsonWriter = (rapidjson::Writer<rapidjson::StringBuffer>*)writer;
-
+void GLTF::Technique::writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options) {
 	jsonWriter->Key("attributes");
 	jsonWriter->StartObject();
 	for (auto attribute : attributes) {
@@ -117,5 +112,5 @@ void GLTF::Technique::writeJSON(void* writer, GLTF::Options* options) {
 		}
 		jsonWriter->EndObject();
 	}
-	GLTF::Object::writeJSON(writer, options);
+	GLTF::Object::writeJSON(jsonWriter, options);
 }
\ No newline at end of file
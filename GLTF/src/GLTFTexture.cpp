@@ -1,14 +1,10 @@
 #include "GLTFTexture.h"
 
-#include "rapidjson/stringbuffer.h"
-#include "rapidjson/writer.h"
-
 std::string GLTF::Texture::typeName() {
 	return "texture";
 }
 
-void GLTF::Texture::writeJSON(void* writer, GLTF::Options* options) {
-	rapidjson::Writer<rapidjson::StringBuffer>* jsonWriter = (rapidjson::Writer<rapidjson::StringBuffer>*)writer;
+void GLTF::Texture::writeJSON(GLTF::JSONWriter* jsonWriter, GLTF::Options* options) {
 	if (options->version == "1.0") {
 		jsonWriter->Key("format");
 		jsonWriter->Int((int)GLTF::Constants::WebGL::RGBA);
@@ -33,5 +29,5 @@ void GLTF::Texture::writeJSON(void* writer, GLTF::Options* options) {
 	else {
 		jsonWriter->Int(source->id);
 	}
-	GLTF::Object::writeJSON(writer, options);
+	GLTF::Object::writeJSON(jsonWriter, options);
 }
\ No newline at end of file
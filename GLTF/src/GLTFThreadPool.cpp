@@ -0,0 +1,120 @@
+#include "GLTFThreadPool.h"
+
+#include "GLTFArena.h"
+
+GLTF::ThreadPool::ThreadPool(int threadCount) : _queued(0), _pending(0) {
+	if (threadCount < 1) {
+		threadCount = 1;
+	}
+	for (int i = 0; i < threadCount; i++) {
+		_queues.push_back(new Queue());
+	}
+	for (int i = 0; i < threadCount; i++) {
+		_threads.push_back(std::thread(&GLTF::ThreadPool::run, this, (size_t)i));
+	}
+}
+
+GLTF::ThreadPool::~ThreadPool() {
+	wait();
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_stopping = true;
+	}
+	_condition.notify_all();
+	for (std::thread& thread : _threads) {
+		thread.join();
+	}
+	for (Queue* queue : _queues) {
+		delete queue;
+	}
+}
+
+int GLTF::ThreadPool::getThreadCount() {
+	return (int)_threads.size();
+}
+
+void GLTF::ThreadPool::submit(std::function<void()> task) {
+	// Objects the task creates belong to the same arena as those of the submitting thread
+	GLTF::Arena* arena = GLTF::Arena::current();
+	if (arena != NULL) {
+		task = [arena, task]() {
+			GLTF::Arena::Scope scope(arena);
+			task();
+		};
+	}
+	_pending++;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		Queue* queue = _queues[_nextQueue];
+		_nextQueue = (_nextQueue + 1) % _queues.size();
+		std::lock_guard<std::mutex> queueLock(queue->mutex);
+		queue->tasks.push_back(std::move(task));
+		_queued++;
+	}
+	_condition.notify_all();
+}
+
+bool GLTF::ThreadPool::takeTask(size_t queueIndex, std::function<void()>& task) {
+	size_t queueCount = _queues.size();
+	for (size_t i = 0; i < queueCount; i++) {
+		Queue* queue = _queues[(queueIndex + i) % queueCount];
+		std::lock_guard<std::mutex> lock(queue->mutex);
+		if (!queue->tasks.empty()) {
+			if (i == 0) {
+				task = std::move(queue->tasks.front());
+				queue->tasks.pop_front();
+			}
+			else {
+				// Steal from the opposite end of another worker's queue
+				task = std::move(queue->tasks.back());
+				queue->tasks.pop_back();
+			}
+			_queued--;
+			return true;
+		}
+	}
+	return false;
+}
+
+void GLTF::ThreadPool::finishTask() {
+	if (--_pending == 0) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		_condition.notify_all();
+	}
+}
+
+void GLTF::ThreadPool::run(size_t queueIndex) {
+	while (true) {
+		std::function<void()> task;
+		if (takeTask(queueIndex, task)) {
+			task();
+			finishTask();
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(_mutex);
+		_condition.wait(lock, [this] { return _stopping || _queued > 0; });
+		if (_stopping && _queued == 0) {
+			return;
+		}
+	}
+}
+
+void GLTF::ThreadPool::wait() {
+	while (_pending > 0) {
+		std::function<void()> task;
+		if (takeTask(0, task)) {
+			task();
+			finishTask();
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(_mutex);
+		_condition.wait(lock, [this] { return _pending == 0 || _queued > 0; });
+	}
+}
+
+void GLTF::ThreadPool::parallelFor(size_t count, std::function<void(size_t)> task) {
+	for (size_t i = 0; i < count; i++) {
+		submit([task, i]() { task(i); });
+	}
+	wait();
+}
@@ -0,0 +1,355 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+float MeshOptimizer::computeACMR(const std::vector<unsigned int>& indices, size_t vertexCount, unsigned int cacheSize) {
+	size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0) {
+		return 0;
+	}
+	// A vertex is in the cache if it was pushed less than `cacheSize` pushes ago
+	std::vector<unsigned int> cacheTime(vertexCount, 0);
+	unsigned int timestamp = cacheSize + 1;
+	size_t misses = 0;
+	for (size_t i = 0; i < triangleCount * 3; i++) {
+		unsigned int vertex = indices[i];
+		if (timestamp - cacheTime[vertex] > cacheSize) {
+			cacheTime[vertex] = timestamp++;
+			misses++;
+		}
+	}
+	return (float)misses / triangleCount;
+}
+
+void MeshOptimizer::optimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount, unsigned int cacheSize) {
+	size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0) {
+		return;
+	}
+
+	// Triangles adjacent to each vertex, with `live` counting the ones not emitted yet
+	std::vector<unsigned int> live(vertexCount, 0);
+	for (size_t i = 0; i < triangleCount * 3; i++) {
+		live[indices[i]]++;
+	}
+	std::vector<unsigned int> adjacencyOffsets(vertexCount + 1, 0);
+	for (size_t vertex = 0; vertex < vertexCount; vertex++) {
+		adjacencyOffsets[vertex + 1] = adjacencyOffsets[vertex] + live[vertex];
+	}
+	std::vector<unsigned int> adjacency(triangleCount * 3);
+	std::vector<unsigned int> adjacencyFill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+	for (size_t i = 0; i < triangleCount * 3; i++) {
+		adjacency[adjacencyFill[indices[i]]++] = (unsigned int)(i / 3);
+	}
+
+	std::vector<unsigned int> cacheTime(vertexCount, 0);
+	std::vector<char> emitted(triangleCount, 0);
+	std::vector<unsigned int> deadEndStack;
+	std::vector<unsigned int> candidates;
+	std::vector<unsigned int> output;
+	output.reserve(triangleCount * 3);
+	unsigned int timestamp = cacheSize + 1;
+	size_t cursor = 0;
+
+	long fanningVertex = -1;
+	while (cursor < vertexCount && fanningVertex < 0) {
+		if (live[cursor] > 0) {
+			fanningVertex = (long)cursor;
+		}
+		cursor++;
+	}
+	while (fanningVertex >= 0) {
+		candidates.clear();
+		for (unsigned int a = adjacencyOffsets[fanningVertex]; a < adjacencyOffsets[fanningVertex + 1]; a++) {
+			unsigned int triangle = adjacency[a];
+			if (emitted[triangle]) {
+				continue;
+			}
+			for (size_t k = 0; k < 3; k++) {
+				unsigned int vertex = indices[triangle * 3 + k];
+				output.push_back(vertex);
+				deadEndStack.push_back(vertex);
+				candidates.push_back(vertex);
+				live[vertex]--;
+				if (timestamp - cacheTime[vertex] > cacheSize) {
+					cacheTime[vertex] = timestamp++;
+				}
+			}
+			emitted[triangle] = 1;
+		}
+
+		// Prefer the candidate that stays in the cache the longest once its remaining triangles are emitted
+		fanningVertex = -1;
+		long bestPriority = -1;
+		for (unsigned int vertex : candidates) {
+			if (live[vertex] == 0) {
+				continue;
+			}
+			long priority = 0;
+			if (timestamp - cacheTime[vertex] + 2 * live[vertex] <= cacheSize) {
+				priority = timestamp - cacheTime[vertex];
+			}
+			if (priority > bestPriority) {
+				bestPriority = priority;
+				fanningVertex = vertex;
+			}
+		}
+		if (fanningVertex >= 0) {
+			continue;
+		}
+		// Dead end, fall back to recently used vertices, then to the next vertex in input order
+		while (!deadEndStack.empty()) {
+			unsigned int vertex = deadEndStack.back();
+			deadEndStack.pop_back();
+			if (live[vertex] > 0) {
+				fanningVertex = vertex;
+				break;
+			}
+		}
+		while (fanningVertex < 0 && cursor < vertexCount) {
+			if (live[cursor] > 0) {
+				fanningVertex = (long)cursor;
+			}
+			cursor++;
+		}
+	}
+	std::copy(output.begin(), output.end(), indices.begin());
+}
+
+std::vector<unsigned int> MeshOptimizer::optimizeVertexFetch(std::vector<unsigned int>& indices, size_t vertexCount) {
+	const unsigned int unused = (unsigned int)-1;
+	std::vector<unsigned int> remap(vertexCount, unused);
+	unsigned int nextVertex = 0;
+	for (unsigned int& index : indices) {
+		if (remap[index] == unused) {
+			remap[index] = nextVertex++;
+		}
+		index = remap[index];
+	}
+	for (unsigned int& newIndex : remap) {
+		if (newIndex == unused) {
+			newIndex = nextVertex++;
+		}
+	}
+	return remap;
+}
+
+/**
+ * Pushes the vertices of a triangle through a FIFO cache tracked with timestamps and returns the misses.
+ */
+unsigned int updateCache(const unsigned int* triangle, std::vector<unsigned int>& cacheTime, unsigned int& timestamp, unsigned int cacheSize) {
+	unsigned int misses = 0;
+	for (size_t k = 0; k < 3; k++) {
+		unsigned int vertex = triangle[k];
+		if (timestamp - cacheTime[vertex] > cacheSize) {
+			cacheTime[vertex] = timestamp++;
+			misses++;
+		}
+	}
+	return misses;
+}
+
+/**
+ * Rasterizes triangles into a depth buffer, counting the fragments that pass the depth test.
+ * Triangles are projected orthographically along `axis`, looking down the positive or negative axis.
+ */
+class OverdrawRasterizer {
+public:
+	static const int size = 256;
+	std::vector<float> depth;
+	size_t shaded = 0;
+
+	OverdrawRasterizer() : depth(size * size, std::numeric_limits<float>::infinity()) {}
+
+	void rasterize(const float* a, const float* b, const float* c) {
+		// Counter-clockwise triangles face the viewer
+		float area = (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+		if (area <= 0) {
+			return;
+		}
+		int minX = std::max(0, (int)std::floor(std::min(a[0], std::min(b[0], c[0]))));
+		int maxX = std::min(size - 1, (int)std::ceil(std::max(a[0], std::max(b[0], c[0]))));
+		int minY = std::max(0, (int)std::floor(std::min(a[1], std::min(b[1], c[1]))));
+		int maxY = std::min(size - 1, (int)std::ceil(std::max(a[1], std::max(b[1], c[1]))));
+		for (int y = minY; y <= maxY; y++) {
+			for (int x = minX; x <= maxX; x++) {
+				float px = x + 0.5f;
+				float py = y + 0.5f;
+				float wa = (c[0] - b[0]) * (py - b[1]) - (c[1] - b[1]) * (px - b[0]);
+				float wb = (a[0] - c[0]) * (py - c[1]) - (a[1] - c[1]) * (px - c[0]);
+				float wc = (b[0] - a[0]) * (py - a[1]) - (b[1] - a[1]) * (px - a[0]);
+				if (wa < 0 || wb < 0 || wc < 0) {
+					continue;
+				}
+				float z = (wa * a[2] + wb * b[2] + wc * c[2]) / area;
+				float& stored = depth[y * size + x];
+				if (z < stored) {
+					stored = z;
+					shaded++;
+				}
+			}
+		}
+	}
+
+	size_t getCovered() const {
+		size_t covered = 0;
+		for (float value : depth) {
+			if (value != std::numeric_limits<float>::infinity()) {
+				covered++;
+			}
+		}
+		return covered;
+	}
+};
+
+float MeshOptimizer::computeOverdraw(const std::vector<unsigned int>& indices, const float* positions, size_t vertexCount) {
+	float minimum[3] = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), std::numeric_limits<float>::max()};
+	float maximum[3] = {-std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max()};
+	for (size_t vertex = 0; vertex < vertexCount; vertex++) {
+		for (size_t k = 0; k < 3; k++) {
+			minimum[k] = std::min(minimum[k], positions[vertex * 3 + k]);
+			maximum[k] = std::max(maximum[k], positions[vertex * 3 + k]);
+		}
+	}
+	float extent = std::max(maximum[0] - minimum[0], std::max(maximum[1] - minimum[1], maximum[2] - minimum[2]));
+	if (indices.empty() || !(extent > 0)) {
+		return 1;
+	}
+	float scale = OverdrawRasterizer::size / extent;
+
+	size_t shaded = 0;
+	size_t covered = 0;
+	for (size_t axis = 0; axis < 3; axis++) {
+		for (int direction = 1; direction >= -1; direction -= 2) {
+			// Screen x and y are the two other axes; looking down the negative direction mirrors x to keep handedness
+			size_t u = (axis + 1) % 3;
+			size_t v = (axis + 2) % 3;
+			OverdrawRasterizer rasterizer;
+			float triangle[3][3];
+			for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+				for (size_t k = 0; k < 3; k++) {
+					const float* position = positions + indices[i + k] * 3;
+					float x = (position[u] - minimum[u]) * scale;
+					triangle[k][0] = direction > 0 ? x : OverdrawRasterizer::size - x;
+					triangle[k][1] = (position[v] - minimum[v]) * scale;
+					triangle[k][2] = direction > 0 ? maximum[axis] - position[axis] : position[axis] - minimum[axis];
+				}
+				rasterizer.rasterize(triangle[0], triangle[1], triangle[2]);
+			}
+			shaded += rasterizer.shaded;
+			covered += rasterizer.getCovered();
+		}
+	}
+	if (covered == 0) {
+		return 1;
+	}
+	return (float)shaded / covered;
+}
+
+void MeshOptimizer::optimizeOverdraw(std::vector<unsigned int>& indices, const float* positions, size_t vertexCount, unsigned int cacheSize, float threshold) {
+	size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0) {
+		return;
+	}
+	std::vector<unsigned int> cacheTime(vertexCount, 0);
+	unsigned int timestamp = cacheSize + 1;
+
+	// Hard boundaries where every vertex of a triangle misses the cache, usually a new patch of the mesh
+	std::vector<size_t> hardBoundaries;
+	for (size_t i = 0; i < triangleCount; i++) {
+		unsigned int misses = updateCache(&indices[i * 3], cacheTime, timestamp, cacheSize);
+		if (i == 0 || misses == 3) {
+			hardBoundaries.push_back(i);
+		}
+	}
+
+	// Split each patch further once a prefix reaches the patch ACMR scaled by the threshold
+	std::vector<size_t> boundaries;
+	for (size_t h = 0; h < hardBoundaries.size(); h++) {
+		size_t start = hardBoundaries[h];
+		size_t end = h + 1 < hardBoundaries.size() ? hardBoundaries[h + 1] : triangleCount;
+		timestamp += cacheSize + 1;
+		unsigned int patchMisses = 0;
+		for (size_t i = start; i < end; i++) {
+			patchMisses += updateCache(&indices[i * 3], cacheTime, timestamp, cacheSize);
+		}
+		float patchThreshold = threshold * patchMisses / (end - start);
+
+		boundaries.push_back(start);
+		timestamp += cacheSize + 1;
+		unsigned int runningMisses = 0;
+		unsigned int runningTriangles = 0;
+		for (size_t i = start; i < end; i++) {
+			runningMisses += updateCache(&indices[i * 3], cacheTime, timestamp, cacheSize);
+			runningTriangles++;
+			if ((float)runningMisses / runningTriangles <= patchThreshold) {
+				boundaries.push_back(i + 1);
+				timestamp += cacheSize + 1;
+				runningMisses = 0;
+				runningTriangles = 0;
+			}
+		}
+		// The trailing cluster is usually too small to be efficient, merge it with the previous one
+		if (boundaries.back() != start) {
+			boundaries.pop_back();
+		}
+	}
+
+	float meshCentroid[3] = {0, 0, 0};
+	for (size_t vertex = 0; vertex < vertexCount; vertex++) {
+		for (size_t k = 0; k < 3; k++) {
+			meshCentroid[k] += positions[vertex * 3 + k] / vertexCount;
+		}
+	}
+
+	// Clusters facing away from the center of the mesh are more likely to occlude the rest of it
+	size_t clusterCount = boundaries.size();
+	std::vector<float> sortKeys(clusterCount);
+	for (size_t c = 0; c < clusterCount; c++) {
+		size_t start = boundaries[c];
+		size_t end = c + 1 < clusterCount ? boundaries[c + 1] : triangleCount;
+		float centroid[3] = {0, 0, 0};
+		float normal[3] = {0, 0, 0};
+		float totalArea = 0;
+		for (size_t i = start; i < end; i++) {
+			const float* a = positions + indices[i * 3] * 3;
+			const float* b = positions + indices[i * 3 + 1] * 3;
+			const float* d = positions + indices[i * 3 + 2] * 3;
+			float ab[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+			float ad[3] = {d[0] - a[0], d[1] - a[1], d[2] - a[2]};
+			float cross[3] = {ab[1] * ad[2] - ab[2] * ad[1], ab[2] * ad[0] - ab[0] * ad[2], ab[0] * ad[1] - ab[1] * ad[0]};
+			float area = std::sqrt(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]);
+			for (size_t k = 0; k < 3; k++) {
+				centroid[k] += (a[k] + b[k] + d[k]) / 3 * area;
+				normal[k] += cross[k];
+			}
+			totalArea += area;
+		}
+		float normalLength = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+		float key = 0;
+		if (totalArea > 0 && normalLength > 0) {
+			for (size_t k = 0; k < 3; k++) {
+				key += (centroid[k] / totalArea - meshCentroid[k]) * normal[k] / normalLength;
+			}
+		}
+		sortKeys[c] = key;
+	}
+	std::vector<size_t> order(clusterCount);
+	for (size_t c = 0; c < clusterCount; c++) {
+		order[c] = c;
+	}
+	std::stable_sort(order.begin(), order.end(), [&sortKeys](size_t a, size_t b) {
+		return sortKeys[a] > sortKeys[b];
+	});
+
+	std::vector<unsigned int> output;
+	output.reserve(triangleCount * 3);
+	for (size_t c : order) {
+		size_t start = boundaries[c];
+		size_t end = c + 1 < clusterCount ? boundaries[c + 1] : triangleCount;
+		output.insert(output.end(), indices.begin() + start * 3, indices.begin() + end * 3);
+	}
+	std::copy(output.begin(), output.end(), indices.begin());
+}
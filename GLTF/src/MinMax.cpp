@@ -0,0 +1,154 @@
+#include "MinMax.h"
+#include "MinMaxKernel.h"
+#include "CPUFeatures.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MINMAX_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef MINMAX_SSE2
+struct FloatSSE2 {
+	typedef float Scalar;
+	typedef __m128 Vector;
+	static const int lanes = 4;
+	static Vector load(const Scalar* data) { return _mm_loadu_ps(data); }
+	static void store(Scalar* data, Vector value) { _mm_storeu_ps(data, value); }
+	static Vector min(Vector a, Vector b) { return _mm_min_ps(a, b); }
+	static Vector max(Vector a, Vector b) { return _mm_max_ps(a, b); }
+};
+
+struct ShortSSE2 {
+	typedef short Scalar;
+	typedef __m128i Vector;
+	static const int lanes = 8;
+	static Vector load(const Scalar* data) { return _mm_loadu_si128((const __m128i*)data); }
+	static void store(Scalar* data, Vector value) { _mm_storeu_si128((__m128i*)data, value); }
+	static Vector min(Vector a, Vector b) { return _mm_min_epi16(a, b); }
+	static Vector max(Vector a, Vector b) { return _mm_max_epi16(a, b); }
+};
+
+struct UnsignedByteSSE2 {
+	typedef unsigned char Scalar;
+	typedef __m128i Vector;
+	static const int lanes = 16;
+	static Vector load(const Scalar* data) { return _mm_loadu_si128((const __m128i*)data); }
+	static void store(Scalar* data, Vector value) { _mm_storeu_si128((__m128i*)data, value); }
+	static Vector min(Vector a, Vector b) { return _mm_min_epu8(a, b); }
+	static Vector max(Vector a, Vector b) { return _mm_max_epu8(a, b); }
+};
+
+// SSE2 only compares signed shorts and unsigned bytes, other types flip their sign
+// bit on load and store so the order is preserved by the available comparison.
+struct ByteSSE2 {
+	typedef signed char Scalar;
+	typedef __m128i Vector;
+	static const int lanes = 16;
+	static Vector load(const Scalar* data) { return _mm_xor_si128(_mm_loadu_si128((const __m128i*)data), _mm_set1_epi8((char)0x80)); }
+	static void store(Scalar* data, Vector value) { _mm_storeu_si128((__m128i*)data, _mm_xor_si128(value, _mm_set1_epi8((char)0x80))); }
+	static Vector min(Vector a, Vector b) { return _mm_min_epu8(a, b); }
+	static Vector max(Vector a, Vector b) { return _mm_max_epu8(a, b); }
+};
+
+struct UnsignedShortSSE2 {
+	typedef unsigned short Scalar;
+	typedef __m128i Vector;
+	static const int lanes = 8;
+	static Vector load(const Scalar* data) { return _mm_xor_si128(_mm_loadu_si128((const __m128i*)data), _mm_set1_epi16((short)0x8000)); }
+	static void store(Scalar* data, Vector value) { _mm_storeu_si128((__m128i*)data, _mm_xor_si128(value, _mm_set1_epi16((short)0x8000))); }
+	static Vector min(Vector a, Vector b) { return _mm_min_epi16(a, b); }
+	static Vector max(Vector a, Vector b) { return _mm_max_epi16(a, b); }
+};
+
+struct UnsignedIntSSE2 {
+	typedef unsigned int Scalar;
+	typedef __m128i Vector;
+	static const int lanes = 4;
+	static Vector load(const Scalar* data) { return _mm_xor_si128(_mm_loadu_si128((const __m128i*)data), _mm_set1_epi32((int)0x80000000)); }
+	static void store(Scalar* data, Vector value) { _mm_storeu_si128((__m128i*)data, _mm_xor_si128(value, _mm_set1_epi32((int)0x80000000))); }
+	static Vector min(Vector a, Vector b) {
+		__m128i greater = _mm_cmpgt_epi32(a, b);
+		return _mm_or_si128(_mm_and_si128(greater, b), _mm_andnot_si128(greater, a));
+	}
+	static Vector max(Vector a, Vector b) {
+		__m128i greater = _mm_cmpgt_epi32(a, b);
+		return _mm_or_si128(_mm_and_si128(greater, a), _mm_andnot_si128(greater, b));
+	}
+};
+#endif
+
+bool MinMax::hasAVX2() {
+#ifdef MINMAX_AVX2
+	return CPUFeatures::hasAVX2();
+#else
+	return false;
+#endif
+}
+
+/**
+ * Reduces as many elements as possible with the widest available vector kernel, then
+ * finishes the remaining elements one at a time.
+ */
+template <typename T, typename SSE2Ops>
+void computeElements(const T* data, size_t count, int numberOfComponents, T* min, T* max) {
+	size_t reduced = 0;
+#ifdef MINMAX_AVX2
+	if (MinMax::hasAVX2()) {
+		reduced = MinMax::Kernel::reduceAVX2(data, count, numberOfComponents, min, max);
+	}
+	else
+#endif
+	{
+#ifdef MINMAX_SSE2
+		reduced = MinMax::Kernel::reduce<SSE2Ops>(data, count, numberOfComponents, min, max);
+#endif
+	}
+	if (reduced == 0) {
+		for (int j = 0; j < numberOfComponents; j++) {
+			min[j] = data[j];
+			max[j] = data[j];
+		}
+		reduced = 1;
+	}
+	for (size_t i = reduced; i < count; i++) {
+		const T* element = data + i * numberOfComponents;
+		for (int j = 0; j < numberOfComponents; j++) {
+			min[j] = element[j] < min[j] ? element[j] : min[j];
+			max[j] = element[j] > max[j] ? element[j] : max[j];
+		}
+	}
+}
+
+#ifndef MINMAX_SSE2
+// Scalar builds never instantiate the vector kernels
+typedef void FloatSSE2;
+typedef void ShortSSE2;
+typedef void UnsignedByteSSE2;
+typedef void ByteSSE2;
+typedef void UnsignedShortSSE2;
+typedef void UnsignedIntSSE2;
+#endif
+
+void MinMax::compute(const float* data, size_t count, int numberOfComponents, float* min, float* max) {
+	computeElements<float, FloatSSE2>(data, count, numberOfComponents, min, max);
+}
+
+void MinMax::compute(const signed char* data, size_t count, int numberOfComponents, signed char* min, signed char* max) {
+	computeElements<signed char, ByteSSE2>(data, count, numberOfComponents, min, max);
+}
+
+void MinMax::compute(const unsigned char* data, size_t count, int numberOfComponents, unsigned char* min, unsigned char* max) {
+	computeElements<unsigned char, UnsignedByteSSE2>(data, count, numberOfComponents, min, max);
+}
+
+void MinMax::compute(const short* data, size_t count, int numberOfComponents, short* min, short* max) {
+	computeElements<short, ShortSSE2>(data, count, numberOfComponents, min, max);
+}
+
+void MinMax::compute(const unsigned short* data, size_t count, int numberOfComponents, unsigned short* min, unsigned short* max) {
+	computeElements<unsigned short, UnsignedShortSSE2>(data, count, numberOfComponents, min, max);
+}
+
+void MinMax::compute(const unsigned int* data, size_t count, int numberOfComponents, unsigned int* min, unsigned int* max) {
+	computeElements<unsigned int, UnsignedIntSSE2>(data, count, numberOfComponents, min, max);
+}
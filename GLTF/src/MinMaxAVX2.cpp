@@ -0,0 +1,93 @@
+#include "MinMaxKernel.h"
+
+// Compiled with AVX2 enabled when MINMAX_AVX2 is defined, MinMax::hasAVX2 guards every call.
+// Nothing here may be shared with other translation units, or the linker could pick AVX2 code for them.
+#if defined(MINMAX_AVX2) && (defined(__AVX2__) || defined(_MSC_VER))
+#include <immintrin.h>
+
+namespace {
+	struct FloatAVX2 {
+		typedef float Scalar;
+		typedef __m256 Vector;
+		static const int lanes = 8;
+		static Vector load(const Scalar* data) { return _mm256_loadu_ps(data); }
+		static void store(Scalar* data, Vector value) { _mm256_storeu_ps(data, value); }
+		static Vector min(Vector a, Vector b) { return _mm256_min_ps(a, b); }
+		static Vector max(Vector a, Vector b) { return _mm256_max_ps(a, b); }
+	};
+
+	struct ByteAVX2 {
+		typedef signed char Scalar;
+		typedef __m256i Vector;
+		static const int lanes = 32;
+		static Vector load(const Scalar* data) { return _mm256_loadu_si256((const __m256i*)data); }
+		static void store(Scalar* data, Vector value) { _mm256_storeu_si256((__m256i*)data, value); }
+		static Vector min(Vector a, Vector b) { return _mm256_min_epi8(a, b); }
+		static Vector max(Vector a, Vector b) { return _mm256_max_epi8(a, b); }
+	};
+
+	struct UnsignedByteAVX2 {
+		typedef unsigned char Scalar;
+		typedef __m256i Vector;
+		static const int lanes = 32;
+		static Vector load(const Scalar* data) { return _mm256_loadu_si256((const __m256i*)data); }
+		static void store(Scalar* data, Vector value) { _mm256_storeu_si256((__m256i*)data, value); }
+		static Vector min(Vector a, Vector b) { return _mm256_min_epu8(a, b); }
+		static Vector max(Vector a, Vector b) { return _mm256_max_epu8(a, b); }
+	};
+
+	struct ShortAVX2 {
+		typedef short Scalar;
+		typedef __m256i Vector;
+		static const int lanes = 16;
+		static Vector load(const Scalar* data) { return _mm256_loadu_si256((const __m256i*)data); }
+		static void store(Scalar* data, Vector value) { _mm256_storeu_si256((__m256i*)data, value); }
+		static Vector min(Vector a, Vector b) { return _mm256_min_epi16(a, b); }
+		static Vector max(Vector a, Vector b) { return _mm256_max_epi16(a, b); }
+	};
+
+	struct UnsignedShortAVX2 {
+		typedef unsigned short Scalar;
+		typedef __m256i Vector;
+		static const int lanes = 16;
+		static Vector load(const Scalar* data) { return _mm256_loadu_si256((const __m256i*)data); }
+		static void store(Scalar* data, Vector value) { _mm256_storeu_si256((__m256i*)data, value); }
+		static Vector min(Vector a, Vector b) { return _mm256_min_epu16(a, b); }
+		static Vector max(Vector a, Vector b) { return _mm256_max_epu16(a, b); }
+	};
+
+	struct UnsignedIntAVX2 {
+		typedef unsigned int Scalar;
+		typedef __m256i Vector;
+		static const int lanes = 8;
+		static Vector load(const Scalar* data) { return _mm256_loadu_si256((const __m256i*)data); }
+		static void store(Scalar* data, Vector value) { _mm256_storeu_si256((__m256i*)data, value); }
+		static Vector min(Vector a, Vector b) { return _mm256_min_epu32(a, b); }
+		static Vector max(Vector a, Vector b) { return _mm256_max_epu32(a, b); }
+	};
+}
+
+size_t MinMax::Kernel::reduceAVX2(const float* data, size_t count, int numberOfComponents, float* min, float* max) {
+	return reduce<FloatAVX2>(data, count, numberOfComponents, min, max);
+}
+
+size_t MinMax::Kernel::reduceAVX2(const signed char* data, size_t count, int numberOfComponents, signed char* min, signed char* max) {
+	return reduce<ByteAVX2>(data, count, numberOfComponents, min, max);
+}
+
+size_t MinMax::Kernel::reduceAVX2(const unsigned char* data, size_t count, int numberOfComponents, unsigned char* min, unsigned char* max) {
+	return reduce<UnsignedByteAVX2>(data, count, numberOfComponents, min, max);
+}
+
+size_t MinMax::Kernel::reduceAVX2(const short* data, size_t count, int numberOfComponents, short* min, short* max) {
+	return reduce<ShortAVX2>(data, count, numberOfComponents, min, max);
+}
+
+size_t MinMax::Kernel::reduceAVX2(const unsigned short* data, size_t count, int numberOfComponents, unsigned short* min, unsigned short* max) {
+	return reduce<UnsignedShortAVX2>(data, count, numberOfComponents, min, max);
+}
+
+size_t MinMax::Kernel::reduceAVX2(const unsigned int* data, size_t count, int numberOfComponents, unsigned int* min, unsigned int* max) {
+	return reduce<UnsignedIntAVX2>(data, count, numberOfComponents, min, max);
+}
+#endif
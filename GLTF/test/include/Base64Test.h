@@ -0,0 +1,7 @@
+#pragma once
+
+#include "gtest/gtest.h"
+
+namespace {
+  class Base64Test : public ::testing::Test {};
+}
@@ -0,0 +1,57 @@
+#include <string>
+#include <vector>
+
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+
+#include "Base64.h"
+#include "Base64Test.h"
+#include "GLTFRapidJSONWriter.h"
+
+std::vector<unsigned char> randomBytes(size_t length) {
+  std::vector<unsigned char> data(length);
+  unsigned int seed = 11;
+  for (size_t i = 0; i < length; i++) {
+    seed = seed * 1103515245 + 12345;
+    data[i] = (unsigned char)(seed >> 16);
+  }
+  return data;
+}
+
+TEST_F(Base64Test, Encode_KnownValues) {
+  const char* values[7] = {"", "f", "fo", "foo", "foob", "fooba", "foobar"};
+  const char* expected[7] = {"", "Zg==", "Zm8=", "Zm9v", "Zm9vYg==", "Zm9vYmE=", "Zm9vYmFy"};
+  for (int i = 0; i < 7; i++) {
+    std::string value = values[i];
+    EXPECT_EQ(Base64::encode((const unsigned char*)value.c_str(), value.length()), expected[i]);
+  }
+}
+
+TEST_F(Base64Test, Encode_RoundTrip) {
+  // Covers lengths that end inside and after the vector loops, and every byte value
+  std::vector<unsigned char> data = randomBytes(100003);
+  size_t lengths[9] = {1, 11, 12, 16, 27, 28, 29, 255, 100003};
+  for (size_t length : lengths) {
+    std::string base64 = Base64::encode(data.data(), length);
+    EXPECT_EQ(base64.length(), Base64::encodedLength(length));
+    std::string decoded = Base64::decode(base64);
+    EXPECT_EQ(decoded, std::string(data.begin(), data.begin() + length)) << "length " << length;
+  }
+}
+
+TEST_F(Base64Test, WriteDataUri) {
+  // Longer than a block, so the uri is written in several parts
+  std::vector<unsigned char> data = randomBytes(30001);
+  rapidjson::StringBuffer s;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(s);
+  GLTF::RapidJSONWriter<rapidjson::Writer<rapidjson::StringBuffer>, rapidjson::StringBuffer> jsonWriter(writer, s);
+  jsonWriter.StartObject();
+  jsonWriter.Key("byteLength");
+  jsonWriter.Int(30001);
+  jsonWriter.Key("uri");
+  Base64::writeDataUri(&jsonWriter, "application/octet-stream", data.data(), data.size());
+  jsonWriter.EndObject();
+
+  std::string expected = "{\"byteLength\":30001,\"uri\":\"data:application/octet-stream;base64," + Base64::encode(data.data(), data.size()) + "\"}";
+  EXPECT_EQ(std::string(s.GetString()), expected);
+}
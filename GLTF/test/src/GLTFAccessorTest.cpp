@@ -1,5 +1,11 @@
 #include "GLTFAccessor.h"
 #include "GLTFAccessorTest.h"
+#include "GLTFBufferView.h"
+#include "GLTFOptions.h"
+#include "GLTFRapidJSONWriter.h"
+
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
 
 TEST(GLTFAccessorTest, CreateFromData) {
   float points[12] = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0, 10.0, 11.0, 12.0};
@@ -8,13 +14,13 @@ TEST(GLTFAccessorTest, CreateFromData) {
     (unsigned char*)points, 4,
     GLTF::Constants::WebGL::ARRAY_BUFFER
   );
-  float* min = accessor->min;
+  double* min = accessor->min;
   ASSERT_TRUE(min != NULL);
   EXPECT_EQ(min[0], 1.0);
   EXPECT_EQ(min[1], 2.0);
   EXPECT_EQ(min[2], 3.0);
 
-  float* max = accessor->max;
+  double* max = accessor->max;
   ASSERT_TRUE(max != NULL);
   EXPECT_EQ(max[0], 10.0);
   EXPECT_EQ(max[1], 11.0);
@@ -46,13 +52,13 @@ TEST(GLTFAccessorTest, CreateOnBuffer) {
     bufferView
   );
 
-  float* min = accessor->min;
+  double* min = accessor->min;
   ASSERT_TRUE(min != NULL);
   EXPECT_EQ(min[0], 13.0);
   EXPECT_EQ(min[1], 14.0);
   EXPECT_EQ(min[2], 15.0);
 
-  float* max = accessor->max;
+  double* max = accessor->max;
   ASSERT_TRUE(max != NULL);
   EXPECT_EQ(max[0], 16.0);
   EXPECT_EQ(max[1], 17.0);
@@ -66,3 +72,97 @@ TEST(GLTFAccessorTest, CreateOnBuffer) {
     EXPECT_EQ(component[2], (i + 4) * 3 + 3);
   }
 }
+
+TEST(GLTFAccessorTest, CreateNormalizedFromData) {
+  signed char normals[6] = {127, 0, 0, -64, 90, -127};
+  GLTF::Accessor* accessor = new GLTF::Accessor(GLTF::Accessor::Type::VEC3,
+    GLTF::Constants::WebGL::BYTE,
+    (unsigned char*)normals, 2,
+    GLTF::Constants::WebGL::ARRAY_BUFFER
+  );
+  accessor->normalized = true;
+
+  // min and max hold the stored integer values, not the normalized ones
+  double* min = accessor->min;
+  ASSERT_TRUE(min != NULL);
+  EXPECT_EQ(min[0], -64.0);
+  EXPECT_EQ(min[1], 0.0);
+  EXPECT_EQ(min[2], -127.0);
+
+  double* max = accessor->max;
+  ASSERT_TRUE(max != NULL);
+  EXPECT_EQ(max[0], 127.0);
+  EXPECT_EQ(max[1], 90.0);
+  EXPECT_EQ(max[2], 0.0);
+  delete accessor;
+}
+
+TEST(GLTFAccessorTest, EqualsComparesStoredValues) {
+  // 16777216 and 16777217 are both 2^24 when converted to float
+  unsigned int valuesOne[2] = {16777216, 1};
+  unsigned int valuesTwo[2] = {16777217, 1};
+  GLTF::Accessor* accessorOne = new GLTF::Accessor(GLTF::Accessor::Type::SCALAR,
+    GLTF::Constants::WebGL::UNSIGNED_INT,
+    (unsigned char*)valuesOne, 2,
+    GLTF::Constants::WebGL::ELEMENT_ARRAY_BUFFER
+  );
+  GLTF::Accessor* accessorTwo = new GLTF::Accessor(GLTF::Accessor::Type::SCALAR,
+    GLTF::Constants::WebGL::UNSIGNED_INT,
+    (unsigned char*)valuesTwo, 2,
+    GLTF::Constants::WebGL::ELEMENT_ARRAY_BUFFER
+  );
+  EXPECT_TRUE(accessorOne->equals(accessorOne));
+  EXPECT_FALSE(accessorOne->equals(accessorTwo));
+  delete accessorOne;
+  delete accessorTwo;
+}
+
+TEST(GLTFAccessorTest, WriteJSON_KeepsExactUnsignedIntBounds) {
+  unsigned int values[3] = {16777217, 4294967295u, 16777219};
+  GLTF::Accessor* accessor = new GLTF::Accessor(GLTF::Accessor::Type::SCALAR,
+    GLTF::Constants::WebGL::UNSIGNED_INT,
+    (unsigned char*)values, 3,
+    GLTF::Constants::WebGL::ELEMENT_ARRAY_BUFFER
+  );
+  ASSERT_TRUE(accessor->min != NULL);
+  EXPECT_EQ(accessor->min[0], 16777217.0);
+  EXPECT_EQ(accessor->max[0], 4294967295.0);
+
+  GLTF::Options* options = new GLTF::Options();
+  accessor->bufferView->id = 0;
+  rapidjson::StringBuffer s;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(s);
+  GLTF::RapidJSONWriter<rapidjson::Writer<rapidjson::StringBuffer>, rapidjson::StringBuffer> jsonWriter(writer, s);
+  jsonWriter.StartObject();
+  accessor->writeJSON(&jsonWriter, options);
+  jsonWriter.EndObject();
+  std::string json = s.GetString();
+  EXPECT_NE(json.find("\"max\":[4294967295]"), std::string::npos) << json;
+  EXPECT_NE(json.find("\"min\":[16777217]"), std::string::npos) << json;
+  delete options;
+  delete accessor;
+}
+
+TEST(GLTFAccessorTest, CreateWithDeferredMinMax) {
+  float points[6] = {1.0, 5.0, 3.0, 4.0, 2.0, 6.0};
+  GLTF::Accessor* accessor = new GLTF::Accessor(GLTF::Accessor::Type::VEC3,
+    GLTF::Constants::WebGL::FLOAT,
+    (unsigned char*)points, 2,
+    GLTF::Constants::WebGL::ARRAY_BUFFER,
+    true
+  );
+  EXPECT_TRUE(accessor->min == NULL);
+  EXPECT_TRUE(accessor->max == NULL);
+  EXPECT_TRUE(accessor->minMaxDeferred);
+
+  accessor->computeMinMax();
+  EXPECT_FALSE(accessor->minMaxDeferred);
+  ASSERT_TRUE(accessor->min != NULL);
+  EXPECT_EQ(accessor->min[0], 1.0);
+  EXPECT_EQ(accessor->min[1], 2.0);
+  EXPECT_EQ(accessor->min[2], 3.0);
+  EXPECT_EQ(accessor->max[0], 4.0);
+  EXPECT_EQ(accessor->max[1], 5.0);
+  EXPECT_EQ(accessor->max[2], 6.0);
+  delete accessor;
+}
@@ -0,0 +1,163 @@
+#include "GLTFArena.h"
+#include "GLTFArenaTest.h"
+#include "GLTFAsset.h"
+#include "GLTFThreadPool.h"
+
+class CountedObject : public GLTF::Allocated {
+public:
+  int* destroyed;
+  double value = 0;
+
+  CountedObject(int* destroyed) : destroyed(destroyed) {}
+  ~CountedObject() {
+    (*destroyed)++;
+  }
+};
+
+TEST(GLTFArenaTest, Allocate_FromCurrentArena) {
+  GLTF::Arena* previous = GLTF::Arena::current();
+  GLTF::Arena arena;
+  arena.makeCurrent();
+  EXPECT_EQ(GLTF::Arena::current(), &arena);
+
+  int destroyed = 0;
+  std::vector<CountedObject*> objects;
+  for (int i = 0; i < 10000; i++) {
+    objects.push_back(new CountedObject(&destroyed));
+    objects.back()->value = i;
+  }
+  for (int i = 0; i < 10000; i++) {
+    ASSERT_EQ(objects[i]->value, i);
+    EXPECT_EQ((size_t)objects[i] % alignof(std::max_align_t), 0);
+  }
+  const GLTF::Arena::Statistics& statistics = arena.getStatistics();
+  EXPECT_EQ(statistics.allocations, 10000);
+  EXPECT_EQ(statistics.byteLength, 10000 * sizeof(CountedObject));
+  EXPECT_LT(statistics.blocks, 100);
+
+  arena.release();
+  EXPECT_EQ(destroyed, 10000);
+  EXPECT_EQ(GLTF::Arena::current(), previous);
+}
+
+TEST(GLTFArenaTest, Delete_RunsDestructorOnce) {
+  GLTF::Arena arena;
+  arena.makeCurrent();
+  int destroyed = 0;
+  CountedObject* deleted = new CountedObject(&destroyed);
+  new CountedObject(&destroyed);
+  delete deleted;
+  EXPECT_EQ(destroyed, 1);
+  EXPECT_EQ(arena.getStatistics().deletions, 1);
+
+  arena.release();
+  EXPECT_EQ(destroyed, 2);
+}
+
+TEST(GLTFArenaTest, Release_RestoresArenasOutOfOrder) {
+  GLTF::Arena* previous = GLTF::Arena::current();
+  GLTF::Arena* outer = new GLTF::Arena();
+  GLTF::Arena* inner = new GLTF::Arena();
+  outer->makeCurrent();
+  inner->makeCurrent();
+
+  delete outer;
+  EXPECT_EQ(GLTF::Arena::current(), inner);
+  delete inner;
+  EXPECT_EQ(GLTF::Arena::current(), previous);
+}
+
+TEST(GLTFArenaTest, ThreadPool_AllocatesFromSubmittingArena) {
+  GLTF::ThreadPool pool(4);
+  size_t heapAllocations = GLTF::Arena::getHeapStatistics().allocations;
+  GLTF::Arena* arena = new GLTF::Arena();
+  arena->makeCurrent();
+
+  int destroyed = 0;
+  std::vector<CountedObject*> objects(10000);
+  pool.parallelFor(objects.size(), [&objects, &destroyed](size_t i) {
+    objects[i] = new CountedObject(&destroyed);
+    objects[i]->value = (double)i;
+  });
+  for (size_t i = 0; i < objects.size(); i++) {
+    ASSERT_EQ(objects[i]->value, i);
+  }
+  EXPECT_EQ(arena->getStatistics().allocations, 10000);
+  EXPECT_EQ(GLTF::Arena::getHeapStatistics().allocations, heapAllocations);
+
+  delete arena;
+  EXPECT_EQ(destroyed, 10000);
+  // Workers no longer allocate from the arena once their tasks are done
+  GLTF::Arena* workerArena = arena;
+  pool.parallelFor(1, [&workerArena](size_t i) {
+    workerArena = GLTF::Arena::current();
+  });
+  EXPECT_EQ(workerArena, GLTF::Arena::current());
+}
+
+TEST(GLTFArenaTest, Asset_ReleasesObjectsWithAsset) {
+  GLTF::Arena* previous = GLTF::Arena::current();
+  GLTF::Asset* asset = new GLTF::Asset();
+  // Constructing an asset leaves the current arena alone
+  EXPECT_EQ(GLTF::Arena::current(), previous);
+  {
+    GLTF::Arena::Scope scope(&asset->arena);
+    GLTF::Node* node = new GLTF::Node();
+    node->transform = new GLTF::Node::TransformMatrix();
+    node->mesh = new GLTF::Mesh();
+    asset->getDefaultScene()->nodes.push_back(node);
+  }
+  EXPECT_EQ(GLTF::Arena::current(), previous);
+  // The metadata, sampler and scene of the asset are allocated from it too
+  EXPECT_EQ(asset->arena.getStatistics().allocations, 6);
+
+  delete asset;
+  EXPECT_EQ(GLTF::Arena::current(), previous);
+}
+
+TEST(GLTFArenaTest, Asset_OutlivesEnclosingAsset) {
+  GLTF::Asset* outer = new GLTF::Asset();
+  GLTF::Asset* inner;
+  {
+    GLTF::Arena::Scope scope(&outer->arena);
+    inner = new GLTF::Asset();
+  }
+  // Only the metadata and sampler of the outer asset, the inner asset is not allocated from it
+  EXPECT_EQ(outer->arena.getStatistics().allocations, 2);
+
+  delete outer;
+  EXPECT_EQ(inner->metadata->generator, "COLLADA2GLTF");
+  inner->getDefaultScene();
+  EXPECT_EQ(inner->arena.getStatistics().allocations, 3);
+  delete inner;
+}
+
+TEST(GLTFArenaTest, Asset_AllocatesFromOwnArenaWhileNewerAssetIsAlive) {
+  size_t heapAllocations = GLTF::Arena::getHeapStatistics().allocations;
+  GLTF::Asset* older = new GLTF::Asset();
+  GLTF::Asset* newer = new GLTF::Asset();
+  GLTF::Node* node;
+  {
+    GLTF::Arena::Scope scope(&older->arena);
+    node = new GLTF::Node();
+    node->mesh = new GLTF::Mesh();
+    GLTF::Primitive* primitive = new GLTF::Primitive();
+    node->mesh->primitives.push_back(primitive);
+    float positions[9] = {0, 0, 0, 1, 0, 0, 0, 1, 0};
+    primitive->attributes["POSITION"] = new GLTF::Accessor(GLTF::Accessor::Type::VEC3, GLTF::Constants::WebGL::FLOAT, (unsigned char*)positions, 3, GLTF::Constants::WebGL::ARRAY_BUFFER);
+  }
+  older->getDefaultScene()->nodes.push_back(node);
+  GLTF::Options* options = new GLTF::Options();
+  GLTF::Buffer* buffer = older->packAccessors(options);
+  // The passes allocate from the arena of the asset they run on, not the newest one
+  EXPECT_EQ(newer->arena.getStatistics().allocations, 2);
+
+  delete newer;
+  std::vector<GLTF::Accessor*> accessors = older->getAllAccessors();
+  ASSERT_EQ(accessors.size(), 1);
+  EXPECT_EQ(accessors[0]->bufferView->buffer, buffer);
+  EXPECT_EQ(buffer->byteLength, 36);
+  EXPECT_EQ(GLTF::Arena::getHeapStatistics().allocations, heapAllocations);
+  delete older;
+  delete options;
+}
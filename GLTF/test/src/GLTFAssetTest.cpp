@@ -0,0 +1,246 @@
+#include "GLTFAsset.h"
+#include "GLTFAssetTest.h"
+#include "GLTFRapidJSONWriter.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+
+TEST(GLTFAssetTest, GetAll_SharedObjectsOnce) {
+  GLTF::Asset* asset = new GLTF::Asset();
+  GLTF::Node* root = new GLTF::Node();
+  GLTF::Node* shared = new GLTF::Node();
+  root->children.push_back(shared);
+  root->children.push_back(shared);
+  asset->getDefaultScene()->nodes.push_back(root);
+
+  GLTF::Mesh* mesh = new GLTF::Mesh();
+  shared->mesh = mesh;
+  GLTF::Primitive* primitive = new GLTF::Primitive();
+  mesh->primitives.push_back(primitive);
+  unsigned short indices[3] = {0, 1, 2};
+  primitive->indices = new GLTF::Accessor(GLTF::Accessor::Type::SCALAR, GLTF::Constants::WebGL::UNSIGNED_SHORT, (unsigned char*)indices, 3, GLTF::Constants::WebGL::ELEMENT_ARRAY_BUFFER);
+  primitive->attributes["POSITION"] = new GLTF::Accessor(GLTF::Accessor::Type::VEC3, GLTF::Constants::WebGL::FLOAT);
+  primitive->attributes["NORMAL"] = primitive->attributes["POSITION"];
+
+  GLTF::MaterialPBR* material = new GLTF::MaterialPBR();
+  primitive->material = material;
+  GLTF::Texture* texture = new GLTF::Texture();
+  texture->source = new GLTF::Image("image.png");
+  material->metallicRoughness->baseColorTexture = new GLTF::MaterialPBR::Texture();
+  material->metallicRoughness->baseColorTexture->texture = texture;
+  material->emissiveTexture = new GLTF::MaterialPBR::Texture();
+  material->emissiveTexture->texture = texture;
+
+  EXPECT_EQ(asset->getAllNodes().size(), 2);
+  EXPECT_EQ(asset->getAllMeshes().size(), 1);
+  EXPECT_EQ(asset->getAllPrimitives().size(), 1);
+  EXPECT_EQ(asset->getAllMaterials().size(), 1);
+  EXPECT_EQ(asset->getAllTextures().size(), 1);
+  EXPECT_EQ(asset->getAllImages().size(), 1);
+  std::vector<GLTF::Accessor*> accessors = asset->getAllAccessors();
+  ASSERT_EQ(accessors.size(), 2);
+  EXPECT_EQ(accessors[0], primitive->attributes["POSITION"]);
+  EXPECT_EQ(accessors[1], primitive->indices);
+}
+
+TEST(GLTFAssetTest, GetAll_GatheredAgainAfterInvalidate) {
+  GLTF::Asset* asset = new GLTF::Asset();
+  GLTF::Node* node = new GLTF::Node();
+  asset->getDefaultScene()->nodes.push_back(node);
+  EXPECT_EQ(asset->getAllNodes().size(), 1);
+
+  GLTF::Node* child = new GLTF::Node();
+  child->mesh = new GLTF::Mesh();
+  node->children.push_back(child);
+  // Direct changes are only seen once the asset is invalidated
+  EXPECT_EQ(asset->getAllNodes().size(), 1);
+  EXPECT_EQ(asset->getAllMeshes().size(), 0);
+
+  asset->invalidate();
+  std::vector<GLTF::Node*> nodes = asset->getAllNodes();
+  ASSERT_EQ(nodes.size(), 2);
+  EXPECT_EQ(nodes[0], node);
+  EXPECT_EQ(nodes[1], child);
+  EXPECT_EQ(asset->getAllMeshes().size(), 1);
+}
+
+TEST(GLTFAssetTest, RemoveUnusedNodes_PrunesEmptySubtrees) {
+  GLTF::Asset* asset = new GLTF::Asset();
+  GLTF::Options* options = new GLTF::Options();
+  std::vector<GLTF::Node*>& roots = asset->getDefaultScene()->nodes;
+
+  // A long chain of empty nodes is removed entirely
+  GLTF::Node* chain = new GLTF::Node();
+  GLTF::Node* parent = chain;
+  for (int i = 0; i < 100000; i++) {
+    GLTF::Node* child = new GLTF::Node();
+    parent->children.push_back(child);
+    parent = child;
+  }
+  roots.push_back(chain);
+
+  GLTF::Node* root = new GLTF::Node();
+  GLTF::Node* empty = new GLTF::Node();
+  GLTF::Node* meshNode = new GLTF::Node();
+  meshNode->mesh = new GLTF::Mesh();
+  GLTF::Node* emptyParent = new GLTF::Node();
+  emptyParent->children.push_back(new GLTF::Node());
+  root->children.push_back(empty);
+  root->children.push_back(meshNode);
+  root->children.push_back(emptyParent);
+  roots.push_back(root);
+
+  asset->removeUnusedNodes(options);
+  ASSERT_EQ(roots.size(), 1);
+  EXPECT_EQ(roots[0], root);
+  ASSERT_EQ(root->children.size(), 1);
+  EXPECT_EQ(root->children[0], meshNode);
+  EXPECT_EQ(asset->getAllNodes().size(), 2);
+}
+
+// An asset with attributes that are written as they are, with gaps between elements and interleaved
+GLTF::Asset* createLayoutAsset() {
+  GLTF::Asset* asset = new GLTF::Asset();
+  GLTF::Arena::Scope scope(&asset->arena);
+  GLTF::Node* node = new GLTF::Node();
+  node->mesh = new GLTF::Mesh();
+  asset->getDefaultScene()->nodes.push_back(node);
+  GLTF::Primitive* primitive = new GLTF::Primitive();
+  node->mesh->primitives.push_back(primitive);
+
+  const int count = 10000;
+  std::vector<float> positions(count * 3);
+  std::vector<float> uvs(count * 2);
+  std::vector<unsigned char> colors(count * 3);
+  std::vector<unsigned short> indices(count);
+  for (int i = 0; i < count; i++) {
+    for (int j = 0; j < 3; j++) {
+      positions[i * 3 + j] = (float)(i * 3 + j);
+      colors[i * 3 + j] = (unsigned char)(i + j);
+    }
+    uvs[i * 2] = (float)i / count;
+    uvs[i * 2 + 1] = 1 - (float)i / count;
+    indices[i] = (unsigned short)(count - 1 - i);
+  }
+  primitive->attributes["POSITION"] = new GLTF::Accessor(GLTF::Accessor::Type::VEC3, GLTF::Constants::WebGL::FLOAT, (unsigned char*)positions.data(), count, GLTF::Constants::WebGL::ARRAY_BUFFER);
+  primitive->attributes["TEXCOORD_0"] = new GLTF::Accessor(GLTF::Accessor::Type::VEC2, GLTF::Constants::WebGL::FLOAT, (unsigned char*)uvs.data(), count, GLTF::Constants::WebGL::ARRAY_BUFFER);
+  primitive->attributes["COLOR_0"] = new GLTF::Accessor(GLTF::Accessor::Type::VEC3, GLTF::Constants::WebGL::UNSIGNED_BYTE, colors.data(), count, GLTF::Constants::WebGL::ARRAY_BUFFER);
+  primitive->indices = new GLTF::Accessor(GLTF::Accessor::Type::SCALAR, GLTF::Constants::WebGL::UNSIGNED_SHORT, (unsigned char*)indices.data(), count, GLTF::Constants::WebGL::ELEMENT_ARRAY_BUFFER);
+  return asset;
+}
+
+TEST(GLTFAssetTest, PlanBufferLayout_StreamsPackedBytes) {
+  for (int interleave = 0; interleave < 2; interleave++) {
+    GLTF::Options* options = new GLTF::Options();
+    options->interleave = interleave == 1;
+    GLTF::Asset* packedAsset = createLayoutAsset();
+    GLTF::Buffer* buffer = packedAsset->packAccessors(options);
+
+    GLTF::Asset* streamedAsset = createLayoutAsset();
+    GLTF::BufferLayout* layout = streamedAsset->planBufferLayout(options);
+    ASSERT_EQ(layout->buffer->byteLength, buffer->byteLength);
+    FILE* file = tmpfile();
+    ASSERT_TRUE(file != NULL);
+    EXPECT_TRUE(layout->write(file));
+    ASSERT_EQ(ftell(file), buffer->byteLength);
+    std::vector<unsigned char> streamed(buffer->byteLength);
+    rewind(file);
+    ASSERT_EQ(fread(streamed.data(), 1, streamed.size(), file), streamed.size());
+    fclose(file);
+    EXPECT_EQ(memcmp(streamed.data(), buffer->data, streamed.size()), 0);
+
+    layout->releaseSources();
+    delete layout;
+    delete streamedAsset;
+    delete packedAsset;
+    delete options;
+  }
+}
+
+// Resident set size of the process in bytes, 0 where it can't be read
+size_t residentBytes() {
+#ifdef __linux__
+  size_t pages = 0;
+  size_t residentPages = 0;
+  FILE* file = fopen("/proc/self/statm", "r");
+  if (file == NULL) {
+    return 0;
+  }
+  if (fscanf(file, "%zu %zu", &pages, &residentPages) != 2) {
+    residentPages = 0;
+  }
+  fclose(file);
+  return residentPages * sysconf(_SC_PAGESIZE);
+#else
+  return 0;
+#endif
+}
+
+void convertAsset(GLTF::Options* options) {
+  GLTF::Asset* asset = new GLTF::Asset();
+  {
+    GLTF::Arena::Scope scope(&asset->arena);
+    GLTF::Node* node = new GLTF::Node();
+    node->transform = new GLTF::Node::TransformMatrix();
+    asset->getDefaultScene()->nodes.push_back(node);
+    GLTF::Mesh* mesh = new GLTF::Mesh();
+    node->mesh = mesh;
+    GLTF::Primitive* primitive = new GLTF::Primitive();
+    mesh->primitives.push_back(primitive);
+
+    std::vector<float> positions(4096 * 3);
+    std::vector<unsigned short> indices(4096);
+    for (size_t i = 0; i < indices.size(); i++) {
+      positions[i * 3] = (float)i;
+      indices[i] = (unsigned short)i;
+    }
+    primitive->attributes["POSITION"] = new GLTF::Accessor(GLTF::Accessor::Type::VEC3, GLTF::Constants::WebGL::FLOAT, (unsigned char*)positions.data(), 4096, GLTF::Constants::WebGL::ARRAY_BUFFER);
+    primitive->indices = new GLTF::Accessor(GLTF::Accessor::Type::SCALAR, GLTF::Constants::WebGL::UNSIGNED_SHORT, (unsigned char*)indices.data(), 4096, GLTF::Constants::WebGL::ELEMENT_ARRAY_BUFFER);
+
+    GLTF::MaterialPBR* material = new GLTF::MaterialPBR();
+    primitive->material = material;
+    unsigned char* imageData = (unsigned char*)calloc(65536, 1);
+    GLTF::Texture* texture = new GLTF::Texture();
+    texture->sampler = asset->globalSampler;
+    texture->source = new GLTF::Image("image.png", imageData, 65536, "png");
+    material->metallicRoughness->baseColorTexture = new GLTF::MaterialPBR::Texture();
+    material->metallicRoughness->baseColorTexture->texture = texture;
+  }
+
+  asset->packAccessors(options);
+  rapidjson::StringBuffer s;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(s);
+  GLTF::RapidJSONWriter<rapidjson::Writer<rapidjson::StringBuffer>, rapidjson::StringBuffer> jsonWriter(writer, s);
+  jsonWriter.StartObject();
+  asset->writeJSON(&jsonWriter, options);
+  jsonWriter.EndObject();
+  delete asset;
+}
+
+TEST(GLTFAssetTest, Delete_ReleasesMemoryAcrossConversions) {
+  GLTF::Options* options = new GLTF::Options();
+  options->binary = true;
+  // Let the allocator reach its steady state before measuring
+  for (int i = 0; i < 10; i++) {
+    convertAsset(options);
+  }
+  size_t heapAllocations = GLTF::Arena::getHeapStatistics().allocations;
+  size_t before = residentBytes();
+  for (int i = 0; i < 1000; i++) {
+    convertAsset(options);
+  }
+  // Every object belongs to an asset, none is left on the heap
+  EXPECT_EQ(GLTF::Arena::getHeapStatistics().allocations, heapAllocations);
+  if (before != 0) {
+    // Each conversion allocates more than 150 KiB, leaking any of it grows the process by megabytes
+    EXPECT_LT(residentBytes(), before + 4 * 1024 * 1024);
+  }
+  delete options;
+}
@@ -0,0 +1,93 @@
+#include "GLTFDracoCache.h"
+#include "GLTFDracoCacheTest.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <experimental/filesystem>
+#include <thread>
+#include <vector>
+
+namespace filesystem = std::experimental::filesystem;
+
+std::string cacheDirectory(const std::string& name) {
+  filesystem::path directory = filesystem::temp_directory_path() / ("collada2gltf-" + name);
+  filesystem::remove_all(directory);
+  return directory.generic_string();
+}
+
+TEST(GLTFDracoCacheTest, Load_ReturnsStoredEncoding) {
+  std::string directory = cacheDirectory("draco-cache-load");
+  GLTF::DracoCache cache(directory);
+  unsigned char encoding[256];
+  for (int i = 0; i < 256; i++) {
+    encoding[i] = (unsigned char)i;
+  }
+  cache.store("key", encoding, sizeof(encoding));
+
+  unsigned char* data = NULL;
+  size_t length = 0;
+  ASSERT_TRUE(cache.load("key", &data, &length));
+  ASSERT_EQ(length, sizeof(encoding));
+  EXPECT_EQ(memcmp(data, encoding, length), 0);
+  free(data);
+  EXPECT_FALSE(cache.load("other", &data, &length));
+  filesystem::remove_all(directory);
+}
+
+TEST(GLTFDracoCacheTest, Load_MissesDamagedEncoding) {
+  std::string directory = cacheDirectory("draco-cache-damaged");
+  GLTF::DracoCache cache(directory);
+  std::vector<unsigned char> encoding(1024, 7);
+  unsigned char* data = NULL;
+  size_t length = 0;
+  filesystem::path path = filesystem::path(directory) / "key.drc";
+
+  cache.store("key", encoding.data(), encoding.size());
+  filesystem::resize_file(path, filesystem::file_size(path) - 1);
+  EXPECT_FALSE(cache.load("key", &data, &length));
+
+  cache.store("key", encoding.data(), encoding.size());
+  FILE* file = fopen(path.generic_string().c_str(), "r+b");
+  ASSERT_TRUE(file != NULL);
+  fseek(file, -1, SEEK_END);
+  fputc(8, file);
+  fclose(file);
+  EXPECT_FALSE(cache.load("key", &data, &length));
+  filesystem::remove_all(directory);
+}
+
+TEST(GLTFDracoCacheTest, Store_ConcurrentWritersOfOneKey) {
+  std::string directory = cacheDirectory("draco-cache-concurrent");
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; i++) {
+    threads.push_back(std::thread([directory, i]() {
+      GLTF::DracoCache cache(directory);
+      std::vector<unsigned char> encoding(64 * 1024, (unsigned char)i);
+      for (int j = 0; j < 50; j++) {
+        cache.store("key", encoding.data(), encoding.size());
+      }
+    }));
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  GLTF::DracoCache cache(directory);
+  unsigned char* data = NULL;
+  size_t length = 0;
+  ASSERT_TRUE(cache.load("key", &data, &length));
+  ASSERT_EQ(length, 64 * 1024);
+  // One writer's encoding in full, never a mix of several
+  for (size_t i = 1; i < length; i++) {
+    ASSERT_EQ(data[i], data[0]);
+  }
+  free(data);
+  // Every temporary file was renamed
+  size_t files = 0;
+  for (const filesystem::directory_entry& entry : filesystem::directory_iterator(directory)) {
+    files++;
+  }
+  EXPECT_EQ(files, 1);
+  filesystem::remove_all(directory);
+}
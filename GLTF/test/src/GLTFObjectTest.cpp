@@ -1,10 +1,12 @@
 #include "GLTFObjectTest.h"
 
+#include "rapidjson/prettywriter.h"
 #include "rapidjson/writer.h"
 #include "rapidjson/stringbuffer.h"
 
 #include "GLTFExtension.h"
 #include "GLTFObject.h"
+#include "GLTFRapidJSONWriter.h"
 
 GLTFObjectTest::GLTFObjectTest() {
 	options = new GLTF::Options();
@@ -17,9 +19,10 @@ GLTFObjectTest::~GLTFObjectTest() {
 rapidjson::StringBuffer writeObject(GLTF::Object* object, GLTF::Options* options) {
   rapidjson::StringBuffer s;
   rapidjson::Writer<rapidjson::StringBuffer> writer(s);
-  writer.StartObject();
-  object->writeJSON(&writer, options);
-  writer.EndObject();
+  GLTF::RapidJSONWriter<rapidjson::Writer<rapidjson::StringBuffer>, rapidjson::StringBuffer> jsonWriter(writer, s);
+  jsonWriter.StartObject();
+  object->writeJSON(&jsonWriter, options);
+  jsonWriter.EndObject();
   return s;
 }
 
@@ -29,7 +32,7 @@ TEST_F(GLTFObjectTest, WriteJSON_NoParameters) {
 
   EXPECT_STREQ(s.GetString(), "{}");
 
-  free(object);
+  delete object;
 }
 
 TEST_F(GLTFObjectTest, WriteJSON_WithName) {
@@ -39,7 +42,7 @@ TEST_F(GLTFObjectTest, WriteJSON_WithName) {
 
   EXPECT_STREQ(s.GetString(), "{\"name\":\"test\"}");
 
-  free(object);
+  delete object;
 }
 
 TEST_F(GLTFObjectTest, WriteJSON_WithExtra) {
@@ -51,7 +54,7 @@ TEST_F(GLTFObjectTest, WriteJSON_WithExtra) {
 
   EXPECT_STREQ(s.GetString(), "{\"extras\":{\"extra\":{\"name\":\"extra,extra\"}}}");
 
-  free(object);
+  delete object;
 }
 
 TEST_F(GLTFObjectTest, WriteJSON_WithExtension) {
@@ -62,5 +65,20 @@ TEST_F(GLTFObjectTest, WriteJSON_WithExtension) {
 
   EXPECT_STREQ(s.GetString(), "{\"extensions\":{\"KHR_materials_common\":{}}}");
 
-  free(object);
+  delete object;
+}
+
+TEST_F(GLTFObjectTest, WriteJSON_PrettyWriter) {
+  GLTF::Object* object = new GLTF::Object();
+  object->name = "test";
+  rapidjson::StringBuffer s;
+  rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(s);
+  GLTF::RapidJSONWriter<rapidjson::PrettyWriter<rapidjson::StringBuffer>, rapidjson::StringBuffer> jsonWriter(writer, s);
+  jsonWriter.StartObject();
+  object->writeJSON(&jsonWriter, this->options);
+  jsonWriter.EndObject();
+
+  EXPECT_STREQ(s.GetString(), "{\n    \"name\": \"test\"\n}");
+
+  delete object;
 }
@@ -0,0 +1,71 @@
+#include <algorithm>
+#include <array>
+
+#include "MeshOptimizer.h"
+#include "MeshOptimizerTest.h"
+
+std::vector<unsigned int> createGrid(unsigned int size) {
+  // Triangles are listed column by column, a poor order for a small vertex cache
+  std::vector<unsigned int> indices;
+  for (unsigned int x = 0; x < size; x++) {
+    for (unsigned int y = 0; y < size; y++) {
+      unsigned int corner = y * (size + 1) + x;
+      unsigned int quad[6] = {corner, corner + 1, corner + size + 1, corner + 1, corner + size + 2, corner + size + 1};
+      indices.insert(indices.end(), quad, quad + 6);
+    }
+  }
+  return indices;
+}
+
+std::vector<std::array<unsigned int, 3>> getTriangles(const std::vector<unsigned int>& indices) {
+  std::vector<std::array<unsigned int, 3>> triangles;
+  for (size_t i = 0; i < indices.size(); i += 3) {
+    triangles.push_back({{indices[i], indices[i + 1], indices[i + 2]}});
+  }
+  std::sort(triangles.begin(), triangles.end());
+  return triangles;
+}
+
+TEST(MeshOptimizerTest, ComputeACMR) {
+  std::vector<unsigned int> indices = {0, 1, 2, 2, 1, 3};
+  EXPECT_EQ(MeshOptimizer::computeACMR(indices, 4, 16), 2.0);
+  EXPECT_EQ(MeshOptimizer::computeACMR(indices, 4, 1), 2.5);
+}
+
+TEST(MeshOptimizerTest, OptimizeVertexCache) {
+  unsigned int size = 32;
+  size_t vertexCount = (size + 1) * (size + 1);
+  std::vector<unsigned int> indices = createGrid(size);
+  std::vector<unsigned int> optimized = indices;
+  MeshOptimizer::optimizeVertexCache(optimized, vertexCount, 16);
+
+  EXPECT_EQ(getTriangles(optimized), getTriangles(indices));
+  EXPECT_LT(MeshOptimizer::computeACMR(optimized, vertexCount, 16), MeshOptimizer::computeACMR(indices, vertexCount, 16));
+}
+
+TEST(MeshOptimizerTest, OptimizeVertexFetch) {
+  std::vector<unsigned int> indices = {3, 1, 4, 4, 1, 0};
+  std::vector<unsigned int> remap = MeshOptimizer::optimizeVertexFetch(indices, 6);
+
+  std::vector<unsigned int> expectedIndices = {0, 1, 2, 2, 1, 3};
+  EXPECT_EQ(indices, expectedIndices);
+  // Vertices 2 and 5 are never referenced and are moved to the end
+  std::vector<unsigned int> expectedRemap = {3, 1, 4, 0, 2, 5};
+  EXPECT_EQ(remap, expectedRemap);
+}
+
+TEST(MeshOptimizerTest, OptimizeOverdraw) {
+  // A large quad at z = 0 drawn before a smaller quad in front of it at z = 1, both facing +z
+  float positions[24] = {
+    0, 0, 0, 4, 0, 0, 4, 4, 0, 0, 4, 0,
+    1, 1, 1, 3, 1, 1, 3, 3, 1, 1, 3, 1
+  };
+  std::vector<unsigned int> indices = {0, 1, 2, 0, 2, 3, 4, 5, 6, 4, 6, 7};
+  float before = MeshOptimizer::computeOverdraw(indices, positions, 8);
+  EXPECT_GT(before, 1.0);
+
+  std::vector<unsigned int> optimized = indices;
+  MeshOptimizer::optimizeOverdraw(optimized, positions, 8, 16, 1.05f);
+  EXPECT_EQ(getTriangles(optimized), getTriangles(indices));
+  EXPECT_FLOAT_EQ(MeshOptimizer::computeOverdraw(optimized, positions, 8), 1.0);
+}
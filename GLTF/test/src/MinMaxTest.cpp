@@ -0,0 +1,64 @@
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "MinMax.h"
+#include "MinMaxTest.h"
+
+template <typename T>
+void expectMatchesScalar() {
+  // Covers every element size an accessor can have, and counts that leave a partial vector
+  int componentCounts[6] = {1, 2, 3, 4, 9, 16};
+  size_t counts[5] = {1, 7, 33, 100, 1001};
+  for (int numberOfComponents : componentCounts) {
+    for (size_t count : counts) {
+      std::vector<T> data(count * numberOfComponents);
+      unsigned int seed = 7;
+      for (size_t i = 0; i < data.size(); i++) {
+        seed = seed * 1103515245 + 12345;
+        data[i] = (T)(seed >> 8);
+      }
+      // Put the extremes of the type on the last element, which is reduced outside the vector loop
+      data[data.size() - 1] = std::numeric_limits<T>::lowest();
+      data[0] = std::numeric_limits<T>::max();
+
+      std::vector<T> expectedMin(data.begin(), data.begin() + numberOfComponents);
+      std::vector<T> expectedMax(expectedMin);
+      for (size_t i = 0; i < data.size(); i++) {
+        int component = i % numberOfComponents;
+        expectedMin[component] = std::min(expectedMin[component], data[i]);
+        expectedMax[component] = std::max(expectedMax[component], data[i]);
+      }
+
+      std::vector<T> min(numberOfComponents);
+      std::vector<T> max(numberOfComponents);
+      MinMax::compute(data.data(), count, numberOfComponents, min.data(), max.data());
+      EXPECT_EQ(min, expectedMin) << "components " << numberOfComponents << " count " << count;
+      EXPECT_EQ(max, expectedMax) << "components " << numberOfComponents << " count " << count;
+    }
+  }
+}
+
+TEST(MinMaxTest, Float) {
+  expectMatchesScalar<float>();
+}
+
+TEST(MinMaxTest, Byte) {
+  expectMatchesScalar<signed char>();
+}
+
+TEST(MinMaxTest, UnsignedByte) {
+  expectMatchesScalar<unsigned char>();
+}
+
+TEST(MinMaxTest, Short) {
+  expectMatchesScalar<short>();
+}
+
+TEST(MinMaxTest, UnsignedShort) {
+  expectMatchesScalar<unsigned short>();
+}
+
+TEST(MinMaxTest, UnsignedInt) {
+  expectMatchesScalar<unsigned int>();
+}
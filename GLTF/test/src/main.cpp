@@ -1,5 +1,11 @@
+#include "Base64Test.h"
 #include "GLTFAccessorTest.h"
+#include "GLTFArenaTest.h"
+#include "GLTFAssetTest.h"
+#include "GLTFDracoCacheTest.h"
 #include "GLTFObjectTest.h"
+#include "MeshOptimizerTest.h"
+#include "MinMaxTest.h"
 
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+#include "COLLADAFWUniqueId.h"
+
+namespace COLLADA2GLTF {
+	/**
+	 * Hashes a COLLADA unique id by packing its class, object and file ids into one word. Object ids
+	 * are sequential and class and file ids are small, so the packed word is mixed before use.
+	 */
+	class UniqueIdHash {
+	public:
+		size_t operator()(const COLLADAFW::UniqueId& uniqueId) const {
+			uint64_t packed = (uint64_t)uniqueId.getObjectId() ^ ((uint64_t)uniqueId.getClassId() << 48) ^ ((uint64_t)uniqueId.getFileId() << 40);
+			packed ^= packed >> 33;
+			packed *= 0xFF51AFD7ED558CCDULL;
+			packed ^= packed >> 33;
+			return (size_t)packed;
+		}
+	};
+
+	/**
+	 * A hash table keyed on COLLADA unique ids. Lookups are constant time, but iteration order is
+	 * unspecified, so output must never depend on iterating one.
+	 */
+	template <typename T>
+	using UniqueIdMap = std::unordered_map<COLLADAFW::UniqueId, T, COLLADA2GLTF::UniqueIdHash>;
+}
@@ -6,46 +6,60 @@
 #include "COLLADABU.h"
 #include "COLLADAFW.h"
 #include "GLTFAsset.h"
+#include "GLTFThreadPool.h"
 #include "COLLADA2GLTFOptions.h"
 #include "COLLADA2GLTFExtrasHandler.h"
+#include "COLLADA2GLTFUniqueIdMap.h"
 
 #include "draco/compression/encode.h"
 
 namespace COLLADA2GLTF {
+	class MeshConversion;
+	class MeshPrimitiveSource;
+
 	class Writer : public COLLADAFW::IWriter {
 	private:
 		GLTF::Asset* _asset;
 		COLLADA2GLTF::Options* _options;
 		COLLADA2GLTF::ExtrasHandler* _extrasHandler;
 		GLTF::Node* _rootNode = NULL;
-		float _assetScale;
-		std::map<COLLADAFW::UniqueId, COLLADAFW::UniqueId> _materialEffects;
-		std::map<COLLADAFW::UniqueId, GLTF::Material*> _effectInstances;
-		std::map<COLLADAFW::UniqueId, GLTF::Camera*> _cameraInstances;
-		std::map<COLLADAFW::UniqueId, GLTF::Mesh*> _meshInstances;
-		std::map<COLLADAFW::UniqueId, GLTF::Node*> _nodeInstances;
-		std::map<COLLADAFW::UniqueId, std::vector<GLTF::Node*>> _nodeInstanceTargets;
-		std::map<COLLADAFW::UniqueId, std::map<int, std::set<GLTF::Primitive*>>> _meshMaterialPrimitiveMapping;
-		std::map<COLLADAFW::UniqueId, GLTF::MaterialCommon::Light*> _lightInstances;
-		std::map<COLLADAFW::UniqueId, std::map<GLTF::Primitive*, std::vector<unsigned int>>> _meshPositionMapping;
-		std::map<COLLADAFW::UniqueId, GLTF::Skin*> _skinInstances;
-		std::map<COLLADAFW::UniqueId, GLTF::Node*> _animatedNodes;
-		std::map<COLLADAFW::UniqueId, float> _originalRotationAngles;
+		float _assetScale = 1;
+		COLLADA2GLTF::UniqueIdMap<COLLADAFW::UniqueId> _materialEffects;
+		COLLADA2GLTF::UniqueIdMap<GLTF::Material*> _effectInstances;
+		COLLADA2GLTF::UniqueIdMap<GLTF::Camera*> _cameraInstances;
+		COLLADA2GLTF::UniqueIdMap<GLTF::Mesh*> _meshInstances;
+		COLLADA2GLTF::UniqueIdMap<GLTF::Node*> _nodeInstances;
+		COLLADA2GLTF::UniqueIdMap<std::vector<GLTF::Node*>> _nodeInstanceTargets;
+		COLLADA2GLTF::UniqueIdMap<std::map<int, std::set<GLTF::Primitive*>>> _meshMaterialPrimitiveMapping;
+		COLLADA2GLTF::UniqueIdMap<GLTF::MaterialCommon::Light*> _lightInstances;
+		COLLADA2GLTF::UniqueIdMap<std::map<GLTF::Primitive*, std::vector<unsigned int>>> _meshPositionMapping;
+		COLLADA2GLTF::UniqueIdMap<GLTF::Skin*> _skinInstances;
+		COLLADA2GLTF::UniqueIdMap<GLTF::Node*> _animatedNodes;
+		COLLADA2GLTF::UniqueIdMap<float> _originalRotationAngles;
 		std::map<std::string, std::vector<GLTF::Node*>*> _unboundSkeletonNodes;
 		std::map<std::string, GLTF::Node*> _nodes;
-		std::map<COLLADAFW::UniqueId, std::vector<COLLADAFW::UniqueId>> _skinJointNodes;
-		std::map<COLLADAFW::UniqueId, std::tuple<GLTF::Accessor::Type, std::vector<int*>, std::vector<float*>>> _skinData;
-		std::map<COLLADAFW::UniqueId, GLTF::Mesh*> _skinnedMeshes;
-		std::map<COLLADAFW::UniqueId, GLTF::Image*> _images;
-		std::map<COLLADAFW::UniqueId, std::tuple<std::vector<float>, std::vector<float>>> _animationData;
+		COLLADA2GLTF::UniqueIdMap<std::vector<COLLADAFW::UniqueId>> _skinJointNodes;
+		// The skins each joint node belongs to, with its index in the joints of the skin
+		COLLADA2GLTF::UniqueIdMap<std::vector<std::pair<COLLADAFW::UniqueId, size_t>>> _jointNodeSkins;
+		// Per-vertex joints and weights of each skin, owned by the writer since controllers share them
+		COLLADA2GLTF::UniqueIdMap<std::tuple<GLTF::Accessor::Type, std::vector<int*>, std::vector<float*>>> _skinData;
+		COLLADA2GLTF::UniqueIdMap<GLTF::Mesh*> _skinnedMeshes;
+		COLLADA2GLTF::UniqueIdMap<GLTF::Image*> _images;
+		COLLADA2GLTF::UniqueIdMap<std::tuple<std::vector<float>, std::vector<float>>> _animationData;
+		GLTF::ThreadPool* _threadPool = NULL;
+		std::vector<COLLADA2GLTF::MeshConversion*> _pendingMeshes;
 
 		bool writeNodeToGroup(std::vector<GLTF::Node*>* group, const COLLADAFW::Node* node);
 		bool writeNodesToGroup(std::vector<GLTF::Node*>* group, const COLLADAFW::NodePointerArray& nodes);
 		GLTF::Texture* fromColladaTexture(const COLLADAFW::EffectCommon* effectCommon, COLLADAFW::SamplerID samplerId);
 		GLTF::Texture* fromColladaTexture(const COLLADAFW::EffectCommon* effectCommon, COLLADAFW::Texture texture);
+		bool writeMeshPrimitive(const COLLADA2GLTF::MeshPrimitiveSource* source, GLTF::Primitive* primitive, std::vector<unsigned int>* mapping, float assetScale);
+		bool publishMesh(COLLADA2GLTF::MeshConversion* conversion);
+		bool joinMeshes();
 
 	public:
 		Writer(GLTF::Asset* asset, COLLADA2GLTF::Options* options, COLLADA2GLTF::ExtrasHandler* handler);
+		~Writer();
 
 		/** Deletes the entire scene.
 			 @param errorMessage A message containing informations about the error that occurred.
@@ -125,8 +139,10 @@ namespace COLLADA2GLTF {
 		 @return The writer should return true, if writing succeeded, false otherwise.*/
 		virtual bool writeKinematicsScene(const COLLADAFW::KinematicsScene* kinematicsScene);
 
-		/** Add attributes of mesh to draco compression extension.*/
-		bool addAttributesToDracoMesh(GLTF::Primitive* primitive, const std::map<std::string, std::vector<float>>& buildAttributes, const std::vector<unsigned int>& buildIndices);
+		/** Add attributes of mesh to draco compression extension. The indices and attribute accessors
+		 of the primitive only describe the data, which is not copied outside of the Draco mesh.
+		 Points and lines are passed without indices and become point clouds.*/
+		bool addAttributesToDracoMesh(GLTF::Primitive* primitive, const std::map<std::string, std::vector<float>>& buildAttributes, const std::vector<unsigned int>& buildIndices, unsigned int vertexCount);
 
 		/** Add joint indices and joint weights to draco compression extension.*/
 		bool addControllerDataToDracoMesh(GLTF::Primitive* primitive, unsigned short* jointArray, float* weightArray);
@@ -1,6 +1,11 @@
 #include "COLLADA2GLTFWriter.h"
 
+#include <climits>
+#include <cstdint>
+#include <cstring>
 #include <experimental/filesystem>
+#include <list>
+#include <unordered_map>
 
 #include "Base64.h"
 
@@ -8,7 +13,29 @@ using namespace std::experimental::filesystem;
 
 const double PI = 3.14159;
 
-COLLADA2GLTF::Writer::Writer(GLTF::Asset* asset, COLLADA2GLTF::Options* options, COLLADA2GLTF::ExtrasHandler* extrasHandler) : _asset(asset), _options(options), _extrasHandler(extrasHandler) {}
+COLLADA2GLTF::Writer::Writer(GLTF::Asset* asset, COLLADA2GLTF::Options* options, COLLADA2GLTF::ExtrasHandler* extrasHandler) : _asset(asset), _options(options), _extrasHandler(extrasHandler) {
+	if (options->threads > 1) {
+		_threadPool = new GLTF::ThreadPool(options->threads);
+	}
+}
+
+COLLADA2GLTF::Writer::~Writer() {
+	if (_threadPool != NULL) {
+		_threadPool->wait();
+		delete _threadPool;
+	}
+	for (COLLADA2GLTF::MeshConversion* conversion : _pendingMeshes) {
+		delete conversion;
+	}
+	for (const auto& skinData : _skinData) {
+		for (int* joint : std::get<1>(skinData.second)) {
+			delete[] joint;
+		}
+		for (float* weight : std::get<2>(skinData.second)) {
+			delete[] weight;
+		}
+	}
+}
 
 void COLLADA2GLTF::Writer::cancel(const std::string& errorMessage) {
 
@@ -19,10 +46,12 @@ void COLLADA2GLTF::Writer::start() {
 }
 
 void COLLADA2GLTF::Writer::finish() {
-
+	GLTF::Arena::Scope scope(&_asset->arena);
+	this->joinMeshes();
 }
 
 bool COLLADA2GLTF::Writer::writeGlobalAsset(const COLLADAFW::FileInfo* asset) {
+	GLTF::Arena::Scope scope(&_asset->arena);
 	float assetScale = (float)asset->getUnit().getLinearUnitMeter();
 	_assetScale = assetScale;
 	if (asset->getUpAxisType() == COLLADAFW::FileInfo::X_UP) {
@@ -218,18 +247,15 @@ bool COLLADA2GLTF::Writer::writeNodeToGroup(std::vector<GLTF::Node*>* group, con
 	}
 
 	// Identify and map joint nodes
-	for (auto const& skinNodes : _skinJointNodes) {
-		const COLLADAFW::UniqueId& skinId = skinNodes.first;
-		GLTF::Skin* skin = _skinInstances[skinId];
-		std::vector<COLLADAFW::UniqueId> nodeIds = skinNodes.second;
-		for (size_t i = 0; i < nodeIds.size(); i++) {
-			if (nodeIds[i] == colladaNodeId) {
-				while (i >= skin->joints.size()) {
-					skin->joints.push_back(NULL);
-				}
-				skin->joints[i] = node;
-				break;
+	COLLADA2GLTF::UniqueIdMap<std::vector<std::pair<COLLADAFW::UniqueId, size_t>>>::iterator findJointSkins = _jointNodeSkins.find(colladaNodeId);
+	if (findJointSkins != _jointNodeSkins.end()) {
+		for (const std::pair<COLLADAFW::UniqueId, size_t>& jointSkin : findJointSkins->second) {
+			GLTF::Skin* skin = _skinInstances[jointSkin.first];
+			size_t i = jointSkin.second;
+			while (i >= skin->joints.size()) {
+				skin->joints.push_back(NULL);
 			}
+			skin->joints[i] = node;
 		}
 	}
 
@@ -239,7 +265,7 @@ bool COLLADA2GLTF::Writer::writeNodeToGroup(std::vector<GLTF::Node*>* group, con
 	for (size_t i = 0; i < instanceControllers.getCount(); i++) {
 		COLLADAFW::InstanceController* instanceController = instanceControllers[i];
 		COLLADAFW::UniqueId uniqueId = instanceController->getInstanciatedObjectId();
-		std::map<COLLADAFW::UniqueId, GLTF::Skin*>::iterator iter = _skinInstances.find(uniqueId);
+		COLLADA2GLTF::UniqueIdMap<GLTF::Skin*>::iterator iter = _skinInstances.find(uniqueId);
 		if (iter != _skinInstances.end()) {
 			GLTF::Skin* skin = iter->second;
 			node->skin = skin;
@@ -315,16 +341,20 @@ bool COLLADA2GLTF::Writer::writeNodeToGroup(std::vector<GLTF::Node*>* group, con
 			COLLADAFW::InstanceGeometry* instanceGeometry = instanceGeometries[i];
 			COLLADAFW::MaterialBindingArray& materialBindings = instanceGeometry->getMaterialBindings();
 			const COLLADAFW::UniqueId& objectId = instanceGeometry->getInstanciatedObjectId();
-			std::map<int, std::set<GLTF::Primitive*>> primitiveMaterialMapping = _meshMaterialPrimitiveMapping[objectId];
-			std::map<COLLADAFW::UniqueId, GLTF::Mesh*>::iterator iter = _meshInstances.find(objectId);
+			COLLADA2GLTF::UniqueIdMap<GLTF::Mesh*>::iterator iter = _meshInstances.find(objectId);
 			if (iter != _meshInstances.end()) {
 				GLTF::Mesh* mesh = iter->second;
+				std::map<int, std::set<GLTF::Primitive*>>& primitiveMaterialMapping = _meshMaterialPrimitiveMapping[objectId];
 				for (size_t j = 0; j < materialBindings.getCount(); j++) {
-					COLLADAFW::MaterialBinding materialBinding = materialBindings[j];
+					const COLLADAFW::MaterialBinding& materialBinding = materialBindings[j];
+					std::map<int, std::set<GLTF::Primitive*>>::iterator findPrimitives = primitiveMaterialMapping.find(materialBinding.getMaterialId());
+					if (findPrimitives == primitiveMaterialMapping.end()) {
+						continue;
+					}
 					COLLADAFW::UniqueId materialId = materialBinding.getReferencedMaterial();
 					COLLADAFW::UniqueId effectId = this->_materialEffects[materialId];
 					GLTF::Material* material = _effectInstances[effectId];
-					for (GLTF::Primitive* primitive : primitiveMaterialMapping[materialBinding.getMaterialId()]) {
+					for (GLTF::Primitive* primitive : findPrimitives->second) {
 						if (primitive->material != NULL && primitive->material != material) {
 							// This mesh primitive has a different material from a previous instance, clone the mesh and primitives
 							GLTF::Mesh* cloneMesh = new GLTF::Mesh();
@@ -356,7 +386,7 @@ bool COLLADA2GLTF::Writer::writeNodeToGroup(std::vector<GLTF::Node*>* group, con
 	for (size_t i = 0; i < nodeCount; i++) {
 		COLLADAFW::InstanceNode* instanceNode = instanceNodes[i];
 		const COLLADAFW::UniqueId& instanceNodeId = instanceNode->getInstanciatedObjectId();
-		std::map<COLLADAFW::UniqueId, GLTF::Node*>::iterator iter = _nodeInstances.find(instanceNodeId);
+		COLLADA2GLTF::UniqueIdMap<GLTF::Node*>::iterator iter = _nodeInstances.find(instanceNodeId);
 		if (iter != _nodeInstances.end()) {
 			// Resolve the instance
 			GLTF::Node* cloneNode = new GLTF::Node();
@@ -365,7 +395,7 @@ bool COLLADA2GLTF::Writer::writeNodeToGroup(std::vector<GLTF::Node*>* group, con
 		}
 		else {
 			// We haven't seen this node yet, add a target
-			std::map<COLLADAFW::UniqueId, std::vector<GLTF::Node*>>::iterator iter = _nodeInstanceTargets.find(instanceNodeId);
+			COLLADA2GLTF::UniqueIdMap<std::vector<GLTF::Node*>>::iterator iter = _nodeInstanceTargets.find(instanceNodeId);
 			if (iter == _nodeInstanceTargets.end()) {
 				_nodeInstanceTargets[instanceNodeId] = std::vector<GLTF::Node*>();
 			}
@@ -374,10 +404,9 @@ bool COLLADA2GLTF::Writer::writeNodeToGroup(std::vector<GLTF::Node*>* group, con
 	}
 
 	// Resolve instance nodes that we've seen for this node
-	std::map<COLLADAFW::UniqueId, std::vector<GLTF::Node*>>::iterator findNodeInstanceTargets = _nodeInstanceTargets.find(colladaNodeId);
+	COLLADA2GLTF::UniqueIdMap<std::vector<GLTF::Node*>>::iterator findNodeInstanceTargets = _nodeInstanceTargets.find(colladaNodeId);
 	if (findNodeInstanceTargets != _nodeInstanceTargets.end()) {
-		std::vector<GLTF::Node*> instanceTargets = findNodeInstanceTargets->second;
-		for (GLTF::Node* instanceTarget : instanceTargets) {
+		for (GLTF::Node* instanceTarget : findNodeInstanceTargets->second) {
 			GLTF::Node* cloneNode = new GLTF::Node();
 			node->clone(cloneNode);
 			instanceTarget->children.push_back(cloneNode);
@@ -402,6 +431,10 @@ bool COLLADA2GLTF::Writer::writeNodesToGroup(std::vector<GLTF::Node*>* group, co
 }
 
 bool COLLADA2GLTF::Writer::writeVisualScene(const COLLADAFW::VisualScene* visualScene) {
+	GLTF::Arena::Scope scope(&_asset->arena);
+	if (!this->joinMeshes()) {
+		return false;
+	}
 	GLTF::Asset* asset = this->_asset;
 	GLTF::Scene* scene;
 	if (asset->scene >= 0) {
@@ -423,348 +456,787 @@ bool COLLADA2GLTF::Writer::writeScene(const COLLADAFW::Scene* scene) {
 }
 
 bool COLLADA2GLTF::Writer::writeLibraryNodes(const COLLADAFW::LibraryNodes* libraryNodes) {
+	GLTF::Arena::Scope scope(&_asset->arena);
+	if (!this->joinMeshes()) {
+		return false;
+	}
 	GLTF::Asset* asset = this->_asset;
 	GLTF::Scene* scene = asset->getDefaultScene();
 	return this->writeNodesToGroup(&scene->nodes, libraryNodes->getNodes());
 }
 
-void mapAttributeIndices(const unsigned int* rootIndices, const unsigned* indices, int count, std::string semantic, std::map<std::string, GLTF::Accessor*>* attributes, std::map<std::string, std::map<int, int>>* indicesMapping) {
-	indicesMapping->emplace(semantic, std::map<int, int>());
-	for (int i = 0; i < count; i++) {
-		unsigned int rootIndex = rootIndices[i];
-		unsigned int index = indices[i];
-		if (rootIndex != index) {
-			indicesMapping->at(semantic).emplace(rootIndex, index);
+/**
+ * Values of a <COLLADAFW::MeshVertexData> source, read as floats.
+ *
+ * When `copy` is set the values are copied so that they stay valid after the loader releases the
+ * <COLLADAFW::Mesh>, which is needed when the primitives are converted on the thread pool.
+ */
+class MeshVertexSource {
+public:
+	int stride = -1;
+
+	void load(const COLLADAFW::MeshVertexData& data, bool copy) {
+		if (data.getNumInputInfos() > 0) {
+			stride = (int)data.getStride(0);
+		}
+		size_t count = data.getValuesCount();
+		if (data.getType() == COLLADAFW::FloatOrDoubleArray::DATA_TYPE_DOUBLE) {
+			_doubleValues = data.getDoubleValues()->getData();
+			if (copy) {
+				_doubleCopy.assign(_doubleValues, _doubleValues + count);
+				_doubleValues = _doubleCopy.data();
+			}
+		}
+		else {
+			_floatValues = data.getFloatValues()->getData();
+			if (copy) {
+				_floatCopy.assign(_floatValues, _floatValues + count);
+				_floatValues = _floatCopy.data();
+			}
 		}
 	}
-	attributes->emplace(semantic, (GLTF::Accessor*)NULL);
-}
 
-void mapAttributeIndicesArray(const unsigned int* rootIndices, const COLLADAFW::IndexListArray& indicesArray, int count, std::string baseSemantic, std::map<std::string, GLTF::Accessor*>* attributes, std::map<std::string, std::map<int, int>>* indicesMapping) {
-	int indicesArrayCount = indicesArray.getCount();
-	for (int i = 0; i < indicesArrayCount; i++) {
-		std::string semantic = baseSemantic;
-		if (indicesArrayCount > 1) {
-			semantic += "_" + std::to_string(i);
+	float getValue(size_t index) const {
+		if (_doubleValues != NULL) {
+			return (float)_doubleValues[index];
+		}
+		return _floatValues[index];
+	}
+
+	/**
+	 * Copies `count` consecutive elements starting at element `first` into `output`.
+	 *
+	 * @param first The first element to copy
+	 * @param count The number of elements to copy
+	 * @param stride The number of values between the starts of consecutive elements
+	 * @param numberOfComponents The number of values copied per element
+	 * @param scale Multiplies every copied value
+	 * @param output Receives `count * numberOfComponents` values
+	 */
+	void copyElements(size_t first, size_t count, unsigned int stride, unsigned int numberOfComponents, float scale, float* output) const {
+		if (_doubleValues != NULL) {
+			copyScaledValues(_doubleValues + first * stride, count, stride, numberOfComponents, scale, output);
+		}
+		else {
+			copyScaledValues(_floatValues + first * stride, count, stride, numberOfComponents, scale, output);
 		}
-		mapAttributeIndices(rootIndices, indicesArray[i]->getIndices().getData(), count, semantic, attributes, indicesMapping);
 	}
-}
 
-GLTF::Accessor* bufferAndMapVertexData(GLTF::BufferView* bufferView, GLTF::Accessor::Type type, const COLLADAFW::MeshVertexData& vertexData, std::map<int, int> indicesMapping) {
-	int count = vertexData.getValuesCount();
-	float* floatBuffer = new float[count];
-	COLLADAFW::FloatOrDoubleArray::DataType dataType = vertexData.getType();
+private:
+	const float* _floatValues = NULL;
+	const double* _doubleValues = NULL;
+
+	template <typename T>
+	static void copyScaledValues(const T* values, size_t count, unsigned int stride, unsigned int numberOfComponents, float scale, float* output) {
+		if (stride == numberOfComponents) {
+			// Tightly packed source, a single flat loop the compiler can vectorize
+			size_t length = count * numberOfComponents;
+			for (size_t i = 0; i < length; i++) {
+				output[i] = (float)values[i] * scale;
+			}
+			return;
+		}
+		for (size_t i = 0; i < count; i++) {
+			const T* element = values + i * stride;
+			float* outputElement = output + i * numberOfComponents;
+			for (unsigned int k = 0; k < numberOfComponents; k++) {
+				outputElement[k] = (float)element[k] * scale;
+			}
+		}
+	}
+
+	std::vector<float> _floatCopy;
+	std::vector<double> _doubleCopy;
+};
+
+std::string buildAttributeId(const MeshVertexSource& source, int index, int count) {
+	std::string id;
 	for (int i = 0; i < count; i++) {
-		int index = i;
-		std::map<int, int>::iterator mappedIndex = indicesMapping.find(index);
-		if (mappedIndex != indicesMapping.end()) {
-			index = mappedIndex->second;
-		}
-		switch (dataType) {
-		case COLLADAFW::FloatOrDoubleArray::DATA_TYPE_DOUBLE:
-			floatBuffer[index] = (float)(vertexData.getDoubleValues()->getData()[i]);
-			break;
-		case COLLADAFW::FloatOrDoubleArray::DATA_TYPE_FLOAT:
-			floatBuffer[index] = vertexData.getFloatValues()->getData()[i];
-			break;
-		default:
-			free(floatBuffer);
-			return NULL;
+		id += std::to_string(source.getValue(index * count + i)) + ":";
+	}
+	return id;
+}
+
+/**
+ * Describes how one semantic of a <COLLADAFW::MeshPrimitive> is read and written while building vertices.
+ *
+ * Two corners are equivalent for a semantic when their `buildAttributeId` strings match. Each referenced
+ * COLLADA source element is assigned a class id the first time it is seen, so corners are compared by
+ * integer class ids instead of building and comparing strings for every corner.
+ */
+class VertexSemantic {
+public:
+	std::string semantic;
+	const unsigned int* indices = NULL;
+	const MeshVertexSource* source = NULL;
+	std::vector<float>* output = NULL;
+	unsigned int numberOfComponents = 3;
+	unsigned int stride = 3;
+	bool flipY = false;
+	bool position = false;
+
+	unsigned int getClassId(unsigned int sourceIndex) {
+		if (sourceIndex >= _classIds.size()) {
+			_classIds.resize(sourceIndex + 1, UINT_MAX);
+		}
+		unsigned int classId = _classIds[sourceIndex];
+		if (classId == UINT_MAX) {
+			// The attribute id is built with `numberOfComponents` rather than `stride` to match the existing output
+			std::string attributeId = buildAttributeId(*source, sourceIndex, numberOfComponents);
+			classId = _attributeClasses.emplace(attributeId, (unsigned int)_attributeClasses.size()).first->second;
+			_classIds[sourceIndex] = classId;
 		}
+		return classId;
 	}
-	GLTF::Accessor* accessor = new GLTF::Accessor(type, GLTF::Constants::WebGL::FLOAT, (unsigned char*)floatBuffer, count / GLTF::Accessor::getNumberOfComponents(type), bufferView);
-	free(floatBuffer);
-	return accessor;
+
+	void writeValues(unsigned int sourceIndex, float assetScale) {
+		for (unsigned int k = 0; k < numberOfComponents; k++) {
+			float value = source->getValue(sourceIndex * stride + k);
+			if (flipY && k == 1) {
+				value = 1 - value;
+			}
+			if (position) {
+				value = value * assetScale;
+			}
+			output->push_back(value);
+		}
+	}
+
+private:
+	std::vector<unsigned int> _classIds;
+	std::unordered_map<std::string, unsigned int> _attributeClasses;
+};
+
+/**
+ * Open-addressing hash table from a tuple of per-semantic class ids to the index of the vertex built for it.
+ * Keys are stored flat, `keyLength` class ids per vertex, in the order the vertices were inserted.
+ */
+class VertexHashTable {
+public:
+	VertexHashTable(size_t keyLength) : _keyLength(keyLength), _slots(64, 0) {}
+
+	/** Returns the index of the vertex for `key`, appending a new vertex if it has not been seen before. */
+	unsigned int findOrInsert(const unsigned int* key, bool* inserted) {
+		size_t mask = _slots.size() - 1;
+		size_t slot = hash(key) & mask;
+		while (_slots[slot] != 0) {
+			unsigned int index = _slots[slot] - 1;
+			if (std::equal(key, key + _keyLength, _keys.begin() + index * _keyLength)) {
+				*inserted = false;
+				return index;
+			}
+			slot = (slot + 1) & mask;
+		}
+		unsigned int index = (unsigned int)_count;
+		_keys.insert(_keys.end(), key, key + _keyLength);
+		_slots[slot] = index + 1;
+		_count++;
+		if (_count * 2 > _slots.size()) {
+			grow();
+		}
+		*inserted = true;
+		return index;
+	}
+
+private:
+	size_t _keyLength;
+	size_t _count = 0;
+	std::vector<unsigned int> _keys;
+	std::vector<unsigned int> _slots;
+
+	size_t hash(const unsigned int* key) const {
+		uint64_t hash = 0x9E3779B97F4A7C15ULL;
+		for (size_t i = 0; i < _keyLength; i++) {
+			hash ^= key[i];
+			hash *= 0xFF51AFD7ED558CCDULL;
+			hash ^= hash >> 32;
+		}
+		return (size_t)hash;
+	}
+
+	void grow() {
+		std::vector<unsigned int> slots(_slots.size() * 2, 0);
+		size_t mask = slots.size() - 1;
+		for (size_t index = 0; index < _count; index++) {
+			size_t slot = hash(&_keys[index * _keyLength]) & mask;
+			while (slots[slot] != 0) {
+				slot = (slot + 1) & mask;
+			}
+			slots[slot] = (unsigned int)index + 1;
+		}
+		_slots.swap(slots);
+	}
+};
+
+/**
+ * Checks whether every semantic of a primitive uses the same index list and the indices densely cover the
+ * range of source elements they reference. In that case each referenced source element is already one glTF
+ * vertex and the attributes can be copied without building vertices corner by corner.
+ *
+ * @param vertexSemantics The semantics of the primitive
+ * @param count The number of corners in the primitive
+ * @param firstIndex Receives the smallest referenced source index
+ * @param vertexCount Receives the number of referenced source elements
+ * @return `true` if the primitive is index-aligned
+ */
+bool isIndexAligned(const std::vector<VertexSemantic>& vertexSemantics, size_t count, unsigned int* firstIndex, unsigned int* vertexCount) {
+	if (count == 0 || vertexSemantics.empty()) {
+		return false;
+	}
+	const unsigned int* indices = vertexSemantics[0].indices;
+	for (size_t k = 1; k < vertexSemantics.size(); k++) {
+		if (!std::equal(indices, indices + count, vertexSemantics[k].indices)) {
+			return false;
+		}
+	}
+	unsigned int minIndex = *std::min_element(indices, indices + count);
+	unsigned int maxIndex = *std::max_element(indices, indices + count);
+	size_t range = (size_t)maxIndex - minIndex + 1;
+	if (range > count) {
+		return false;
+	}
+	std::vector<char> referenced(range, 0);
+	size_t referencedCount = 0;
+	for (size_t j = 0; j < count; j++) {
+		char& seen = referenced[indices[j] - minIndex];
+		if (!seen) {
+			seen = 1;
+			referencedCount++;
+		}
+	}
+	if (referencedCount != range) {
+		return false;
+	}
+	*firstIndex = minIndex;
+	*vertexCount = (unsigned int)range;
+	return true;
 }
 
-float getMeshVertexDataAtIndex(const COLLADAFW::MeshVertexData& data, int index) {
-	COLLADAFW::FloatOrDoubleArray::DataType type = data.getType();
-	if (type == COLLADAFW::FloatOrDoubleArray::DATA_TYPE_DOUBLE) {
-		return (float)data.getDoubleValues()->getData()[index];
+/**
+ * Writes the attributes of an index-aligned primitive by copying the referenced range of each source.
+ *
+ * @param vertexSemantics The semantics of the primitive
+ * @param firstIndex The first referenced source element
+ * @param vertexCount The number of referenced source elements
+ * @param assetScale The scale applied to positions
+ */
+void writeAlignedValues(std::vector<VertexSemantic>& vertexSemantics, unsigned int firstIndex, unsigned int vertexCount, float assetScale) {
+	for (VertexSemantic& vertexSemantic : vertexSemantics) {
+		unsigned int numberOfComponents = vertexSemantic.numberOfComponents;
+		std::vector<float>* output = vertexSemantic.output;
+		output->resize((size_t)vertexCount * numberOfComponents);
+		float scale = vertexSemantic.position ? assetScale : 1;
+		vertexSemantic.source->copyElements(firstIndex, vertexCount, vertexSemantic.stride, numberOfComponents, scale, output->data());
+		if (vertexSemantic.flipY) {
+			float* values = output->data();
+			for (size_t i = 1; i < output->size(); i += numberOfComponents) {
+				values[i] = 1 - values[i];
+			}
+		}
 	}
-	return data.getFloatValues()->getData()[index];
 }
 
-std::string buildAttributeId(const COLLADAFW::MeshVertexData& data, int index, int count) {
-	std::string id;
-	for (int i = 0; i < count; i++) {
-		id += std::to_string(getMeshVertexDataAtIndex(data, index * count + i)) + ":";
+/**
+ * The indices of one semantic of a <COLLADAFW::MeshPrimitive> and the source they reference.
+ */
+class MeshSemanticSource {
+public:
+	const unsigned int* indices = NULL;
+	const MeshVertexSource* source = NULL;
+};
+
+/**
+ * The parts of a <COLLADAFW::MeshPrimitive> needed to build a <GLTF::Primitive>.
+ * Indices are copied when the primitive is converted after the loader releases the <COLLADAFW::Mesh>.
+ */
+class COLLADA2GLTF::MeshPrimitiveSource {
+public:
+	size_t count = 0;
+	bool shouldTriangulate = false;
+	std::map<std::string, MeshSemanticSource> semantics;
+	std::vector<int> faceVertexCounts;
+
+	void addSemantic(std::string semantic, const COLLADAFW::UIntValuesArray& indices, const MeshVertexSource* source, bool copy) {
+		MeshSemanticSource semanticSource;
+		semanticSource.indices = indices.getData();
+		semanticSource.source = source;
+		if (copy) {
+			_indexCopies.push_back(std::vector<unsigned int>(semanticSource.indices, semanticSource.indices + indices.getCount()));
+			semanticSource.indices = _indexCopies.back().data();
+		}
+		semantics[semantic] = semanticSource;
+	}
+
+	int getFaceVertexCount(size_t face) const {
+		if (face < faceVertexCounts.size()) {
+			return faceVertexCounts[face];
+		}
+		return 0;
+	}
+
+private:
+	std::list<std::vector<unsigned int>> _indexCopies;
+};
+
+/**
+ * Triangulates the polygons of a primitive as a fan around the first corner of each polygon.
+ *
+ * @param source The COLLADA primitive data, providing the number of corners in each polygon
+ * @param corners The glTF vertex index of each corner
+ * @param buildIndices Receives the triangle indices
+ */
+void triangulatePolygons(const COLLADA2GLTF::MeshPrimitiveSource* source, const std::vector<unsigned int>& corners, std::vector<unsigned int>* buildIndices) {
+	unsigned int face = 0;
+	unsigned int startFace = 0;
+	unsigned int totalVertexCount = 0;
+	unsigned int vertexCount = 0;
+	unsigned int faceVertexCount = source->getFaceVertexCount(face);
+	for (size_t j = 0; j < corners.size(); j++) {
+		// This approach is very efficient in terms of runtime, but there are more correct solutions that may be worth considering.
+		// Using a 3D variant of Fortune's Algorithm or something similar to compute a mesh with no overlapping triangles would be ideal.
+		if (vertexCount >= faceVertexCount) {
+			unsigned int end = buildIndices->size() - 1;
+			if (faceVertexCount > 3) {
+				// Make a triangle with the last two points and the first one
+				buildIndices->push_back((*buildIndices)[end - 1]);
+				buildIndices->push_back((*buildIndices)[end]);
+				buildIndices->push_back((*buildIndices)[startFace]);
+				totalVertexCount += 3;
+			}
+			face++;
+			faceVertexCount = source->getFaceVertexCount(face);
+			startFace = totalVertexCount;
+			vertexCount = 0;
+		}
+		else if (vertexCount >= 3) {
+			// Add the previous two points to complete the triangle
+			unsigned int end = buildIndices->size() - 1;
+			buildIndices->push_back((*buildIndices)[end - 1]);
+			buildIndices->push_back((*buildIndices)[end]);
+			totalVertexCount += 2;
+		}
+		buildIndices->push_back(corners[j]);
+		totalVertexCount++;
+		vertexCount++;
+	}
+	if (faceVertexCount > 3) {
+		// Close the last polyshape
+		int end = buildIndices->size() - 1;
+		buildIndices->push_back((*buildIndices)[end - 1]);
+		buildIndices->push_back((*buildIndices)[end]);
+		buildIndices->push_back((*buildIndices)[startFace]);
 	}
-	return id;
 }
 
+/**
+ * A <COLLADAFW::Mesh> being converted to a <GLTF::Mesh>. Each primitive is converted independently and
+ * the results are published to the writer in order once all of them have completed.
+ */
+class COLLADA2GLTF::MeshConversion {
+public:
+	COLLADAFW::UniqueId uniqueId;
+	GLTF::Mesh* mesh = NULL;
+	float assetScale = 1;
+	MeshVertexSource positions;
+	MeshVertexSource normals;
+	MeshVertexSource binormals;
+	MeshVertexSource tangents;
+	MeshVertexSource uvCoords;
+	MeshVertexSource colors;
+	std::vector<COLLADA2GLTF::MeshPrimitiveSource*> sources;
+	std::vector<GLTF::Primitive*> primitives;
+	std::vector<std::vector<unsigned int>> mappings;
+	// Written concurrently by the primitive tasks, so this can't be a packed std::vector<bool>
+	std::vector<char> results;
+	std::map<int, std::set<GLTF::Primitive*>> primitiveMaterialMapping;
+
+	~MeshConversion() {
+		for (COLLADA2GLTF::MeshPrimitiveSource* source : sources) {
+			delete source;
+		}
+	}
+};
+
 /**
  * Converts and writes a <COLLADAFW::Mesh> to a <GLTF::Mesh>.
  * The produced meshes are stored in `this->_meshInstances` indexed by their <COLLADAFW::UniqueId>.
  *
  * COLLADA has different sets of indices per attribute in primitives while glTF uses a single indices
  * accessor for a primitive and requires attributes to be aligned. Attributes are built using the
- * the COLLADA indices, and duplicate attributes are referenced by index.
+ * the COLLADA indices, and duplicate attributes are referenced by index. Primitives where every semantic
+ * shares one index list are copied directly instead, see `isIndexAligned`.
+ *
+ * When `threads` is greater than one, the data used by the primitives is copied and they are converted
+ * on the thread pool. The accessors the workers create are allocated from the asset's arena, which the
+ * pool makes current for each task. The mesh is published by `joinMeshes` before anything reads
+ * `_meshInstances`.
  *
  * @param colladaMesh The COLLADA mesh to write to glTF
  * @return `true` if the operation completed succesfully, `false` if an error occured
  */
 bool COLLADA2GLTF::Writer::writeMesh(const COLLADAFW::Mesh* colladaMesh) {
+	GLTF::Arena::Scope scope(&_asset->arena);
+	bool deferred = _threadPool != NULL;
+	COLLADA2GLTF::MeshConversion* conversion = new COLLADA2GLTF::MeshConversion();
 	GLTF::Mesh* mesh = new GLTF::Mesh();
 	mesh->name = colladaMesh->getName();
 	mesh->stringId = colladaMesh->getOriginalId();
 	if (mesh->name == "") {
 		mesh->name = colladaMesh->getOriginalId();
 	}
-	const COLLADAFW::UniqueId& uniqueId = colladaMesh->getUniqueId();
-	std::map<GLTF::Primitive*, std::vector<unsigned int>> positionMapping;
+	conversion->mesh = mesh;
+	conversion->uniqueId = colladaMesh->getUniqueId();
+	conversion->assetScale = _assetScale;
+	conversion->positions.load(colladaMesh->getPositions(), deferred);
+	conversion->normals.load(colladaMesh->getNormals(), deferred);
+	conversion->binormals.load(colladaMesh->getBinormals(), deferred);
+	conversion->tangents.load(colladaMesh->getTangents(), deferred);
+	conversion->uvCoords.load(colladaMesh->getUVCoords(), deferred);
+	conversion->colors.load(colladaMesh->getColors(), deferred);
 
 	const COLLADAFW::MeshPrimitiveArray& meshPrimitives = colladaMesh->getMeshPrimitives();
-	std::map<int, std::set<GLTF::Primitive*>> primitiveMaterialMapping;
+	std::map<int, std::set<GLTF::Primitive*>>& primitiveMaterialMapping = conversion->primitiveMaterialMapping;
 	size_t meshPrimitivesCount = meshPrimitives.getCount();
-	if (meshPrimitivesCount > 0) {
-		// Create primitives
-		for (size_t i = 0; i < meshPrimitivesCount; i++) {
-			std::map<std::string, std::vector<float>> buildAttributes;
-			std::map<std::string, unsigned int> attributeIndicesMapping;
-			std::vector<unsigned int> buildIndices;
-			COLLADAFW::MeshPrimitive* colladaPrimitive = meshPrimitives[i];
-			GLTF::Primitive* primitive = new GLTF::Primitive();
-
-			int materialId = colladaPrimitive->getMaterialId();
-			std::map<int, std::set<GLTF::Primitive*>>::iterator findPrimitiveSet = primitiveMaterialMapping.find(materialId);
-			if (findPrimitiveSet != primitiveMaterialMapping.end()) {
-				findPrimitiveSet->second.insert(primitive);
-			}
-			else {
-				std::set<GLTF::Primitive*> primitiveSet;
-				primitiveSet.insert(primitive);
-				primitiveMaterialMapping[materialId] = primitiveSet;
-			}
-
-			std::vector<unsigned int> mapping;
-			bool shouldTriangulate = false;
+	conversion->mappings.resize(meshPrimitivesCount);
+	conversion->results.resize(meshPrimitivesCount, true);
+	for (size_t i = 0; i < meshPrimitivesCount; i++) {
+		COLLADAFW::MeshPrimitive* colladaPrimitive = meshPrimitives[i];
+		COLLADA2GLTF::MeshPrimitiveSource* source = new COLLADA2GLTF::MeshPrimitiveSource();
+		GLTF::Primitive* primitive = new GLTF::Primitive();
+		conversion->sources.push_back(source);
+		conversion->primitives.push_back(primitive);
+
+		int materialId = colladaPrimitive->getMaterialId();
+		std::map<int, std::set<GLTF::Primitive*>>::iterator findPrimitiveSet = primitiveMaterialMapping.find(materialId);
+		if (findPrimitiveSet != primitiveMaterialMapping.end()) {
+			findPrimitiveSet->second.insert(primitive);
+		}
+		else {
+			std::set<GLTF::Primitive*> primitiveSet;
+			primitiveSet.insert(primitive);
+			primitiveMaterialMapping[materialId] = primitiveSet;
+		}
 
-			COLLADAFW::MeshPrimitive::PrimitiveType type = colladaPrimitive->getPrimitiveType();
-			switch (colladaPrimitive->getPrimitiveType()) {
-			case COLLADAFW::MeshPrimitive::LINES:
-				primitive->mode = GLTF::Primitive::Mode::LINES;
-				break;
-			case COLLADAFW::MeshPrimitive::LINE_STRIPS:
-				primitive->mode = GLTF::Primitive::Mode::LINE_STRIP;
-				break;
-			// Having POLYLIST and POLYGONS map to TRIANGLES produces good output for cases where the polygons are already triangles,
-			// but in other cases, we may need to triangulate
-			case COLLADAFW::MeshPrimitive::POLYLIST:
-			case COLLADAFW::MeshPrimitive::POLYGONS:
-				shouldTriangulate = true;
-			case COLLADAFW::MeshPrimitive::TRIANGLES:
-				primitive->mode = GLTF::Primitive::Mode::TRIANGLES;
-				break;
-			case COLLADAFW::MeshPrimitive::TRIANGLE_STRIPS:
-				primitive->mode = GLTF::Primitive::Mode::TRIANGLE_STRIP;
-				break;
-			case COLLADAFW::MeshPrimitive::TRIANGLE_FANS:
-				primitive->mode = GLTF::Primitive::Mode::TRIANGLE_FAN;
-				break;
-			case COLLADAFW::MeshPrimitive::POINTS:
-				primitive->mode = GLTF::Primitive::Mode::POINTS;
-				break;
-				primitive->mode = GLTF::Primitive::Mode::TRIANGLES;
-				break;
-			}
+		switch (colladaPrimitive->getPrimitiveType()) {
+		case COLLADAFW::MeshPrimitive::LINES:
+			primitive->mode = GLTF::Primitive::Mode::LINES;
+			break;
+		case COLLADAFW::MeshPrimitive::LINE_STRIPS:
+			primitive->mode = GLTF::Primitive::Mode::LINE_STRIP;
+			break;
+		// Having POLYLIST and POLYGONS map to TRIANGLES produces good output for cases where the polygons are already triangles,
+		// but in other cases, we may need to triangulate
+		case COLLADAFW::MeshPrimitive::POLYLIST:
+		case COLLADAFW::MeshPrimitive::POLYGONS:
+			source->shouldTriangulate = true;
+		case COLLADAFW::MeshPrimitive::TRIANGLES:
+			primitive->mode = GLTF::Primitive::Mode::TRIANGLES;
+			break;
+		case COLLADAFW::MeshPrimitive::TRIANGLE_STRIPS:
+			primitive->mode = GLTF::Primitive::Mode::TRIANGLE_STRIP;
+			break;
+		case COLLADAFW::MeshPrimitive::TRIANGLE_FANS:
+			primitive->mode = GLTF::Primitive::Mode::TRIANGLE_FAN;
+			break;
+		case COLLADAFW::MeshPrimitive::POINTS:
+			primitive->mode = GLTF::Primitive::Mode::POINTS;
+			break;
+			primitive->mode = GLTF::Primitive::Mode::TRIANGLES;
+			break;
+		}
 
-			if (primitive->mode == GLTF::Primitive::Mode::UNKNOWN) {
-				continue;
-			}
-			size_t count = colladaPrimitive->getPositionIndices().getCount();
-			std::map<std::string, const unsigned int*> semanticIndices;
-			std::map<std::string, const COLLADAFW::MeshVertexData*> semanticData;
-			std::string semantic = "POSITION";
-			buildAttributes[semantic] = std::vector<float>();
-			semanticIndices[semantic] = colladaPrimitive->getPositionIndices().getData();
-			semanticData[semantic] = &colladaMesh->getPositions();
-			primitive->attributes[semantic] = (GLTF::Accessor*)NULL;
-			if (colladaPrimitive->hasNormalIndices()) {
-				semantic = "NORMAL";
-				buildAttributes[semantic] = std::vector<float>();
-				semanticIndices[semantic] = colladaPrimitive->getNormalIndices().getData();
-				semanticData[semantic] = &colladaMesh->getNormals();
-				primitive->attributes[semantic] = (GLTF::Accessor*)NULL;
-			}
-			if (colladaPrimitive->hasBinormalIndices()) {
-				semantic = "BINORMAL";
-				buildAttributes[semantic] = std::vector<float>();
-				semanticIndices[semantic] = colladaPrimitive->getBinormalIndices().getData();
-				semanticData[semantic] = &colladaMesh->getBinormals();
-				primitive->attributes[semantic] = (GLTF::Accessor*)NULL;
-			}
-			if (colladaPrimitive->hasTangentIndices()) {
-				semantic = "TANGENT";
-				buildAttributes[semantic] = std::vector<float>();
-				semanticIndices[semantic] = colladaPrimitive->getTangentIndices().getData();
-				semanticData[semantic] = &colladaMesh->getTangents();
-				primitive->attributes[semantic] = (GLTF::Accessor*)NULL;
+		if (primitive->mode == GLTF::Primitive::Mode::UNKNOWN) {
+			continue;
+		}
+		source->count = colladaPrimitive->getPositionIndices().getCount();
+		if (source->shouldTriangulate) {
+			size_t faceCount = colladaPrimitive->getGroupedVertexElementsCount();
+			for (size_t face = 0; face < faceCount; face++) {
+				source->faceVertexCounts.push_back(colladaPrimitive->getGroupedVerticesVertexCount(face));
 			}
-			if (colladaPrimitive->hasUVCoordIndices()) {
-				COLLADAFW::IndexListArray& uvCoordIndicesArray = colladaPrimitive->getUVCoordIndicesArray();
-				size_t uvCoordIndicesArrayCount = uvCoordIndicesArray.getCount();
-				for (size_t j = 0; j < uvCoordIndicesArrayCount; j++) {
-					semantic = "TEXCOORD_" + std::to_string(j);
-					buildAttributes[semantic] = std::vector<float>();
-					semanticIndices[semantic] = uvCoordIndicesArray[j]->getIndices().getData();
-					semanticData[semantic] = &colladaMesh->getUVCoords();
-					primitive->attributes[semantic] = (GLTF::Accessor*)NULL;
-				}
+		}
+		source->addSemantic("POSITION", colladaPrimitive->getPositionIndices(), &conversion->positions, deferred);
+		if (colladaPrimitive->hasNormalIndices()) {
+			source->addSemantic("NORMAL", colladaPrimitive->getNormalIndices(), &conversion->normals, deferred);
+		}
+		if (colladaPrimitive->hasBinormalIndices()) {
+			source->addSemantic("BINORMAL", colladaPrimitive->getBinormalIndices(), &conversion->binormals, deferred);
+		}
+		if (colladaPrimitive->hasTangentIndices()) {
+			source->addSemantic("TANGENT", colladaPrimitive->getTangentIndices(), &conversion->tangents, deferred);
+		}
+		if (colladaPrimitive->hasUVCoordIndices()) {
+			COLLADAFW::IndexListArray& uvCoordIndicesArray = colladaPrimitive->getUVCoordIndicesArray();
+			size_t uvCoordIndicesArrayCount = uvCoordIndicesArray.getCount();
+			for (size_t j = 0; j < uvCoordIndicesArrayCount; j++) {
+				source->addSemantic("TEXCOORD_" + std::to_string(j), uvCoordIndicesArray[j]->getIndices(), &conversion->uvCoords, deferred);
 			}
-			if (colladaPrimitive->hasColorIndices()) {
-				COLLADAFW::IndexListArray& colorIndicesArray = colladaPrimitive->getColorIndicesArray();
-				size_t colorIndicesArrayCount = colorIndicesArray.getCount();
-				for (size_t j = 0; j < colorIndicesArrayCount; j++) {
-					semantic = "COLOR_" + std::to_string(j);
-					buildAttributes[semantic] = std::vector<float>();
-					semanticIndices[semantic] = colorIndicesArray[j]->getIndices().getData();
-					semanticData[semantic] = &colladaMesh->getColors();
-					primitive->attributes[semantic] = (GLTF::Accessor*)NULL;
-				}
+		}
+		if (colladaPrimitive->hasColorIndices()) {
+			COLLADAFW::IndexListArray& colorIndicesArray = colladaPrimitive->getColorIndicesArray();
+			size_t colorIndicesArrayCount = colorIndicesArray.getCount();
+			for (size_t j = 0; j < colorIndicesArrayCount; j++) {
+				source->addSemantic("COLOR_" + std::to_string(j), colorIndicesArray[j]->getIndices(), &conversion->colors, deferred);
 			}
+		}
+	}
 
-			unsigned int index = 0;
-			unsigned int face = 0;
-			unsigned int startFace = 0;
-			unsigned int totalVertexCount = 0;
-			unsigned int vertexCount = 0;
-			unsigned int faceVertexCount = colladaPrimitive->getGroupedVerticesVertexCount(face);
-			for (int j = 0; j < count; j++) {
-				std::string attributeId;
-				if (shouldTriangulate) {
-					// This approach is very efficient in terms of runtime, but there are more correct solutions that may be worth considering.
-					// Using a 3D variant of Fortune's Algorithm or something similar to compute a mesh with no overlapping triangles would be ideal.
-					if (vertexCount >= faceVertexCount) {
-						unsigned int end = buildIndices.size() - 1;
-						if (faceVertexCount > 3) {
-							// Make a triangle with the last two points and the first one
-							buildIndices.push_back(buildIndices[end - 1]);
-							buildIndices.push_back(buildIndices[end]);
-							buildIndices.push_back(buildIndices[startFace]);
-							totalVertexCount += 3;
-						}
-						face++;
-						faceVertexCount = colladaPrimitive->getGroupedVerticesVertexCount(face);
-						startFace = totalVertexCount;
-						vertexCount = 0;
-					}
-					else if (vertexCount >= 3) {
-						// Add the previous two points to complete the triangle
-						unsigned int end = buildIndices.size() - 1;
-						buildIndices.push_back(buildIndices[end - 1]);
-						buildIndices.push_back(buildIndices[end]);
-						totalVertexCount += 2;
-					}
-				}
-				for (const auto& entry : semanticIndices) {
-					semantic = entry.first;
-					unsigned int numberOfComponents = 3;
-					if (semantic.find("TEXCOORD") == 0) {
-						numberOfComponents = 2;
-					}
-					attributeId += buildAttributeId(*semanticData[semantic], semanticIndices[semantic][j], numberOfComponents);
-				}
-				std::map<std::string, unsigned int>::iterator search = attributeIndicesMapping.find(attributeId);
-				if (search != attributeIndicesMapping.end()) {
-					buildIndices.push_back(search->second);
-				}
-				else {
-					for (const auto& entry : buildAttributes) {
-						semantic = entry.first;
-						unsigned int numberOfComponents = 3;
-						bool flipY = false;
-						bool position = false;
-						if (semantic.find("TEXCOORD") == 0) {
-							numberOfComponents = 2;
-							flipY = true;
-						}
-						unsigned int semanticIndex = semanticIndices[semantic][j];
-						if (semantic == "POSITION") {
-							position = true;
-							mapping.push_back(semanticIndex);
-						}
-						const COLLADAFW::MeshVertexData* vertexData = semanticData[semantic];
-						unsigned int stride = numberOfComponents;
-						if (vertexData->getNumInputInfos() > 0) {
-							stride = vertexData->getStride(0);
-						}
-						for (unsigned int k = 0; k < numberOfComponents; k++) {
-							float value = getMeshVertexDataAtIndex(*vertexData, semanticIndex * stride + k);
-							if (flipY && k == 1) {
-								value = 1 - value;
-							}
-							if (position) {
-								value = value * _assetScale;
-							}
-							buildAttributes[semantic].push_back(value);
-						}
-					}
-					attributeIndicesMapping[attributeId] = index;
-					buildIndices.push_back(index);
-					index++;
-				}
-				totalVertexCount++;
-				vertexCount++;
+	if (deferred) {
+		for (size_t i = 0; i < meshPrimitivesCount; i++) {
+			if (conversion->primitives[i]->mode != GLTF::Primitive::Mode::UNKNOWN) {
+				_threadPool->submit([this, conversion, i]() {
+					conversion->results[i] = this->writeMeshPrimitive(conversion->sources[i], conversion->primitives[i], &conversion->mappings[i], conversion->assetScale);
+				});
 			}
-			if (shouldTriangulate && faceVertexCount > 3) {
-				// Close the last polyshape
-				int end = buildIndices.size() - 1;
-				buildIndices.push_back(buildIndices[end - 1]);
-				buildIndices.push_back(buildIndices[end]);
-				buildIndices.push_back(buildIndices[startFace]);
+		}
+		_pendingMeshes.push_back(conversion);
+		// Bound the amount of copied COLLADA data waiting on the pool
+		if (_pendingMeshes.size() >= (size_t)_threadPool->getThreadCount() * 16) {
+			return this->joinMeshes();
+		}
+		return true;
+	}
+	for (size_t i = 0; i < meshPrimitivesCount; i++) {
+		if (conversion->primitives[i]->mode != GLTF::Primitive::Mode::UNKNOWN) {
+			conversion->results[i] = this->writeMeshPrimitive(conversion->sources[i], conversion->primitives[i], &conversion->mappings[i], conversion->assetScale);
+		}
+	}
+	return this->publishMesh(conversion);
+}
+
+/**
+ * Replaces the vertices of a primitive with one vertex per index, in index order.
+ *
+ * @param buildIndices The indices of the primitive
+ * @param buildAttributes The values of each semantic, one element per vertex
+ * @param mapping The COLLADA position index of each vertex
+ */
+void deindexVertices(const std::vector<unsigned int>& buildIndices, std::map<std::string, std::vector<float>>* buildAttributes, std::vector<unsigned int>* mapping) {
+	size_t count = buildIndices.size();
+	for (auto& entry : *buildAttributes) {
+		std::vector<float>& values = entry.second;
+		size_t numberOfComponents = entry.first.find("TEXCOORD") == 0 ? 2 : 3;
+		std::vector<float> deindexedValues(count * numberOfComponents);
+		for (size_t i = 0; i < count; i++) {
+			std::memcpy(&deindexedValues[i * numberOfComponents], &values[buildIndices[i] * numberOfComponents], sizeof(float) * numberOfComponents);
+		}
+		values.swap(deindexedValues);
+	}
+	std::vector<unsigned int> deindexedMapping(count);
+	for (size_t i = 0; i < count; i++) {
+		deindexedMapping[i] = (*mapping)[buildIndices[i]];
+	}
+	mapping->swap(deindexedMapping);
+}
+
+/**
+ * Builds the indices and attribute accessors of a single primitive. This only touches `primitive` and
+ * `mapping`, so different primitives can be converted concurrently.
+ *
+ * @param source The COLLADA primitive data
+ * @param primitive The glTF primitive to populate
+ * @param mapping Receives the COLLADA position index of each vertex, used to map skinning data
+ * @param assetScale The scale applied to positions
+ * @return `true` if the operation completed succesfully, `false` if an error occured
+ */
+bool COLLADA2GLTF::Writer::writeMeshPrimitive(const COLLADA2GLTF::MeshPrimitiveSource* source, GLTF::Primitive* primitive, std::vector<unsigned int>* mapping, float assetScale) {
+	std::map<std::string, std::vector<float>> buildAttributes;
+	std::vector<unsigned int> buildIndices;
+	size_t count = source->count;
+	bool shouldTriangulate = source->shouldTriangulate;
+
+	// Semantics are visited in the same order as `buildAttributes`
+	std::vector<VertexSemantic> vertexSemantics;
+	for (const auto& entry : source->semantics) {
+		VertexSemantic vertexSemantic;
+		vertexSemantic.semantic = entry.first;
+		vertexSemantic.indices = entry.second.indices;
+		vertexSemantic.source = entry.second.source;
+		vertexSemantic.output = &buildAttributes[entry.first];
+		primitive->attributes[entry.first] = (GLTF::Accessor*)NULL;
+		if (entry.first.find("TEXCOORD") == 0) {
+			vertexSemantic.numberOfComponents = 2;
+			vertexSemantic.flipY = true;
+		}
+		vertexSemantic.position = entry.first == "POSITION";
+		vertexSemantic.stride = vertexSemantic.numberOfComponents;
+		if (vertexSemantic.source->stride >= 0) {
+			vertexSemantic.stride = vertexSemantic.source->stride;
+		}
+		vertexSemantics.push_back(vertexSemantic);
+	}
+	unsigned int index = 0;
+	unsigned int firstIndex = 0;
+	std::vector<unsigned int> corners(count);
+	if (isIndexAligned(vertexSemantics, count, &firstIndex, &index)) {
+		// Every semantic shares one index list, so the source ranges can be copied as they are
+		writeAlignedValues(vertexSemantics, firstIndex, index, assetScale);
+		const unsigned int* indices = vertexSemantics[0].indices;
+		for (size_t j = 0; j < count; j++) {
+			corners[j] = indices[j] - firstIndex;
+		}
+		mapping->resize(index);
+		for (unsigned int i = 0; i < index; i++) {
+			(*mapping)[i] = firstIndex + i;
+		}
+	}
+	else {
+		size_t semanticsCount = vertexSemantics.size();
+		VertexHashTable vertexTable(semanticsCount);
+		std::vector<unsigned int> vertexKey(semanticsCount);
+		for (size_t j = 0; j < count; j++) {
+			for (size_t k = 0; k < semanticsCount; k++) {
+				VertexSemantic& vertexSemantic = vertexSemantics[k];
+				vertexKey[k] = vertexSemantic.getClassId(vertexSemantic.indices[j]);
 			}
-			if (_options->dracoCompression ) {
-				// Currently only support triangles. 
-				if (primitive->mode == GLTF::Primitive::Mode::TRIANGLES) {
-					if (!addAttributesToDracoMesh(primitive, buildAttributes, buildIndices)) {
-						// Error adding attributes to draco mesh.
-						return false;
+			bool inserted;
+			corners[j] = vertexTable.findOrInsert(&vertexKey[0], &inserted);
+			if (inserted) {
+				for (VertexSemantic& vertexSemantic : vertexSemantics) {
+					unsigned int semanticIndex = vertexSemantic.indices[j];
+					if (vertexSemantic.position) {
+						mapping->push_back(semanticIndex);
 					}
+					vertexSemantic.writeValues(semanticIndex, assetScale);
 				}
+				index++;
 			}
+		}
+	}
+	if (shouldTriangulate) {
+		triangulatePolygons(source, corners, &buildIndices);
+	}
+	else {
+		buildIndices.swap(corners);
+	}
+	// The geometry of Draco compressed primitives is only kept in the Draco mesh
+	if (_options->dracoCompression) {
+		switch (primitive->mode) {
+		case GLTF::Primitive::Mode::TRIANGLES:
+			return addAttributesToDracoMesh(primitive, buildAttributes, buildIndices, index);
+		case GLTF::Primitive::Mode::POINTS:
+			// Each vertex is drawn once whatever the indices, so the vertices are encoded as a point cloud
+			return addAttributesToDracoMesh(primitive, buildAttributes, std::vector<unsigned int>(), index);
+		case GLTF::Primitive::Mode::LINES:
+		case GLTF::Primitive::Mode::LINE_STRIP:
+			// Draco has no line connectivity, so the vertices are expanded along the indices and
+			// encoded as an ordered point cloud, which draws the same lines without indices
+			deindexVertices(buildIndices, &buildAttributes, mapping);
+			return addAttributesToDracoMesh(primitive, buildAttributes, std::vector<unsigned int>(), buildIndices.size());
+		default:
+			break;
+		}
+	}
 
-			// Create indices accessor
-			GLTF::Accessor* indices = NULL;
-			if (index < 65536) {
-				// We can fit this in an UNSIGNED_SHORT
-				std::vector<unsigned short> unsignedShortIndices(buildIndices.begin(), buildIndices.end());
-				indices = new GLTF::Accessor(GLTF::Accessor::Type::SCALAR, GLTF::Constants::WebGL::UNSIGNED_SHORT, (unsigned char*)&unsignedShortIndices[0], unsignedShortIndices.size(), GLTF::Constants::WebGL::ELEMENT_ARRAY_BUFFER);
-			}
-			else {
-				// Leave as UNSIGNED_INT
-				indices = new GLTF::Accessor(GLTF::Accessor::Type::SCALAR, GLTF::Constants::WebGL::UNSIGNED_INT, (unsigned char*)&buildIndices[0], buildIndices.size(), GLTF::Constants::WebGL::ELEMENT_ARRAY_BUFFER);
-			}
-			primitive->indices = indices;
-			mesh->primitives.push_back(primitive);
-			// Create attribute accessors
-			for (const auto& entry : buildAttributes) {
-				std::string semantic = entry.first;
-				std::vector<float> attributeData = entry.second;
-				GLTF::Accessor::Type type = GLTF::Accessor::Type::VEC3;
-				if (semantic.find("TEXCOORD") == 0) {
-					type = GLTF::Accessor::Type::VEC2;
-				}
-				GLTF::Accessor* accessor = new GLTF::Accessor(type, GLTF::Constants::WebGL::FLOAT, (unsigned char*)&attributeData[0], attributeData.size() / GLTF::Accessor::getNumberOfComponents(type), GLTF::Constants::WebGL::ARRAY_BUFFER);
-				primitive->attributes[semantic] = accessor;
-			}
-			positionMapping[primitive] = mapping;
+	// Create indices accessor
+	GLTF::Accessor* indices = NULL;
+	if (index < 65536) {
+		// We can fit this in an UNSIGNED_SHORT
+		std::vector<unsigned short> unsignedShortIndices(buildIndices.begin(), buildIndices.end());
+		indices = new GLTF::Accessor(GLTF::Accessor::Type::SCALAR, GLTF::Constants::WebGL::UNSIGNED_SHORT, (unsigned char*)&unsignedShortIndices[0], unsignedShortIndices.size(), GLTF::Constants::WebGL::ELEMENT_ARRAY_BUFFER, _options->deferMinMax);
+	}
+	else {
+		// Leave as UNSIGNED_INT
+		indices = new GLTF::Accessor(GLTF::Accessor::Type::SCALAR, GLTF::Constants::WebGL::UNSIGNED_INT, (unsigned char*)&buildIndices[0], buildIndices.size(), GLTF::Constants::WebGL::ELEMENT_ARRAY_BUFFER, _options->deferMinMax);
+	}
+	primitive->indices = indices;
+	// Create attribute accessors
+	for (const auto& entry : buildAttributes) {
+		std::string semantic = entry.first;
+		const std::vector<float>& attributeData = entry.second;
+		GLTF::Accessor::Type type = GLTF::Accessor::Type::VEC3;
+		if (semantic.find("TEXCOORD") == 0) {
+			type = GLTF::Accessor::Type::VEC2;
+		}
+		GLTF::Accessor* accessor = new GLTF::Accessor(type, GLTF::Constants::WebGL::FLOAT, (unsigned char*)&attributeData[0], attributeData.size() / GLTF::Accessor::getNumberOfComponents(type), GLTF::Constants::WebGL::ARRAY_BUFFER, _options->deferMinMax);
+		primitive->attributes[semantic] = accessor;
+	}
+	return true;
+}
+
+/**
+ * Stores the primitives of a converted mesh in `_meshInstances`, `_meshPositionMapping` and
+ * `_meshMaterialPrimitiveMapping`, in the order they appear in the COLLADA mesh.
+ *
+ * @param conversion The completed conversion, deleted by this call
+ * @return `true` if every primitive was converted succesfully, `false` otherwise
+ */
+bool COLLADA2GLTF::Writer::publishMesh(COLLADA2GLTF::MeshConversion* conversion) {
+	GLTF::Mesh* mesh = conversion->mesh;
+	std::map<GLTF::Primitive*, std::vector<unsigned int>> positionMapping;
+	for (size_t i = 0; i < conversion->primitives.size(); i++) {
+		if (!conversion->results[i]) {
+			delete conversion;
+			return false;
+		}
+		GLTF::Primitive* primitive = conversion->primitives[i];
+		if (primitive->mode == GLTF::Primitive::Mode::UNKNOWN) {
+			continue;
 		}
+		mesh->primitives.push_back(primitive);
+		positionMapping[primitive] = std::move(conversion->mappings[i]);
 	}
-	_meshMaterialPrimitiveMapping[uniqueId] = primitiveMaterialMapping;
+	const COLLADAFW::UniqueId& uniqueId = conversion->uniqueId;
+	_meshMaterialPrimitiveMapping[uniqueId] = conversion->primitiveMaterialMapping;
 	_meshPositionMapping[uniqueId] = positionMapping;
 	_meshInstances[uniqueId] = mesh;
+	delete conversion;
 	return true;
 }
 
-bool COLLADA2GLTF::Writer::addAttributesToDracoMesh(GLTF::Primitive* primitive, const std::map<std::string, std::vector<float>>& buildAttributes, const std::vector<unsigned int>& buildIndices) {
+/**
+ * Waits for the meshes converting on the thread pool and publishes them in the order they were written.
+ *
+ * @return `true` if every mesh was converted succesfully, `false` otherwise
+ */
+bool COLLADA2GLTF::Writer::joinMeshes() {
+	if (_threadPool != NULL) {
+		_threadPool->wait();
+	}
+	bool success = true;
+	for (COLLADA2GLTF::MeshConversion* conversion : _pendingMeshes) {
+		if (!this->publishMesh(conversion)) {
+			success = false;
+		}
+	}
+	_pendingMeshes.clear();
+	return success;
+}
+
+/**
+ * Creates an accessor that only describes elements kept outside of the glTF buffers, in a Draco mesh.
+ * It has no bufferView, so min and max are computed from `data` right away.
+ */
+GLTF::Accessor* createDescriptiveAccessor(GLTF::Accessor::Type type, GLTF::Constants::WebGL componentType, const void* data, int count) {
+	GLTF::Accessor* accessor = new GLTF::Accessor(type, componentType);
+	accessor->count = count;
+	accessor->computeMinMax((unsigned char*)data, accessor->getByteStride());
+	return accessor;
+}
+
+/**
+ * Adds an attribute with one tightly packed value per point to a Draco mesh.
+ *
+ * @return The id of the attribute in the mesh
+ */
+int addDracoAttribute(draco::Mesh* dracoMesh, draco::GeometryAttribute::Type attributeType, draco::DataType dataType, int componentCount, int vertexCount, const void* data) {
+	int byteStride = draco::DataTypeLength(dataType) * componentCount;
+	draco::PointAttribute attribute;
+	attribute.Init(attributeType, NULL, componentCount, dataType, /* normalized */ false, byteStride, /* byte_offset */ 0);
+	int attributeId = dracoMesh->AddAttribute(attribute, /* identity_mapping */ true, vertexCount);
+	// With an identity mapping values are stored in point order, so they are copied at once
+	dracoMesh->attribute(attributeId)->buffer()->Write(0, data, (size_t)byteStride * vertexCount);
+	return attributeId;
+}
+
+bool COLLADA2GLTF::Writer::addAttributesToDracoMesh(GLTF::Primitive* primitive, const std::map<std::string, std::vector<float>>& buildAttributes, const std::vector<unsigned int>& buildIndices, unsigned int vertexCount) {
 	// Add extension to primitive.
 	GLTF::DracoExtension* dracoExtension = new GLTF::DracoExtension();
 	primitive->extensions["KHR_draco_mesh_compression"] = (GLTF::Extension*)dracoExtension;
 
-	// Create Draco mesh for compression.
+	// Create Draco mesh for compression, point clouds have no faces.
 	std::unique_ptr<draco::Mesh> dracoMesh(new draco::Mesh());
+	dracoMesh->set_num_points(vertexCount);
 	// Add faces to Draco mesh.
 	const int numTriangles = buildIndices.size() / 3;
 	dracoMesh->SetNumFaces(numTriangles);
@@ -775,15 +1247,21 @@ bool COLLADA2GLTF::Writer::addAttributesToDracoMesh(GLTF::Primitive* primitive,
 		face[2] = buildIndices[i.value() * 3 + 2];
 		dracoMesh->SetFace(i, face);
 	}
+	if (primitive->mode == GLTF::Primitive::Mode::TRIANGLES) {
+		// The indices accessor only describes the faces, min and max are computed before it is narrowed
+		GLTF::Accessor* indices = createDescriptiveAccessor(GLTF::Accessor::Type::SCALAR, GLTF::Constants::WebGL::UNSIGNED_INT, buildIndices.data(), buildIndices.size());
+		if (vertexCount < 65536) {
+			indices->componentType = GLTF::Constants::WebGL::UNSIGNED_SHORT;
+		}
+		primitive->indices = indices;
+	}
 
 	// Add attributes to Draco mesh.
 	for (const auto& entry : buildAttributes) {
-		// First create Accessor without data.
 		std::string semantic = entry.first;
-		std::vector<float> attributeData = entry.second;
+		const std::vector<float>& attributeData = entry.second;
 		GLTF::Accessor::Type type = semantic.find("TEXCOORD") == 0 ? GLTF::Accessor::Type::VEC2 : GLTF::Accessor::Type::VEC3;
 		const int componentCount = GLTF::Accessor::getNumberOfComponents(type);
-		const int vertexCount = attributeData.size() / componentCount;
 
 		// Create attributes for Draco mesh.
 		draco::GeometryAttribute::Type att_type = draco::GeometryAttribute::GENERIC;
@@ -796,19 +1274,10 @@ bool COLLADA2GLTF::Writer::addAttributesToDracoMesh(GLTF::Primitive* primitive,
 		else if (semantic.find("COLOR") == 0)
 			att_type = draco::GeometryAttribute::COLOR;
 
-		draco::PointAttribute att;
-		att.Init(att_type, NULL, componentCount, draco::DT_FLOAT32, /* normalized */ false, /* stride */ sizeof(float) * componentCount, /* byte_offset */ 0);
-		int att_id = dracoMesh->AddAttribute(att, /* identity_mapping */ true, vertexCount);
-		draco::PointAttribute *att_ptr = dracoMesh->attribute(att_id);
 		// Unique id of attribute is set to attribute id initially.
 		// To note that the attribute id is not necessary to be the same as unique id after compressing the mesh, but the unqiue id will not change.
-		dracoExtension->attributeToId[semantic] = att_id;
-
-		for (draco::PointIndex i(0); i < vertexCount; ++i) {
-			std::vector<float> vertex_data(componentCount);
-			memcpy(&vertex_data[0], &attributeData[i.value() * componentCount], sizeof(float) * componentCount);
-			att_ptr->SetAttributeValue(att_ptr->mapped_index(i), &vertex_data[0]);
-		}
+		dracoExtension->attributeToId[semantic] = addDracoAttribute(dracoMesh.get(), att_type, draco::DT_FLOAT32, componentCount, vertexCount, attributeData.data());
+		primitive->attributes[semantic] = createDescriptiveAccessor(type, GLTF::Constants::WebGL::FLOAT, attributeData.data(), vertexCount);
 	}
 	dracoExtension->dracoMesh = std::move(dracoMesh);
 	return true;
@@ -816,48 +1285,24 @@ bool COLLADA2GLTF::Writer::addAttributesToDracoMesh(GLTF::Primitive* primitive,
 
 bool COLLADA2GLTF::Writer::addControllerDataToDracoMesh(GLTF::Primitive* primitive, unsigned short* jointArray, float* weightArray) {
 	const int vertexCount = primitive->attributes["POSITION"]->count;
-	const GLTF::Accessor::Type type = GLTF::Accessor::Type::VEC4;
-	int componentCount = GLTF::Accessor::getNumberOfComponents(type);
-    
+	const int componentCount = GLTF::Accessor::getNumberOfComponents(GLTF::Accessor::Type::VEC4);
+
 	auto dracoExtensionPtr = primitive->extensions.find("KHR_draco_mesh_compression");
 	if (dracoExtensionPtr == primitive->extensions.end()) {
 		// No extension exists.
-		return true; 
+		return true;
 	}
 	GLTF::DracoExtension* dracoExtension = (GLTF::DracoExtension*)dracoExtensionPtr->second;
 	draco::Mesh *dracoMesh = dracoExtension->dracoMesh.get();
-	draco::GeometryAttribute::Type att_type = draco::GeometryAttribute::GENERIC;
-	draco::PointAttribute *att_ptr = nullptr;
-
-	// Add joint indices.
-	draco::PointAttribute joint_att;
-	joint_att.Init(att_type, NULL, componentCount, draco::DT_UINT16, /* normalized */ false, /* stride */ sizeof(unsigned short) * componentCount, /* byte_offset */ 0);
-	int joint_att_id = dracoMesh->AddAttribute(joint_att, /* identity_mapping */ true, vertexCount);
-	// Unique id is set to attribute id initially.
-	dracoExtension->attributeToId["JOINTS_0"] = joint_att_id;
-	att_ptr = dracoMesh->attribute(joint_att_id);
-	for (draco::PointIndex i(0); i < vertexCount; ++i) {
-		std::vector<unsigned short> vertex_data(componentCount);
-		memcpy(&vertex_data[0], &jointArray[i.value() * componentCount], sizeof(unsigned short) * componentCount);
-		att_ptr->SetAttributeValue(att_ptr->mapped_index(i), &vertex_data[0]);
-	}
-
-	// Add joint weights
-	draco::PointAttribute weight_att;
-	weight_att.Init(att_type, NULL, componentCount, draco::DT_FLOAT32, /* normalized */ false, /* stride */ sizeof(float) * componentCount, /* byte_offset */ 0);
-	int weight_att_id = dracoMesh->AddAttribute(weight_att, /* identity_mapping */ true, vertexCount);
-	// Unique id is set to attribute id initially.
-	dracoExtension->attributeToId["WEIGHTS_0"] = weight_att_id;
-	att_ptr = dracoMesh->attribute(weight_att_id);
-	for (draco::PointIndex i(0); i < vertexCount; ++i) {
-		std::vector<float> vertex_data(componentCount);
-		memcpy(&vertex_data[0], &weightArray[i.value() * componentCount], sizeof(float) * componentCount);
-		att_ptr->SetAttributeValue(att_ptr->mapped_index(i), &vertex_data[0]);
-	}
+
+	// Unique ids are set to attribute ids initially.
+	dracoExtension->attributeToId["JOINTS_0"] = addDracoAttribute(dracoMesh, draco::GeometryAttribute::GENERIC, draco::DT_UINT16, componentCount, vertexCount, jointArray);
+	dracoExtension->attributeToId["WEIGHTS_0"] = addDracoAttribute(dracoMesh, draco::GeometryAttribute::GENERIC, draco::DT_FLOAT32, componentCount, vertexCount, weightArray);
 	return true;
 }
 
 bool COLLADA2GLTF::Writer::writeGeometry(const COLLADAFW::Geometry* geometry) {
+	GLTF::Arena::Scope scope(&_asset->arena);
 	switch (geometry->getType()) {
 	case COLLADAFW::Geometry::GEO_TYPE_MESH:
 		if (!this->writeMesh((COLLADAFW::Mesh*)geometry)) {
@@ -885,7 +1330,7 @@ void packColladaColor(COLLADAFW::Color color, float* packArray) {
 GLTF::Texture* COLLADA2GLTF::Writer::fromColladaTexture(const COLLADAFW::EffectCommon* effectCommon, COLLADAFW::SamplerID samplerId) {
 	const COLLADAFW::SamplerPointerArray& samplers = effectCommon->getSamplerPointerArray();
 	COLLADAFW::Sampler* colladaSampler = (COLLADAFW::Sampler*)samplers[samplerId];
-	std::map<COLLADAFW::UniqueId, GLTF::Image*>::iterator findImage = _images.find(colladaSampler->getSourceImage());
+	COLLADA2GLTF::UniqueIdMap<GLTF::Image*>::iterator findImage = _images.find(colladaSampler->getSourceImage());
 	if (findImage == _images.end()) {
 		return NULL;
 	}
@@ -902,6 +1347,7 @@ GLTF::Texture* COLLADA2GLTF::Writer::fromColladaTexture(const COLLADAFW::EffectC
 }
 
 bool COLLADA2GLTF::Writer::writeEffect(const COLLADAFW::Effect* effect) {
+	GLTF::Arena::Scope scope(&_asset->arena);
 	const COLLADAFW::CommonEffectPointerArray& commonEffects = effect->getCommonEffects();
 
 	if (commonEffects.getCount() > 0) {
@@ -937,7 +1383,7 @@ bool COLLADA2GLTF::Writer::writeEffect(const COLLADAFW::Effect* effect) {
 				material->values->ambientTexture = fromColladaTexture(effectCommon, ambient.getTexture());
 			}
 			else if (ambient.isColor()) {
-				material->values->ambient = new float[4];
+				material->values->ambient = GLTF::Arena::allocateArray<float>(4);
 				packColladaColor(ambient.getColor(), material->values->ambient);
 			}
 		}
@@ -950,7 +1396,7 @@ bool COLLADA2GLTF::Writer::writeEffect(const COLLADAFW::Effect* effect) {
 			}
 		}
 		else if (diffuse.isColor()) {
-			material->values->diffuse = new float[4];
+			material->values->diffuse = GLTF::Arena::allocateArray<float>(4);
 			packColladaColor(diffuse.getColor(), material->values->diffuse);
 			if (lockAmbientDiffuse) {
 				material->values->ambient = material->values->diffuse;
@@ -962,7 +1408,7 @@ bool COLLADA2GLTF::Writer::writeEffect(const COLLADAFW::Effect* effect) {
 			material->values->emissionTexture = fromColladaTexture(effectCommon, emission.getTexture());
 		}
 		else if (emission.isColor()) {
-			material->values->emission = new float[4];
+			material->values->emission = GLTF::Arena::allocateArray<float>(4);
 			packColladaColor(emission.getColor(), material->values->emission);
 		}
 
@@ -971,7 +1417,7 @@ bool COLLADA2GLTF::Writer::writeEffect(const COLLADAFW::Effect* effect) {
 			material->values->specularTexture = fromColladaTexture(effectCommon, specular.getTexture());
 		}
 		else if (specular.isColor()) {
-			material->values->specular = new float[4];
+			material->values->specular = GLTF::Arena::allocateArray<float>(4);
 			packColladaColor(specular.getColor(), material->values->specular);
 		}
 
@@ -979,7 +1425,7 @@ bool COLLADA2GLTF::Writer::writeEffect(const COLLADAFW::Effect* effect) {
 		if (shininess.getType() == COLLADAFW::FloatOrParam::FLOAT) {
 			float shininessValue = shininess.getFloatValue();
 			if (shininessValue >= 0) {
-				material->values->shininess = new float[1];
+				material->values->shininess = GLTF::Arena::allocateArray<float>(1);
 				material->values->shininess[0] = shininessValue;
 			}
 		}
@@ -988,7 +1434,7 @@ bool COLLADA2GLTF::Writer::writeEffect(const COLLADAFW::Effect* effect) {
 		if (transparency.getType() == COLLADAFW::FloatOrParam::FLOAT) {
 			float transparencyValue = transparency.getFloatValue();
 			if (transparencyValue >= 0) {
-				material->values->transparency = new float[1];
+				material->values->transparency = GLTF::Arena::allocateArray<float>(1);
 				material->values->transparency[0] = transparencyValue;
 			}
 		}
@@ -1010,6 +1456,7 @@ bool COLLADA2GLTF::Writer::writeEffect(const COLLADAFW::Effect* effect) {
 }
 
 bool COLLADA2GLTF::Writer::writeCamera(const COLLADAFW::Camera* colladaCamera) {
+	GLTF::Arena::Scope scope(&_asset->arena);
 	GLTF::Camera* writeCamera = NULL;
 	if (colladaCamera->getCameraType() == COLLADAFW::Camera::ORTHOGRAPHIC) {
 		GLTF::CameraOrthographic* camera = new GLTF::CameraOrthographic();
@@ -1090,15 +1537,17 @@ bool COLLADA2GLTF::Writer::writeCamera(const COLLADAFW::Camera* colladaCamera) {
 }
 
 bool COLLADA2GLTF::Writer::writeImage(const COLLADAFW::Image* colladaImage) {
+	GLTF::Arena::Scope scope(&_asset->arena);
 	const COLLADABU::URI imageUri = colladaImage->getImageURI();
 	path imagePath = path(_options->basePath) / imageUri.toNativePath(COLLADABU::Utils::getSystemType());
-	GLTF::Image* image = GLTF::Image::load(imagePath);
+	GLTF::Image* image = _asset->loadImage(imagePath);
 	image->stringId = colladaImage->getOriginalId();
 	_images[colladaImage->getUniqueId()] = image;
 	return true;
 }
 
 bool COLLADA2GLTF::Writer::writeLight(const COLLADAFW::Light* colladaLight) {
+	GLTF::Arena::Scope scope(&_asset->arena);
 	GLTF::MaterialCommon::Light* light = new GLTF::MaterialCommon::Light();
 	light->stringId = colladaLight->getOriginalId();
 	switch (colladaLight->getLightType()) {
@@ -1130,6 +1579,7 @@ bool COLLADA2GLTF::Writer::writeLight(const COLLADAFW::Light* colladaLight) {
 * @return `true` if the operation completed succesfully, `false` if an error occured
 */
 bool COLLADA2GLTF::Writer::writeAnimation(const COLLADAFW::Animation* animation) {
+	GLTF::Arena::Scope scope(&_asset->arena);
 	GLTF::Animation::Sampler* sampler = new GLTF::Animation::Sampler();
 
 	if (animation->getAnimationType() == COLLADAFW::Animation::ANIMATION_CURVE) {
@@ -1170,7 +1620,7 @@ bool COLLADA2GLTF::Writer::writeAnimation(const COLLADAFW::Animation* animation)
 	return true;
 }
 
-void interpolateTranslation(float* base, std::vector<float> input, std::vector<float> output, int index, size_t offset, float time, float* translationOut, float assetScale) {
+void interpolateTranslation(float* base, const std::vector<float>& input, const std::vector<float>& output, int index, size_t offset, float time, float* translationOut, float assetScale) {
 	float startTime = 0;
 	float startTranslation = 0;
 	float endTime = 0;
@@ -1217,11 +1667,12 @@ void interpolateTranslation(float* base, std::vector<float> input, std::vector<f
 * @return `true` if the operation completed succesfully, `false` if an error occured
 */
 bool COLLADA2GLTF::Writer::writeAnimationList(const COLLADAFW::AnimationList* animationList) {
+	GLTF::Arena::Scope scope(&_asset->arena);
 	const COLLADAFW::AnimationList::AnimationBindings& bindings = animationList->getAnimationBindings();
 	COLLADAFW::UniqueId animationListId = animationList->getUniqueId();
 	GLTF::Node* node = _animatedNodes[animationList->getUniqueId()];
 	float originalRotationAngle = NAN;
-	std::map<COLLADAFW::UniqueId, float>::iterator iter = _originalRotationAngles.find(animationListId);
+	COLLADA2GLTF::UniqueIdMap<float>::iterator iter = _originalRotationAngles.find(animationListId);
 	if (iter != _originalRotationAngles.end()) {
 		originalRotationAngle = iter->second;
 	}
@@ -1231,9 +1682,9 @@ bool COLLADA2GLTF::Writer::writeAnimationList(const COLLADAFW::AnimationList* an
 	std::set<float> timeSet = std::set<float>();
 	GLTF::Node::TransformMatrix* transformMatrix = NULL;
 	GLTF::Node::TransformTRS* transformTRS = NULL;
-	float* translation = NULL;
-	float* rotation = NULL;
-	float* scale = NULL;
+	std::vector<float> translation;
+	std::vector<float> rotation;
+	std::vector<float> scale;
 
 	if (nodeTransform) {
 		if (nodeTransform->type == GLTF::Node::Transform::MATRIX) {
@@ -1251,10 +1702,9 @@ bool COLLADA2GLTF::Writer::writeAnimationList(const COLLADAFW::AnimationList* an
 	bool hasScale = false;
 	for (size_t i = 0; i < bindings.getCount(); i++) {
 		const COLLADAFW::AnimationList::AnimationBinding& binding = bindings[i];
-		std::tuple<std::vector<float>, std::vector<float>> animationData = _animationData[binding.animation];
-		std::vector<float> input;
-		std::vector<float> output;
-		std::tie(input, output) = animationData;
+		const std::tuple<std::vector<float>, std::vector<float>>& animationData = _animationData[binding.animation];
+		const std::vector<float>& input = std::get<0>(animationData);
+		const std::vector<float>& output = std::get<1>(animationData);
 
 		for (size_t j = 0; j < input.size(); j++) {
 			timeSet.insert(input[j]);
@@ -1300,7 +1750,7 @@ bool COLLADA2GLTF::Writer::writeAnimationList(const COLLADAFW::AnimationList* an
 
 	// Generate translation, rotation, scale for each keyframe
 	if (hasTranslation) {
-		translation = new float[times.size() * 3];
+		translation.resize(times.size() * 3);
 		// We do this so that if x, y, or z are unspecified, the translation is still valid
 		// For the others, all components will be set, so we don't have to worry about it
 		for (size_t i = 0; i < times.size(); i++) {
@@ -1310,21 +1760,20 @@ bool COLLADA2GLTF::Writer::writeAnimationList(const COLLADAFW::AnimationList* an
 		}
 	}
 	if (hasRotation) {
-		rotation = new float[times.size() * 4];
+		rotation.resize(times.size() * 4);
 	}
 	if (hasScale) {
-		scale = new float[times.size() * 3];
+		scale.resize(times.size() * 3);
 	}
-	float* lastRotation = new float[4];
+	float lastRotation[4];
 	for (size_t j = 0; j < 4; j++) {
 		lastRotation[j] = nodeTransformTRS->rotation[j];
 	}
 	for (size_t i = 0; i < bindings.getCount(); i++) {
 		const COLLADAFW::AnimationList::AnimationBinding& binding = bindings[i];
-		std::tuple<std::vector<float>, std::vector<float>> animationData = _animationData[binding.animation];
-		std::vector<float> input;
-		std::vector<float> output;
-		std::tie(input, output) = animationData;
+		const std::tuple<std::vector<float>, std::vector<float>>& animationData = _animationData[binding.animation];
+		const std::vector<float>& input = std::get<0>(animationData);
+		const std::vector<float>& output = std::get<1>(animationData);
 		int index = -1;
 		int inputSize = input.size();
 
@@ -1372,7 +1821,7 @@ bool COLLADA2GLTF::Writer::writeAnimationList(const COLLADAFW::AnimationList* an
 			}
 			case COLLADAFW::AnimationList::POSITION_X: {
 				if (needsInterpolation) {
-					interpolateTranslation(nodeTransformTRS->translation, input, output, index, 0, time, translation + (j * 3), _assetScale);
+					interpolateTranslation(nodeTransformTRS->translation, input, output, index, 0, time, translation.data() + (j * 3), _assetScale);
 				}
 				else {
 					translation[j * 3] = output[index] * _assetScale;
@@ -1381,7 +1830,7 @@ bool COLLADA2GLTF::Writer::writeAnimationList(const COLLADAFW::AnimationList* an
 			}
 			case COLLADAFW::AnimationList::POSITION_Y: {
 				if (needsInterpolation) {
-					interpolateTranslation(nodeTransformTRS->translation, input, output, index, 1, time, translation + (j * 3), _assetScale);
+					interpolateTranslation(nodeTransformTRS->translation, input, output, index, 1, time, translation.data() + (j * 3), _assetScale);
 				}
 				else {
 					translation[j * 3 + 1] = output[index] * _assetScale;
@@ -1390,7 +1839,7 @@ bool COLLADA2GLTF::Writer::writeAnimationList(const COLLADAFW::AnimationList* an
 			}
 			case COLLADAFW::AnimationList::POSITION_Z: {
 				if (needsInterpolation) {
-					interpolateTranslation(nodeTransformTRS->translation, input, output, index, 2, time, translation + (j * 3), _assetScale);
+					interpolateTranslation(nodeTransformTRS->translation, input, output, index, 2, time, translation.data() + (j * 3), _assetScale);
 				}
 				else {
 					translation[j * 3 + 2] = output[index] * _assetScale;
@@ -1449,12 +1898,12 @@ bool COLLADA2GLTF::Writer::writeAnimationList(const COLLADAFW::AnimationList* an
 	}
 
 	GLTF::Animation* animation = new GLTF::Animation();
-	GLTF::Accessor* inputAccessor = new GLTF::Accessor(GLTF::Accessor::Type::SCALAR, GLTF::Constants::WebGL::FLOAT, (unsigned char*)times.data(), times.size(), (GLTF::Constants::WebGL)-1);
+	GLTF::Accessor* inputAccessor = new GLTF::Accessor(GLTF::Accessor::Type::SCALAR, GLTF::Constants::WebGL::FLOAT, (unsigned char*)times.data(), times.size(), (GLTF::Constants::WebGL)-1, _options->deferMinMax);
 	if (hasTranslation) {
 		GLTF::Animation::Channel* channel = new GLTF::Animation::Channel();
 		GLTF::Animation::Channel::Target* target = new GLTF::Animation::Channel::Target();
 		GLTF::Animation::Sampler* sampler = new GLTF::Animation::Sampler();
-		GLTF::Accessor* outputAccessor = new GLTF::Accessor(GLTF::Accessor::Type::VEC3, GLTF::Constants::WebGL::FLOAT, (unsigned char*)translation, times.size(), (GLTF::Constants::WebGL) - 1);
+		GLTF::Accessor* outputAccessor = new GLTF::Accessor(GLTF::Accessor::Type::VEC3, GLTF::Constants::WebGL::FLOAT, (unsigned char*)translation.data(), times.size(), (GLTF::Constants::WebGL) - 1, _options->deferMinMax);
 		sampler->input = inputAccessor;
 		sampler->output = outputAccessor;
 		target->node = node;
@@ -1467,7 +1916,7 @@ bool COLLADA2GLTF::Writer::writeAnimationList(const COLLADAFW::AnimationList* an
 		GLTF::Animation::Channel* channel = new GLTF::Animation::Channel();
 		GLTF::Animation::Channel::Target* target = new GLTF::Animation::Channel::Target();
 		GLTF::Animation::Sampler* sampler = new GLTF::Animation::Sampler();
-		GLTF::Accessor* outputAccessor = new GLTF::Accessor(GLTF::Accessor::Type::VEC4, GLTF::Constants::WebGL::FLOAT, (unsigned char*)rotation, times.size(), (GLTF::Constants::WebGL) - 1);
+		GLTF::Accessor* outputAccessor = new GLTF::Accessor(GLTF::Accessor::Type::VEC4, GLTF::Constants::WebGL::FLOAT, (unsigned char*)rotation.data(), times.size(), (GLTF::Constants::WebGL) - 1, _options->deferMinMax);
 		sampler->input = inputAccessor;
 		sampler->output = outputAccessor;
 		target->node = node;
@@ -1480,7 +1929,7 @@ bool COLLADA2GLTF::Writer::writeAnimationList(const COLLADAFW::AnimationList* an
 		GLTF::Animation::Channel* channel = new GLTF::Animation::Channel();
 		GLTF::Animation::Channel::Target* target = new GLTF::Animation::Channel::Target();
 		GLTF::Animation::Sampler* sampler = new GLTF::Animation::Sampler();
-		GLTF::Accessor* outputAccessor = new GLTF::Accessor(GLTF::Accessor::Type::VEC3, GLTF::Constants::WebGL::FLOAT, (unsigned char*)scale, times.size(), (GLTF::Constants::WebGL) - 1);
+		GLTF::Accessor* outputAccessor = new GLTF::Accessor(GLTF::Accessor::Type::VEC3, GLTF::Constants::WebGL::FLOAT, (unsigned char*)scale.data(), times.size(), (GLTF::Constants::WebGL) - 1, _options->deferMinMax);
 		sampler->input = inputAccessor;
 		sampler->output = outputAccessor;
 		target->node = node;
@@ -1494,6 +1943,7 @@ bool COLLADA2GLTF::Writer::writeAnimationList(const COLLADAFW::AnimationList* an
 }
 
 bool COLLADA2GLTF::Writer::writeSkinControllerData(const COLLADAFW::SkinControllerData* skinControllerData) {
+	GLTF::Arena::Scope scope(&_asset->arena);
 	GLTF::Skin* skin = new GLTF::Skin();
 	COLLADAFW::UniqueId uniqueId = skinControllerData->getUniqueId();
 	skin->stringId = skinControllerData->getOriginalId();
@@ -1508,7 +1958,7 @@ bool COLLADA2GLTF::Writer::writeSkinControllerData(const COLLADAFW::SkinControll
 	GLTF::Node::TransformMatrix* bindShapeMatrix = new GLTF::Node::TransformMatrix();
 	packColladaMatrix(skinControllerData->getBindShapeMatrix(), bindShapeMatrix);
 	GLTF::Node::TransformMatrix* inverseBindMatrix = new GLTF::Node::TransformMatrix();
-	float* inverseBindMatrices = new float[16 * matrixArrayCount];
+	std::vector<float> inverseBindMatrices(16 * matrixArrayCount);
 	for (size_t i = 0; i < matrixArrayCount; i++) {
 		packColladaMatrix(matrixArray[i], inverseBindMatrix);
 		bindShapeMatrix->premultiply(inverseBindMatrix, inverseBindMatrix);
@@ -1516,7 +1966,7 @@ bool COLLADA2GLTF::Writer::writeSkinControllerData(const COLLADAFW::SkinControll
 			inverseBindMatrices[i * 16 + j] = inverseBindMatrix->matrix[j];
 		}
 	}
-	skin->inverseBindMatrices = new GLTF::Accessor(GLTF::Accessor::Type::MAT4, GLTF::Constants::WebGL::FLOAT, (unsigned char*)inverseBindMatrices, matrixArrayCount, (GLTF::Constants::WebGL)-1);
+	skin->inverseBindMatrices = new GLTF::Accessor(GLTF::Accessor::Type::MAT4, GLTF::Constants::WebGL::FLOAT, (unsigned char*)inverseBindMatrices.data(), matrixArrayCount, (GLTF::Constants::WebGL)-1, _options->deferMinMax);
 
 	// Cache joint and weight data
 	// COLLADA can have different numbers of joints for a single vertex
@@ -1598,13 +2048,18 @@ bool COLLADA2GLTF::Writer::writeSkinControllerData(const COLLADAFW::SkinControll
 * The produced skins are stored in `_skinInstances` indexed by their <COLLADAFW::UniqueId>.
 *
 * This is expected to run before nodes are written, so the targeted joint nodes are stored
-* in a set of <COLLADAFW::UniqueId> for each SkinController id on _skinJointNodes. When nodes
-* are written, this is used to assign <GLTF::Node> references for joints.
+* in a set of <COLLADAFW::UniqueId> for each SkinController id on _skinJointNodes. The skins
+* each joint belongs to are indexed on _jointNodeSkins, so when nodes are written the <GLTF::Node>
+* references for joints are assigned without scanning every skin.
 *
 * @param controller The COLLADA skin controller to write to glTF
 * @return `true` if the operation completed succesfully, `false` if an error occured
 */
 bool COLLADA2GLTF::Writer::writeController(const COLLADAFW::Controller* controller) {
+	GLTF::Arena::Scope scope(&_asset->arena);
+	if (!this->joinMeshes()) {
+		return false;
+	}
 	if (controller->getControllerType() == COLLADAFW::Controller::CONTROLLER_TYPE_SKIN) {
 		COLLADAFW::SkinController* skinController = (COLLADAFW::SkinController*)controller;
 		COLLADAFW::UniqueId skinControllerDataId = skinController->getSkinControllerData();
@@ -1613,6 +2068,11 @@ bool COLLADA2GLTF::Writer::writeController(const COLLADAFW::Controller* controll
 		COLLADAFW::UniqueIdArray& jointIds = skinController->getJoints();
 		for (size_t i = 0; i < jointIds.getCount(); i++) {
 			_skinJointNodes[skinControllerId].push_back(jointIds[i]);
+			// A node listed more than once is mapped to its first joint
+			std::vector<std::pair<COLLADAFW::UniqueId, size_t>>& jointSkins = _jointNodeSkins[jointIds[i]];
+			if (jointSkins.empty() || !(jointSkins.back().first == skinControllerId)) {
+				jointSkins.push_back(std::make_pair(skinControllerId, i));
+			}
 		}
 		GLTF::Accessor::Type type;
 		std::vector<int*> joints;
@@ -1623,16 +2083,14 @@ bool COLLADA2GLTF::Writer::writeController(const COLLADAFW::Controller* controll
 		COLLADAFW::UniqueId meshId = skinController->getSource();
 		GLTF::Mesh* mesh = _meshInstances[meshId];
 
-		double* jointComponent = new double[numberOfComponents];
-		double* weightComponent = new double[numberOfComponents];
-		std::map<GLTF::Primitive*, std::vector<unsigned int>> positionMapping = _meshPositionMapping[meshId];
+		const std::map<GLTF::Primitive*, std::vector<unsigned int>>& positionMapping = _meshPositionMapping[meshId];
 		for (const auto& primitiveEntry : positionMapping) {
 			GLTF::Primitive* primitive = primitiveEntry.first;
 			int count = primitive->attributes["POSITION"]->count;
 			unsigned short* jointArray = new unsigned short[count * numberOfComponents];
 			float* weightArray = new float[count * numberOfComponents];
 
-			std::vector<unsigned int> mapping = primitiveEntry.second;
+			const std::vector<unsigned int>& mapping = primitiveEntry.second;
 			for (int i = 0; i < count; i++) {
 				int index = mapping[i];
 				int* joint = joints[index];
@@ -1643,13 +2101,24 @@ bool COLLADA2GLTF::Writer::writeController(const COLLADAFW::Controller* controll
 				}
 			}
 
-			if (_options->dracoCompression) {
-					if (!addControllerDataToDracoMesh(primitive, jointArray, weightArray))
-						return false;
+			GLTF::Accessor* weightAccessor;
+			GLTF::Accessor* jointAccessor;
+			if (primitive->extensions.find("KHR_draco_mesh_compression") != primitive->extensions.end()) {
+				// Skinning data of Draco primitives is only kept in the Draco mesh
+				if (!addControllerDataToDracoMesh(primitive, jointArray, weightArray)) {
+					delete[] jointArray;
+					delete[] weightArray;
+					return false;
+				}
+				weightAccessor = createDescriptiveAccessor(type, GLTF::Constants::WebGL::FLOAT, weightArray, count);
+				jointAccessor = createDescriptiveAccessor(type, GLTF::Constants::WebGL::UNSIGNED_SHORT, jointArray, count);
 			}
-
-			GLTF::Accessor* weightAccessor = new GLTF::Accessor(type, GLTF::Constants::WebGL::FLOAT, (unsigned char*)weightArray, count, GLTF::Constants::WebGL::ARRAY_BUFFER);
-			GLTF::Accessor* jointAccessor = new GLTF::Accessor(type, GLTF::Constants::WebGL::UNSIGNED_SHORT, (unsigned char*)jointArray, count, GLTF::Constants::WebGL::ARRAY_BUFFER);
+			else {
+				weightAccessor = new GLTF::Accessor(type, GLTF::Constants::WebGL::FLOAT, (unsigned char*)weightArray, count, GLTF::Constants::WebGL::ARRAY_BUFFER, _options->deferMinMax);
+				jointAccessor = new GLTF::Accessor(type, GLTF::Constants::WebGL::UNSIGNED_SHORT, (unsigned char*)jointArray, count, GLTF::Constants::WebGL::ARRAY_BUFFER, _options->deferMinMax);
+			}
+			delete[] jointArray;
+			delete[] weightArray;
 			if (_options->version == "1.0") {
 				primitive->attributes["WEIGHT"] = weightAccessor;
 				primitive->attributes["JOINT"] = jointAccessor;
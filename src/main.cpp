@@ -1,18 +1,20 @@
 #include "COLLADA2GLTFWriter.h"
 #include "COLLADA2GLTFExtrasHandler.h"
 #include "COLLADASaxFWLLoader.h"
+#include "GLTFRapidJSONWriter.h"
 
-#include "rapidjson/document.h"
+#include "rapidjson/filewritestream.h"
 #include "rapidjson/prettywriter.h"
 #include "rapidjson/stringbuffer.h"
 #include "rapidjson/writer.h"
 
 #include "ahoy/ahoy.h"
 
+#include <cstdint>
 #include <ctime>
 #include <stdio.h>
+#include <stdlib.h>
 #include <iostream>
-#include <fstream>
 #include <experimental/filesystem>
 
 using namespace ahoy;
@@ -21,12 +23,23 @@ using namespace std::experimental::filesystem;
 const int HEADER_LENGTH = 12;
 const int CHUNK_HEADER_LENGTH = 8;
 
+template <typename Writer, typename Stream>
+void writeAssetJSON(GLTF::Asset* asset, Writer& writer, Stream& stream, GLTF::Options* options) {
+	GLTF::RapidJSONWriter<Writer, Stream> jsonWriter(writer, stream);
+	jsonWriter.StartObject();
+	asset->writeJSON(&jsonWriter, options);
+	jsonWriter.EndObject();
+}
+
 int main(int argc, const char **argv) {
 	GLTF::Asset* asset = new GLTF::Asset();
 	COLLADA2GLTF::Options* options = new COLLADA2GLTF::Options();
 
 	bool separate;
 	bool separateTextures;
+	std::string overdrawThreshold;
+	std::string dracoMaxError;
+	std::string dracoMaxRelativeError;
 
 	Parser* parser = new Parser();
 	parser->name("COLLADA2GLTF")->usage("./COLLADA2GLTF input.dae output.gltf [options]");
@@ -60,6 +73,10 @@ int main(int argc, const char **argv) {
 		->defaults(false)
 		->description("output binary glTF");
 
+	parser->define("compactJson", &options->compactJson)
+		->defaults(false)
+		->description("output the glTF JSON without indentation or line breaks");
+
 	parser->define("g", &options->glsl)
 		->alias("glsl")
 		->defaults(false)
@@ -95,13 +112,13 @@ int main(int argc, const char **argv) {
 		->description("compress the geometries using Draco compression extension");
 
 	parser->define("qp", &options->positionQuantizationBits)
-		->description("position quantization bits used in Draco compression extension");
+		->description("position quantization bits used in Draco compression extension and meshQuantization");
 
 	parser->define("qn", &options->normalQuantizationBits)
-		->description("normal quantization bits used in Draco compression extension");
+		->description("normal quantization bits used in Draco compression extension and meshQuantization");
 
 	parser->define("qt", &options->texcoordQuantizationBits)
-		->description("texture coordinate quantization bits used in Draco compression extension");
+		->description("texture coordinate quantization bits used in Draco compression extension and meshQuantization");
 
 	parser->define("qc", &options->colorQuantizationBits)
 		->description("color quantization bits used in Draco compression extension");
@@ -109,6 +126,51 @@ int main(int argc, const char **argv) {
 	parser->define("qj", &options->jointQuantizationBits)
 		->description("joint indices and weights quantization bits used in Draco compression extension");
 
+	parser->define("dracoMaxError", &dracoMaxError)
+		->description("largest position error allowed in Draco compressed primitives, picks the position quantization bits of each primitive");
+
+	parser->define("dracoMaxRelativeError", &dracoMaxRelativeError)
+		->description("largest error allowed in Draco compressed primitives as a fraction of each attribute's range, picks the quantization bits of each primitive");
+
+	parser->define("dracoEncodeSpeed", &options->dracoEncodeSpeed)
+		->description("Draco encoding speed from 0, the smallest output, to 10, the fastest encoding");
+
+	parser->define("dracoDecodeSpeed", &options->dracoDecodeSpeed)
+		->description("Draco decoding speed from 0, the smallest output, to 10, the fastest decoding");
+
+	parser->define("dracoCacheDir", &options->dracoCacheDir)
+		->description("directory where Draco encoded meshes are stored and reused by later conversions");
+
+	parser->define("optimizeVertexCache", &options->optimizeVertexCache)
+		->defaults(false)
+		->description("reorder triangles for post-transform vertex cache locality");
+
+	parser->define("optimizeVertexFetch", &options->optimizeVertexFetch)
+		->defaults(false)
+		->description("reorder vertices in the order they are first used by the indices");
+
+	parser->define("optimizeOverdraw", &options->optimizeOverdraw)
+		->defaults(false)
+		->description("reorder triangle clusters of opaque primitives to reduce overdraw, implies optimizeVertexCache");
+
+	parser->define("overdrawThreshold", &overdrawThreshold)
+		->description("allowed vertex cache degradation for optimizeOverdraw, defaults to 1.05");
+
+	parser->define("interleave", &options->interleave)
+		->defaults(false)
+		->description("interleave the vertex attributes of each primitive into a single bufferView");
+
+	parser->define("meshQuantization", &options->meshQuantization)
+		->defaults(false)
+		->description("store positions, normals, tangents and texture coordinates as integers using KHR_mesh_quantization");
+
+	parser->define("deferMinMax", &options->deferMinMax)
+		->defaults(false)
+		->description("compute accessor bounds once when writing the output instead of whenever an accessor is created");
+
+	parser->define("threads", &options->threads)
+		->description("number of threads used to convert mesh primitives and compress them with Draco");
+
 	if (parser->parse(argc, argv)) {
 		// Resolve and sanitize paths
 		path inputPath = path(options->inputPath);
@@ -164,6 +226,41 @@ int main(int argc, const char **argv) {
 			std::cout << "ERROR: Cannot enable lockOcclusionMetallicRoughness unless the materials are exported as PBR" << std::endl;
 			return -1;
 		}
+		if (options->meshQuantization && options->version == "1.0") {
+			std::cout << "ERROR: Cannot enable meshQuantization when exporting glTF 1.0" << std::endl;
+			return -1;
+		}
+		if (options->meshQuantization && options->dracoCompression) {
+			std::cout << "ERROR: Cannot export with both meshQuantization and dracoCompression enabled" << std::endl;
+			return -1;
+		}
+
+		if (overdrawThreshold != "") {
+			options->overdrawThreshold = (float)atof(overdrawThreshold.c_str());
+			if (options->overdrawThreshold < 1) {
+				std::cout << "ERROR: overdrawThreshold must be at least 1" << std::endl;
+				return -1;
+			}
+		}
+
+		if (dracoMaxError != "") {
+			options->dracoMaxError = (float)atof(dracoMaxError.c_str());
+			if (options->dracoMaxError <= 0) {
+				std::cout << "ERROR: dracoMaxError must be greater than 0" << std::endl;
+				return -1;
+			}
+		}
+		if (dracoMaxRelativeError != "") {
+			options->dracoMaxRelativeError = (float)atof(dracoMaxRelativeError.c_str());
+			if (options->dracoMaxRelativeError <= 0 || options->dracoMaxRelativeError >= 1) {
+				std::cout << "ERROR: dracoMaxRelativeError must be between 0 and 1" << std::endl;
+				return -1;
+			}
+		}
+		if (options->dracoEncodeSpeed > 10 || options->dracoDecodeSpeed > 10) {
+			std::cout << "ERROR: dracoEncodeSpeed and dracoDecodeSpeed must be between 0 and 10" << std::endl;
+			return -1;
+		}
 
 		// Create the output directory if it does not exist
 		path outputDirectory = outputPath.parent_path();
@@ -188,41 +285,65 @@ int main(int argc, const char **argv) {
 		asset->removeUnusedNodes(options);
 		asset->removeUnusedSemantics();
 
+		if (options->optimizeVertexCache || options->optimizeOverdraw) {
+			asset->optimizeVertexCache();
+		}
+		if (options->optimizeOverdraw) {
+			asset->optimizeOverdraw(options->overdrawThreshold);
+		}
+		if (options->optimizeVertexFetch) {
+			asset->optimizeVertexFetch();
+		}
+
+		if (options->meshQuantization) {
+			asset->quantizeMeshes(options);
+		}
+
 		if (options->dracoCompression) {
-			asset->removeUncompressedBufferViews();
 			asset->compressPrimitives(options);
 		}
 
-		GLTF::Buffer* buffer = asset->packAccessors();
+		GLTF::Buffer* buffer;
+		GLTF::BufferLayout* layout = NULL;
+		if (options->binary && options->embeddedBuffers) {
+			// The binary chunk is streamed into the GLB after the JSON, so only plan where everything goes
+			layout = asset->planBufferLayout(options);
+			buffer = layout->buffer;
+		}
+		else {
+			buffer = asset->packAccessors(options);
+		}
 		if (options->binary && options->version == "1.0") {
 			buffer->stringId = "binary_glTF";
 		}
 
-		// Create image bufferViews for binary glTF
-		if (options->binary && options->embeddedTextures) {
-			size_t imageBufferLength = 0;
-			std::vector<GLTF::Image*> images = asset->getAllImages();
-			for (GLTF::Image* image : images) {
-				imageBufferLength += image->byteLength;
+		// glTF JSON is streamed straight into the output file, binary glTF needs its length for the header first
+		rapidjson::StringBuffer s;
+		if (!options->binary) {
+			FILE* file = fopen(options->outputPath.c_str(), "wb");
+			if (file != NULL) {
+				char writeBuffer[65536];
+				rapidjson::FileWriteStream fileStream(file, writeBuffer, sizeof(writeBuffer));
+				if (options->compactJson) {
+					rapidjson::Writer<rapidjson::FileWriteStream> writer(fileStream);
+					writeAssetJSON(asset, writer, fileStream, options);
+				}
+				else {
+					rapidjson::PrettyWriter<rapidjson::FileWriteStream> writer(fileStream);
+					writeAssetJSON(asset, writer, fileStream, options);
+				}
+				fileStream.Put('\n');
+				fileStream.Flush();
+				fclose(file);
 			}
-			unsigned char* bufferData = buffer->data;
-			bufferData = (unsigned char*)realloc(bufferData, buffer->byteLength + imageBufferLength);
-			size_t byteOffset = buffer->byteLength;
-			for (GLTF::Image* image : images) {
-				GLTF::BufferView* bufferView = new GLTF::BufferView(byteOffset, image->byteLength, buffer);
-				image->bufferView = bufferView;
-				std::memcpy(bufferData + byteOffset, image->data, image->byteLength);
-				byteOffset += image->byteLength;
+			else {
+				std::cout << "ERROR: couldn't write glTF to path '" << options->outputPath << "'" << std::endl;
 			}
-			buffer->data = bufferData;
-			buffer->byteLength += imageBufferLength;
 		}
-
-		rapidjson::StringBuffer s;
-		rapidjson::Writer<rapidjson::StringBuffer> jsonWriter = rapidjson::Writer<rapidjson::StringBuffer>(s);
-		jsonWriter.StartObject();
-		asset->writeJSON(&jsonWriter, options);
-		jsonWriter.EndObject();
+		else {
+			rapidjson::Writer<rapidjson::StringBuffer> writer(s);
+			writeAssetJSON(asset, writer, s, options);
+		}
 
 		if (!options->embeddedTextures) {
 			for (GLTF::Image* image : asset->getAllImages()) {
@@ -264,25 +385,13 @@ int main(int argc, const char **argv) {
 			}
 		}
 
-		std::string jsonString = s.GetString();
-		if (!options->binary) {
-			rapidjson::Document jsonDocument;
-			jsonDocument.Parse(jsonString.c_str());
-
-			rapidjson::StringBuffer buffer;
-			rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
-			jsonDocument.Accept(writer);
-
-			std::ofstream file(options->outputPath);
-			if (file.is_open()) {
-				file << buffer.GetString() << std::endl;
-				file.close();
-			}
-			else {
-				std::cout << "ERROR: couldn't write glTF to path '" << options->outputPath << "'" << std::endl;
-			}
+		// GLB stores its lengths in 32 bits; each chunk adds at most 3 bytes of padding
+		if (options->binary && (uint64_t)HEADER_LENGTH + 2 * (CHUNK_HEADER_LENGTH + 3) + s.GetSize() + buffer->byteLength > UINT32_MAX) {
+			std::cout << "ERROR: Binary glTF can't be larger than 4 GiB, use --separate to write the buffer to its own file" << std::endl;
+			return -1;
 		}
-		else {
+
+		if (options->binary) {
 			FILE* file = fopen(outputPath.generic_string().c_str(), "wb");
 			if (file != NULL) {
 				fwrite("glTF", sizeof(char), 4, file); // magic
@@ -296,16 +405,17 @@ int main(int argc, const char **argv) {
 					writeHeader[0] = 2;
 				}
 
-				int jsonPadding = (4 - (jsonString.length() & 3)) & 3;
+				size_t jsonLength = s.GetSize();
+				int jsonPadding = (4 - (jsonLength & 3)) & 3;
 				int binPadding = (4 - (buffer->byteLength & 3)) & 3;
 
-				writeHeader[1] = HEADER_LENGTH + (CHUNK_HEADER_LENGTH + jsonString.length() + jsonPadding + buffer->byteLength + binPadding); // length
+				writeHeader[1] = HEADER_LENGTH + (CHUNK_HEADER_LENGTH + jsonLength + jsonPadding + buffer->byteLength + binPadding); // length
 				if (options->version != "1.0") {
 					writeHeader[1] += CHUNK_HEADER_LENGTH;
 				}
 				fwrite(writeHeader, sizeof(uint32_t), 2, file); // GLB header
 
-				writeHeader[0] = jsonString.length() + jsonPadding; // 2.0 - chunkLength / 1.0 - contentLength
+				writeHeader[0] = jsonLength + jsonPadding; // 2.0 - chunkLength / 1.0 - contentLength
 				if (options->version == "1.0") {
 					writeHeader[1] = 0; // 1.0 - contentFormat
 				}
@@ -313,7 +423,7 @@ int main(int argc, const char **argv) {
 					writeHeader[1] = 0x4E4F534A; // 2.0 - chunkType JSON
 				}
 				fwrite(writeHeader, sizeof(uint32_t), 2, file);
-				fwrite(jsonString.c_str(), sizeof(char), jsonString.length(), file);
+				fwrite(s.GetString(), sizeof(char), jsonLength, file);
 				for (int i = 0; i < jsonPadding; i++) {
 					fwrite(" ", sizeof(char), 1, file);
 				}
@@ -322,20 +432,46 @@ int main(int argc, const char **argv) {
 					writeHeader[1] = 0x004E4942; // chunkType BIN
 					fwrite(writeHeader, sizeof(uint32_t), 2, file);
 				}
-				fwrite(buffer->data, sizeof(unsigned char), buffer->byteLength, file);
+				bool written = true;
+				if (layout != NULL) {
+					written = layout->write(file);
+				}
+				else {
+					fwrite(buffer->data, sizeof(unsigned char), buffer->byteLength, file);
+				}
 				for (int i = 0; i < binPadding; i++) {
 					fwrite("\0", sizeof(char), 1, file);
 				}
 
 				fclose(file);
+				if (!written) {
+					std::cout << "ERROR couldn't write binary glTF to path '" << outputPath << "'" << std::endl;
+				}
 			}
 			else {
 				std::cout << "ERROR couldn't write binary glTF to path '" << outputPath << "'" << std::endl;
 			}
 		}
 
+		if (layout != NULL) {
+			layout->releaseSources();
+			delete layout;
+		}
+
 		std::clock_t end = std::clock();
 		std::cout << "Time: " << ((end - start) / (double)(CLOCKS_PER_SEC / 1000)) << " ms" << std::endl;
+		const GLTF::Arena::Statistics& arenaStatistics = asset->arena.getStatistics();
+		std::cout << "Objects: " << arenaStatistics.allocations << " allocated (" << arenaStatistics.byteLength << " bytes), " <<
+			arenaStatistics.deletions << " deleted, in " << arenaStatistics.blocks << " blocks (" << arenaStatistics.blockByteLength << " bytes)" << std::endl;
+
+		delete writer;
+		delete asset;
+		// Objects created while no arena was current are not released with the asset
+		GLTF::Arena::Statistics heapStatistics = GLTF::Arena::getHeapStatistics();
+		if (heapStatistics.allocations > 0) {
+			std::cout << "Heap objects: " << heapStatistics.allocations << " allocated (" << heapStatistics.byteLength << " bytes), " <<
+				heapStatistics.deletions << " deleted" << std::endl;
+		}
 		return 0;
 	}
 	else {
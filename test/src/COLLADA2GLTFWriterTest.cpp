@@ -17,6 +17,60 @@ COLLADA2GLTFWriterTest::~COLLADA2GLTFWriterTest() {
 	delete asset;
 }
 
+// Converts a grid split into eight triangle lists, half of them sharing one index list
+GLTF::Mesh* convertGridMesh(GLTF::Asset* asset, int threads) {
+	COLLADA2GLTF::Options* options = new COLLADA2GLTF::Options();
+	options->threads = threads;
+	COLLADASaxFWL::Loader* loader = new COLLADASaxFWL::Loader();
+	COLLADA2GLTF::ExtrasHandler* extrasHandler = new COLLADA2GLTF::ExtrasHandler(loader);
+	COLLADA2GLTF::Writer* writer = new COLLADA2GLTF::Writer(asset, options, extrasHandler);
+
+	COLLADAFW::Mesh* colladaMesh = new COLLADAFW::Mesh(COLLADAFW::UniqueId(COLLADAFW::COLLADA_TYPE::MESH, 0, 0));
+	COLLADAFW::MeshVertexData& positions = colladaMesh->getPositions();
+	positions.setType(COLLADAFW::FloatOrDoubleArray::DATA_TYPE_FLOAT);
+	COLLADAFW::MeshVertexData& normals = colladaMesh->getNormals();
+	normals.setType(COLLADAFW::FloatOrDoubleArray::DATA_TYPE_FLOAT);
+	for (size_t y = 0; y < 17; y++) {
+		for (size_t x = 0; x < 17; x++) {
+			positions.getFloatValues()->append((float)x);
+			positions.getFloatValues()->append((float)y);
+			positions.getFloatValues()->append((float)(x * y));
+			normals.getFloatValues()->append(0);
+			normals.getFloatValues()->append(0);
+			normals.getFloatValues()->append(1);
+		}
+	}
+	for (size_t i = 0; i < 8; i++) {
+		COLLADAFW::Triangles* triangles = new COLLADAFW::Triangles(COLLADAFW::UniqueId(COLLADAFW::COLLADA_TYPE::MESH, 1 + i, 0));
+		unsigned int corner = 0;
+		for (size_t y = i * 2; y < i * 2 + 2; y++) {
+			for (size_t x = 0; x < 16; x++) {
+				unsigned int cell = (unsigned int)(y * 17 + x);
+				unsigned int cellIndices[6] = {cell, cell + 1, cell + 17, cell + 17, cell + 1, cell + 18};
+				for (size_t j = 0; j < 6; j++) {
+					triangles->getPositionIndices().append(cellIndices[j]);
+					triangles->getNormalIndices().append(i % 2 == 0 ? cellIndices[j] : corner);
+					corner++;
+				}
+			}
+		}
+		colladaMesh->getMeshPrimitives().append(triangles);
+	}
+	writer->writeGeometry(colladaMesh);
+
+	COLLADAFW::LibraryNodes* nodes = new COLLADAFW::LibraryNodes();
+	COLLADAFW::Node* node = new COLLADAFW::Node(COLLADAFW::UniqueId(COLLADAFW::COLLADA_TYPE::NODE, 0, 0));
+	COLLADAFW::InstanceGeometry* instanceGeometry = new COLLADAFW::InstanceGeometry(
+		COLLADAFW::UniqueId(COLLADAFW::COLLADA_TYPE::MESH, 9, 0),
+		COLLADAFW::UniqueId(COLLADAFW::COLLADA_TYPE::MESH, 0, 0)
+	);
+	node->getInstanceGeometries().append(instanceGeometry);
+	nodes->getNodes().append(node);
+	writer->writeLibraryNodes(nodes);
+	delete writer;
+	return asset->getDefaultScene()->nodes[0]->mesh;
+}
+
 TEST_F(COLLADA2GLTFWriterTest, WriteLibraryNodes_SingleNode) {
 	COLLADAFW::LibraryNodes* nodes = new COLLADAFW::LibraryNodes();
 	COLLADAFW::Node* node = new COLLADAFW::Node(COLLADAFW::UniqueId(COLLADAFW::COLLADA_TYPE::NODE, 0, 0));
@@ -80,3 +134,190 @@ TEST_F(COLLADA2GLTFWriterTest, WriteLibraryNodes_MeshDoesExist) {
 	GLTF::Mesh* mesh = sceneNode->mesh;
 	ASSERT_TRUE(mesh != NULL);
 }
+
+TEST_F(COLLADA2GLTFWriterTest, WriteMesh_MergesDuplicateVertices) {
+	COLLADAFW::Mesh* colladaMesh = new COLLADAFW::Mesh(COLLADAFW::UniqueId(COLLADAFW::COLLADA_TYPE::MESH, 0, 0));
+	COLLADAFW::MeshVertexData& positions = colladaMesh->getPositions();
+	positions.setType(COLLADAFW::FloatOrDoubleArray::DATA_TYPE_FLOAT);
+	// The fifth position has the same value as the second one
+	float positionValues[15] = {0, 0, 0, 1, 0, 0, 0, 1, 0, 1, 1, 0, 1, 0, 0};
+	for (size_t i = 0; i < 15; i++) {
+		positions.getFloatValues()->append(positionValues[i]);
+	}
+	// Every corner has its own normal, all with the same value, so the index lists are not aligned
+	COLLADAFW::MeshVertexData& normals = colladaMesh->getNormals();
+	normals.setType(COLLADAFW::FloatOrDoubleArray::DATA_TYPE_FLOAT);
+	for (size_t i = 0; i < 6; i++) {
+		normals.getFloatValues()->append(0);
+		normals.getFloatValues()->append(0);
+		normals.getFloatValues()->append(1);
+	}
+	COLLADAFW::Triangles* triangles = new COLLADAFW::Triangles(COLLADAFW::UniqueId(COLLADAFW::COLLADA_TYPE::MESH, 1, 0));
+	unsigned int positionIndices[6] = {0, 1, 2, 2, 4, 3};
+	for (size_t i = 0; i < 6; i++) {
+		triangles->getPositionIndices().append(positionIndices[i]);
+		triangles->getNormalIndices().append(i);
+	}
+	colladaMesh->getMeshPrimitives().append(triangles);
+	this->writer->writeGeometry(colladaMesh);
+
+	COLLADAFW::LibraryNodes* nodes = new COLLADAFW::LibraryNodes();
+	COLLADAFW::Node* node = new COLLADAFW::Node(COLLADAFW::UniqueId(COLLADAFW::COLLADA_TYPE::NODE, 0, 0));
+	COLLADAFW::InstanceGeometry* instanceGeometry = new COLLADAFW::InstanceGeometry(
+		COLLADAFW::UniqueId(COLLADAFW::COLLADA_TYPE::MESH, 2, 0),
+		COLLADAFW::UniqueId(COLLADAFW::COLLADA_TYPE::MESH, 0, 0)
+	);
+	node->getInstanceGeometries().append(instanceGeometry);
+	nodes->getNodes().append(node);
+	this->writer->writeLibraryNodes(nodes);
+
+	GLTF::Mesh* mesh = this->asset->getDefaultScene()->nodes[0]->mesh;
+	ASSERT_TRUE(mesh != NULL);
+	ASSERT_EQ(mesh->primitives.size(), 1);
+	GLTF::Primitive* primitive = mesh->primitives[0];
+	EXPECT_EQ(primitive->attributes["POSITION"]->count, 4);
+	GLTF::Accessor* indices = primitive->indices;
+	ASSERT_EQ(indices->count, 6);
+	unsigned int expectedIndices[6] = {0, 1, 2, 2, 1, 3};
+	float component;
+	for (int i = 0; i < indices->count; i++) {
+		indices->getComponentAtIndex(i, &component);
+		EXPECT_EQ(component, expectedIndices[i]);
+	}
+}
+
+TEST_F(COLLADA2GLTFWriterTest, WriteMesh_CopiesIndexAlignedPrimitive) {
+	COLLADAFW::Mesh* colladaMesh = new COLLADAFW::Mesh(COLLADAFW::UniqueId(COLLADAFW::COLLADA_TYPE::MESH, 0, 0));
+	COLLADAFW::MeshVertexData& positions = colladaMesh->getPositions();
+	positions.setType(COLLADAFW::FloatOrDoubleArray::DATA_TYPE_FLOAT);
+	// The first position is not referenced by the primitive
+	float positionValues[15] = {9, 9, 9, 0, 0, 0, 1, 0, 0, 0, 1, 0, 1, 1, 0};
+	for (size_t i = 0; i < 15; i++) {
+		positions.getFloatValues()->append(positionValues[i]);
+	}
+	COLLADAFW::MeshVertexData& uvCoords = colladaMesh->getUVCoords();
+	uvCoords.setType(COLLADAFW::FloatOrDoubleArray::DATA_TYPE_FLOAT);
+	float uvValues[10] = {0, 0, 0, 0, 1, 0, 0, 1, 1, 1};
+	for (size_t i = 0; i < 10; i++) {
+		uvCoords.getFloatValues()->append(uvValues[i]);
+	}
+	COLLADAFW::Triangles* triangles = new COLLADAFW::Triangles(COLLADAFW::UniqueId(COLLADAFW::COLLADA_TYPE::MESH, 1, 0));
+	COLLADAFW::IndexList* uvIndices = new COLLADAFW::IndexList();
+	unsigned int indexValues[6] = {1, 2, 3, 3, 2, 4};
+	for (size_t i = 0; i < 6; i++) {
+		triangles->getPositionIndices().append(indexValues[i]);
+		uvIndices->getIndices().append(indexValues[i]);
+	}
+	triangles->getUVCoordIndicesArray().append(uvIndices);
+	colladaMesh->getMeshPrimitives().append(triangles);
+	this->writer->writeGeometry(colladaMesh);
+
+	COLLADAFW::LibraryNodes* nodes = new COLLADAFW::LibraryNodes();
+	COLLADAFW::Node* node = new COLLADAFW::Node(COLLADAFW::UniqueId(COLLADAFW::COLLADA_TYPE::NODE, 0, 0));
+	COLLADAFW::InstanceGeometry* instanceGeometry = new COLLADAFW::InstanceGeometry(
+		COLLADAFW::UniqueId(COLLADAFW::COLLADA_TYPE::MESH, 2, 0),
+		COLLADAFW::UniqueId(COLLADAFW::COLLADA_TYPE::MESH, 0, 0)
+	);
+	node->getInstanceGeometries().append(instanceGeometry);
+	nodes->getNodes().append(node);
+	this->writer->writeLibraryNodes(nodes);
+
+	GLTF::Mesh* mesh = this->asset->getDefaultScene()->nodes[0]->mesh;
+	ASSERT_TRUE(mesh != NULL);
+	GLTF::Primitive* primitive = mesh->primitives[0];
+	GLTF::Accessor* position = primitive->attributes["POSITION"];
+	ASSERT_EQ(position->count, 4);
+	float component[3];
+	position->getComponentAtIndex(0, component);
+	EXPECT_EQ(component[0], 0);
+	EXPECT_EQ(component[1], 0);
+	position->getComponentAtIndex(3, component);
+	EXPECT_EQ(component[0], 1);
+	EXPECT_EQ(component[1], 1);
+	GLTF::Accessor* uv = primitive->attributes["TEXCOORD_0"];
+	ASSERT_EQ(uv->count, 4);
+	// The Y coordinate is flipped
+	uv->getComponentAtIndex(2, component);
+	EXPECT_EQ(component[0], 0);
+	EXPECT_EQ(component[1], 0);
+	GLTF::Accessor* indices = primitive->indices;
+	ASSERT_EQ(indices->count, 6);
+	unsigned int expectedIndices[6] = {0, 1, 2, 2, 1, 3};
+	for (int i = 0; i < indices->count; i++) {
+		indices->getComponentAtIndex(i, component);
+		EXPECT_EQ(component[0], expectedIndices[i]);
+	}
+}
+
+TEST_F(COLLADA2GLTFWriterTest, WriteMesh_ThreadedMatchesSingleThreaded) {
+	GLTF::Asset* serialAsset = new GLTF::Asset();
+	GLTF::Mesh* serialMesh = convertGridMesh(serialAsset, 1);
+	GLTF::Asset* threadedAsset = new GLTF::Asset();
+	GLTF::Mesh* threadedMesh = convertGridMesh(threadedAsset, 4);
+	ASSERT_TRUE(serialMesh != NULL);
+	ASSERT_TRUE(threadedMesh != NULL);
+	ASSERT_EQ(serialMesh->primitives.size(), 8);
+	ASSERT_EQ(threadedMesh->primitives.size(), serialMesh->primitives.size());
+	for (size_t i = 0; i < serialMesh->primitives.size(); i++) {
+		GLTF::Primitive* serialPrimitive = serialMesh->primitives[i];
+		GLTF::Primitive* threadedPrimitive = threadedMesh->primitives[i];
+		ASSERT_EQ(threadedPrimitive->attributes.size(), serialPrimitive->attributes.size());
+		std::vector<GLTF::Accessor*> serialAccessors = {serialPrimitive->indices};
+		std::vector<GLTF::Accessor*> threadedAccessors = {threadedPrimitive->indices};
+		for (const auto& attribute : serialPrimitive->attributes) {
+			serialAccessors.push_back(attribute.second);
+			threadedAccessors.push_back(threadedPrimitive->attributes[attribute.first]);
+		}
+		for (size_t j = 0; j < serialAccessors.size(); j++) {
+			GLTF::Accessor* serialAccessor = serialAccessors[j];
+			GLTF::Accessor* threadedAccessor = threadedAccessors[j];
+			ASSERT_TRUE(serialAccessor != NULL);
+			ASSERT_TRUE(threadedAccessor != NULL);
+			EXPECT_EQ(threadedAccessor->count, serialAccessor->count);
+			EXPECT_EQ(threadedAccessor->componentType, serialAccessor->componentType);
+			EXPECT_EQ(threadedAccessor->type, serialAccessor->type);
+			ASSERT_TRUE(serialAccessor->min != NULL && serialAccessor->max != NULL);
+			ASSERT_TRUE(threadedAccessor->min != NULL && threadedAccessor->max != NULL);
+			for (int k = 0; k < serialAccessor->getNumberOfComponents(); k++) {
+				EXPECT_EQ(threadedAccessor->min[k], serialAccessor->min[k]);
+				EXPECT_EQ(threadedAccessor->max[k], serialAccessor->max[k]);
+			}
+			// Element by element, so an ordering bug in the threaded merge can't pass on matching bounds
+			EXPECT_TRUE(threadedAccessor->equals(serialAccessor));
+		}
+	}
+	delete threadedAsset;
+	delete serialAsset;
+}
+
+TEST_F(COLLADA2GLTFWriterTest, WriteMesh_AllocatesFromWriterAsset) {
+	size_t heapAllocations = GLTF::Arena::getHeapStatistics().allocations;
+	// Created after the asset the writer converts into, it must not receive any of its objects
+	GLTF::Asset* newerAsset = new GLTF::Asset();
+	GLTF::Mesh* mesh = convertGridMesh(this->asset, 4);
+	EXPECT_EQ(newerAsset->arena.getStatistics().allocations, 2);
+	delete newerAsset;
+
+	ASSERT_TRUE(mesh != NULL);
+	ASSERT_EQ(mesh->primitives.size(), 8);
+	for (GLTF::Primitive* primitive : mesh->primitives) {
+		ASSERT_TRUE(primitive->indices != NULL);
+		EXPECT_EQ(primitive->indices->count, 192);
+		ASSERT_TRUE(primitive->indices->bufferView != NULL);
+		EXPECT_TRUE(primitive->indices->bufferView->buffer != NULL);
+	}
+	EXPECT_EQ(GLTF::Arena::getHeapStatistics().allocations, heapAllocations);
+}
+
+TEST_F(COLLADA2GLTFWriterTest, Delete_ReleasesThreadedConversion) {
+	GLTF::Arena* previous = GLTF::Arena::current();
+	size_t heapAllocations = GLTF::Arena::getHeapStatistics().allocations;
+	GLTF::Asset* threadedAsset = new GLTF::Asset();
+	GLTF::Mesh* mesh = convertGridMesh(threadedAsset, 4);
+	ASSERT_TRUE(mesh != NULL);
+	EXPECT_EQ(mesh->primitives.size(), 8);
+	delete threadedAsset;
+	// The accessors created on the workers belong to the asset, none fell back to the heap
+	EXPECT_EQ(GLTF::Arena::getHeapStatistics().allocations, heapAllocations);
+	EXPECT_EQ(GLTF::Arena::current(), previous);
+}